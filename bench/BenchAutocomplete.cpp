@@ -0,0 +1,78 @@
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include "Autocomplete.h"
+#include "BenchHarness.h"
+
+void RunAutocompleteBench()
+{
+    constexpr size_t QUERIES = 1000000;
+    std::cout << "\n[autocomplete, " << QUERIES << " distinct queries]" << std::endl;
+
+    // Журнал запросов: случайные строки из 1-3 слов с весами по закону Ципфа
+    const std::string letters = "eeeeeeeeeeeetttttttttaaaaaaaaooooooooiiiiiiinnnnnnnsssssshhhhhhrrrrrrddddlllluuucccmmmwwffggyyppbbvkjxqz";
+    std::mt19937 rng(21);
+    std::vector<std::pair<std::string, uint64_t>> queries;
+    queries.reserve(QUERIES);
+    for (size_t i = 0; i < QUERIES; ++i)
+    {
+        std::string query;
+        const size_t words = 1 + rng() % 3;
+        for (size_t w = 0; w < words; ++w)
+        {
+            if (w > 0)
+            {
+                query += ' ';
+            }
+            const size_t length = 3 + rng() % 7;
+            for (size_t j = 0; j < length; ++j)
+            {
+                query += letters[rng() % letters.size()];
+            }
+        }
+        queries.emplace_back(std::move(query), 1000000 / (i + 1) + 1);
+    }
+
+    Autocompleter completer;
+    PrintBenchResult(RunBenchmark("build from query log", [&] { completer.Build(queries); }, 0.1));
+    std::cout << "  " << completer.Size() << " completions, " << completer.MemoryBytes() / 1024 << " KB" << std::endl;
+
+    // Префиксы длиной 1-4 символа из случайных запросов: короткие префиксы покрывают огромные диапазоны
+    std::vector<std::string> prefixes;
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        const std::string& query = queries[rng() % queries.size()].first;
+        prefixes.push_back(query.substr(0, 1 + i % 4));
+    }
+    for (const size_t k : { 1, 10 })
+    {
+        const BenchResult result = RunBenchmark("top-" + std::to_string(k) + " completions, 1000 prefixes", [&]
+        {
+            size_t found = 0;
+            for (const auto& prefix : prefixes)
+            {
+                found += completer.Complete(prefix, k).size();
+            }
+            DoNotOptimize(found);
+        });
+        PrintBenchResult(result);
+        std::cout << "  " << std::fixed << std::setprecision(2) << result.ns_per_op / prefixes.size() / 1000
+                  << " us per prefix" << std::endl;
+    }
+
+    // Для сравнения: перебор всех вариантов диапазона префикса из одной буквы
+    const BenchResult scan = RunBenchmark("scan prefix range, top-10, 1 prefix", [&]
+    {
+        std::vector<std::pair<uint64_t, size_t>> range;
+        for (size_t i = 0; i < queries.size(); ++i)
+        {
+            if (queries[i].first.front() == 'e')
+            {
+                range.emplace_back(queries[i].second, i);
+            }
+        }
+        std::partial_sort(range.begin(), range.begin() + 10, range.end(), std::greater<>());
+        DoNotOptimize(range.front());
+    }, 0.1);
+    PrintBenchResult(scan);
+}
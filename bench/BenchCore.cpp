@@ -0,0 +1,171 @@
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <nlohmann/json.hpp>
+#include "BenchHarness.h"
+#include "ConverterJSON.h"
+#include "InvertedIndex.h"
+#include "SearchServer.h"
+#include "TextNormalizer.h"
+
+namespace
+{
+    constexpr size_t CORE_DOCS = 20000;
+    constexpr size_t CORE_WORDS_PER_DOC = 200;
+    constexpr size_t CORE_VOCABULARY = 50000;
+
+    size_t TotalBytes(const std::vector<std::string>& docs)
+    {
+        size_t bytes = 0;
+        for (const auto& doc : docs)
+        {
+            bytes += doc.size();
+        }
+        return bytes;
+    }
+
+    // Запросы из count слов с номерами из [first, last) синтетического словаря "w<номер>"
+    std::vector<std::string> MakeQueries(size_t queries, size_t count, size_t first, size_t last, uint32_t seed)
+    {
+        std::mt19937 rng(seed);
+        std::vector<std::string> result;
+        for (size_t q = 0; q < queries; ++q)
+        {
+            std::string query;
+            for (size_t i = 0; i < count; ++i)
+            {
+                query += "w" + std::to_string(first + rng() % (last - first)) + " ";
+            }
+            result.push_back(std::move(query));
+        }
+        return result;
+    }
+
+    // Временный каталог с JSON/config.json, JSON/requests.json и файлами документов. На время
+    // существования объекта становится текущим: ConverterJSON ищет файлы относительно него
+    class TemporaryWorkspace
+    {
+    public:
+        TemporaryWorkspace(const std::vector<std::string>& docs, const std::vector<std::string>& requests)
+            : _previous(std::filesystem::current_path()),
+              _root(std::filesystem::temp_directory_path() / ("search_engine_bench_" +
+                    std::to_string(std::chrono::steady_clock::now().time_since_epoch().count())))
+        {
+            std::filesystem::create_directories(_root / "JSON");
+            std::filesystem::create_directories(_root / "docs");
+            nlohmann::json config = { { "config", { { "name", "bench" }, { "max_responses", 5 } } } };
+            for (size_t i = 0; i < docs.size(); ++i)
+            {
+                const std::string path = "docs/" + std::to_string(i) + ".txt";
+                std::ofstream(_root / path) << docs[i];
+                config["files"].push_back(path);
+            }
+            std::ofstream(_root / "JSON" / "config.json") << config.dump(4);
+            std::ofstream(_root / "JSON" / "requests.json") << nlohmann::json{ { "requests", requests } }.dump(4);
+            std::filesystem::current_path(_root);
+        }
+
+        ~TemporaryWorkspace()
+        {
+            std::filesystem::current_path(_previous);
+            std::error_code error;
+            std::filesystem::remove_all(_root, error);
+        }
+
+    private:
+        std::filesystem::path _previous;
+
+        std::filesystem::path _root;
+    };
+}
+
+// Основные операции движка на синтетическом корпусе: разбиение на слова, индексация,
+// поиск слов, запросы из редких и из частых слов, чтение и запись JSON
+void RunCoreBench()
+{
+    std::cout << "\n[core operations, " << CORE_DOCS << " docs x " << CORE_WORDS_PER_DOC << " words, vocabulary "
+              << CORE_VOCABULARY << "]" << std::endl;
+    const auto docs = MakeSyntheticCorpus(CORE_DOCS, CORE_WORDS_PER_DOC, CORE_VOCABULARY, 31);
+    const size_t corpus_bytes = TotalBytes(docs);
+
+    BenchResult tokenize = RunBenchmark("tokenize + normalize corpus", [&]
+    {
+        size_t words = 0;
+        std::string word;
+        for (const auto& doc : docs)
+        {
+            std::istringstream stream(doc);
+            while (stream >> word)
+            {
+                words += !NormalizeWord(word).empty();
+            }
+        }
+        DoNotOptimize(words);
+    });
+    tokenize.bytes_per_op = static_cast<double>(corpus_bytes);
+    PrintBenchResult(tokenize);
+
+    InvertedIndex idx;
+    BenchResult indexing = RunBenchmark("UpdateDocumentBase", [&] { idx.UpdateDocumentBase(docs); });
+    indexing.bytes_per_op = static_cast<double>(corpus_bytes);
+    PrintBenchResult(indexing);
+    std::cout << "  " << std::fixed << std::setprecision(0) << CORE_DOCS * 1e9 / indexing.ns_per_op << " docs/s" << std::endl;
+
+    // Слова из головы, середины и хвоста распределения по очереди
+    std::vector<std::string> words;
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        words.push_back("w" + std::to_string(i % 3 == 0 ? i % 50 : i % 3 == 1 ? 1000 + i : 20000 + i * 20));
+    }
+    PrintLatencyResult(RunLatencyBenchmark("GetWordCount", words.size(), [&](size_t i)
+    {
+        DoNotOptimize(idx.GetWordCount(words[i]).size());
+    }));
+
+    // Запросы выполняются без кэша результатов, чтобы каждый раз обходить списки вхождений
+    SearchServer server(idx);
+    SearchOptions options;
+    options.cache_capacity = 0;
+    options.posting_cache_bytes = 0;
+    server.SetOptions(options);
+    const auto narrow = MakeQueries(1000, 2, 10000, CORE_VOCABULARY, 32);
+    const auto broad = MakeQueries(1000, 3, 0, 20, 33);
+    PrintLatencyResult(RunLatencyBenchmark("search, narrow (2 tail words)", narrow.size(), [&](size_t i)
+    {
+        DoNotOptimize(server.search(server.Compile(narrow[i]), 5).size());
+    }));
+    PrintLatencyResult(RunLatencyBenchmark("search, broad (3 head words)", broad.size(), [&](size_t i)
+    {
+        DoNotOptimize(server.search(server.Compile(broad[i]), 5).size());
+    }));
+    options.mode = QueryMode::All;
+    server.SetOptions(options);
+    PrintLatencyResult(RunLatencyBenchmark("search, broad, all words", broad.size(), [&](size_t i)
+    {
+        DoNotOptimize(server.search(server.Compile(broad[i]), 5).size());
+    }));
+
+    // Чтение config.json с документами и requests.json, запись answers.json
+    const std::vector<std::string> json_docs(docs.begin(), docs.begin() + 1000);
+    std::vector<std::string> requests(narrow.begin(), narrow.end());
+    requests.resize(1000);
+    std::vector<std::vector<std::pair<int, float>>> answers(requests.size());
+    for (size_t i = 0; i < answers.size(); ++i)
+    {
+        for (int doc = 0; doc < 5; ++doc)
+        {
+            answers[i].emplace_back(doc, 1.0f / static_cast<float>(doc + 1));
+        }
+    }
+    TemporaryWorkspace workspace(json_docs, requests);
+    ConverterJSON converter;
+    BenchResult read_docs = RunBenchmark("GetTextDocuments, 1000 files", [&]
+    {
+        DoNotOptimize(converter.GetTextDocuments().size());
+    });
+    read_docs.bytes_per_op = static_cast<double>(TotalBytes(json_docs));
+    PrintBenchResult(read_docs);
+    PrintBenchResult(RunBenchmark("GetRequests, 1000 requests", [&] { DoNotOptimize(converter.GetRequests().size()); }));
+    PrintBenchResult(RunBenchmark("putAnswers, 1000 answers x 5", [&] { converter.putAnswers(answers); }));
+}
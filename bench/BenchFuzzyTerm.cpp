@@ -0,0 +1,158 @@
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include "BenchHarness.h"
+#include "FuzzyTerm.h"
+#include "SpellingIndex.h"
+#include "TermDictionary.h"
+
+namespace
+{
+    // Словарь из случайных слов длиной 4-12 букв с частотами букв, близкими к английскому тексту
+    std::vector<std::string> MakeVocabulary(size_t size, uint32_t seed)
+    {
+        const std::string letters = "eeeeeeeeeeeetttttttttaaaaaaaaooooooooiiiiiiinnnnnnnsssssshhhhhhrrrrrrddddlllluuucccmmmwwffggyyppbbvkjxqz";
+        std::mt19937 rng(seed);
+        std::vector<std::string> terms;
+        terms.reserve(size + size / 8);
+        while (terms.size() < size + size / 8)
+        {
+            std::string term;
+            const size_t length = 4 + rng() % 9;
+            for (size_t i = 0; i < length; ++i)
+            {
+                term += letters[rng() % letters.size()];
+            }
+            terms.push_back(std::move(term));
+        }
+        std::sort(terms.begin(), terms.end());
+        terms.erase(std::unique(terms.begin(), terms.end()), terms.end());
+        terms.resize(std::min(terms.size(), size));
+        return terms;
+    }
+
+    // Слова словаря с одной случайной опечаткой
+    std::vector<std::string> MakeTypos(const std::vector<std::string>& terms, size_t count, uint32_t seed)
+    {
+        std::mt19937 rng(seed);
+        std::vector<std::string> typos;
+        for (size_t i = 0; i < count; ++i)
+        {
+            std::string word = terms[rng() % terms.size()];
+            const size_t position = rng() % word.size();
+            switch (rng() % 3)
+            {
+            case 0:
+                word[position] = static_cast<char>('a' + rng() % 26);
+                break;
+            case 1:
+                word.erase(position, 1);
+                break;
+            default:
+                word.insert(position, 1, static_cast<char>('a' + rng() % 26));
+            }
+            typos.push_back(std::move(word));
+        }
+        return typos;
+    }
+}
+
+void RunFuzzyTermBench()
+{
+    constexpr size_t VOCABULARY = 3000000;
+    std::cout << "\n[fuzzy term expansion, " << VOCABULARY << " terms]" << std::endl;
+
+    const auto terms = MakeVocabulary(VOCABULARY, 11);
+    TermDictionary dictionary;
+    PrintBenchResult(RunBenchmark("build term dictionary", [&] { dictionary.Build(terms); }, 0.1));
+    std::cout << "  " << dictionary.Size() << " terms, " << dictionary.MemoryBytes() / 1024 << " KB" << std::endl;
+
+    const auto typos = MakeTypos(terms, 100, 12);
+    for (size_t distance = 1; distance <= MAX_FUZZY_DISTANCE; ++distance)
+    {
+        size_t expansions = 0;
+        const BenchResult result = RunBenchmark("levenshtein automaton, k=" + std::to_string(distance) + ", 100 words", [&]
+        {
+            expansions = 0;
+            for (const auto& typo : typos)
+            {
+                LevenshteinAutomaton automaton(typo, distance);
+                dictionary.Intersect(automaton, [&](const std::string&, uint32_t)
+                {
+                    ++expansions;
+                    return true;
+                });
+            }
+        });
+        PrintBenchResult(result);
+        std::cout << "  " << std::fixed << std::setprecision(1) << result.ns_per_op / typos.size() / 1000
+                  << " us per word, " << static_cast<double>(expansions) / typos.size() << " terms per word" << std::endl;
+    }
+
+    // Для сравнения: расстояние до каждого слова словаря
+    const BenchResult brute = RunBenchmark("brute force EditDistance, k=1, 1 word", [&]
+    {
+        size_t expansions = 0;
+        for (const auto& term : terms)
+        {
+            expansions += EditDistance(typos.front(), term) <= 1;
+        }
+        DoNotOptimize(expansions);
+    }, 0.1);
+    PrintBenchResult(brute);
+
+    // Подсказки исправлений: индекс удалений против обхода словаря автоматом, k=2
+    constexpr size_t SPELLING_VOCABULARY = 500000;
+    const std::vector<std::string> spelling_terms(terms.begin(), terms.begin() + SPELLING_VOCABULARY);
+    TermDictionary spelling_dictionary;
+    spelling_dictionary.Build(spelling_terms);
+    SpellingIndex spelling;
+    PrintBenchResult(RunBenchmark("build spelling index, 500000 terms", [&]
+    {
+        spelling.Build(spelling_terms, SPELLING_MAX_DISTANCE);
+    }, 0.1));
+    std::cout << "  " << spelling.MemoryBytes() / 1024 << " KB" << std::endl;
+    const auto spelling_typos = MakeTypos(spelling_terms, 100, 13);
+    const BenchResult deletes = RunBenchmark("symmetric delete lookup, nearest first, 100 words", [&]
+    {
+        // Как в SuggestTerms: две правки просматриваются, только если на одну ничего не нашлось
+        size_t found = 0;
+        for (const auto& typo : spelling_typos)
+        {
+            for (size_t edits = 1; edits <= 2; ++edits)
+            {
+                size_t matches = 0;
+                for (const uint32_t id : spelling.Candidates(typo, edits))
+                {
+                    matches += EditDistance(typo, spelling_dictionary.Term(id)) == edits;
+                }
+                found += matches;
+                if (matches > 0)
+                {
+                    break;
+                }
+            }
+        }
+        DoNotOptimize(found);
+    });
+    PrintBenchResult(deletes);
+    std::cout << "  " << std::fixed << std::setprecision(1) << deletes.ns_per_op / spelling_typos.size() / 1000
+              << " us per word" << std::endl;
+    const BenchResult automaton = RunBenchmark("levenshtein automaton lookup, k=2, 100 words", [&]
+    {
+        size_t found = 0;
+        for (const auto& typo : spelling_typos)
+        {
+            LevenshteinAutomaton levenshtein(typo, 2);
+            spelling_dictionary.Intersect(levenshtein, [&](const std::string&, uint32_t)
+            {
+                ++found;
+                return true;
+            });
+        }
+        DoNotOptimize(found);
+    });
+    PrintBenchResult(automaton);
+    std::cout << "  " << std::fixed << std::setprecision(1) << automaton.ns_per_op / spelling_typos.size() / 1000
+              << " us per word" << std::endl;
+}
@@ -0,0 +1,172 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// Минимальная обвязка для бенчмарков: не требует загрузки сторонних библиотек
+
+// Не дает компилятору выбросить вычисление, результат которого не используется
+template <typename T>
+inline void DoNotOptimize(const T& value)
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// Результат одного замера
+struct BenchResult
+{
+    std::string name;     // Название замера
+    size_t iterations;    // Количество выполненных итераций
+    double ns_per_op;     // Среднее время одной итерации в наносекундах
+    double bytes_per_op = 0; // Объем данных, обрабатываемый за итерацию (для пропускной способности)
+};
+
+// Распределение задержек отдельных операций
+struct LatencyResult
+{
+    std::string name;   // Название замера
+    size_t operations;  // Количество измеренных операций
+    double ops_per_sec; // Пропускная способность
+    double p50_ns;      // Перцентили задержки в наносекундах
+    double p90_ns;
+    double p99_ns;
+    double p999_ns;
+    double max_ns;
+};
+
+// Результаты всех замеров запуска для машиночитаемого отчета
+struct BenchReport
+{
+    std::string suite; // Набор, который выполняется сейчас
+
+    std::vector<std::pair<std::string, BenchResult>> results; // {набор, замер}
+
+    std::vector<std::pair<std::string, LatencyResult>> latencies; // {набор, замер}
+};
+
+inline BenchReport& CurrentBenchReport()
+{
+    static BenchReport report;
+    return report;
+}
+
+// Выполняет fn до тех пор, пока не пройдет min_seconds секунд (но не менее одной итерации)
+template <typename Fn>
+BenchResult RunBenchmark(const std::string& name, Fn&& fn, double min_seconds = 0.5)
+{
+    using clock = std::chrono::steady_clock;
+    fn(); // Прогрев кэшей
+
+    size_t iterations = 0;
+    const auto start = clock::now();
+    auto now = start;
+    do
+    {
+        fn();
+        ++iterations;
+        now = clock::now();
+    } while (std::chrono::duration<double>(now - start).count() < min_seconds);
+
+    const double elapsed_ns = std::chrono::duration<double, std::nano>(now - start).count();
+    return BenchResult{ name, iterations, elapsed_ns / static_cast<double>(iterations) };
+}
+
+// Печатает результат замера одной строкой
+inline void PrintBenchResult(const BenchResult& result)
+{
+    CurrentBenchReport().results.emplace_back(CurrentBenchReport().suite, result);
+    std::cout << std::left << std::setw(48) << result.name
+              << std::right << std::setw(14) << std::fixed << std::setprecision(1) << result.ns_per_op << " ns/op"
+              << std::setw(12) << result.iterations << " iters";
+    if (result.bytes_per_op > 0)
+    {
+        std::cout << std::setw(10) << std::setprecision(1) << result.bytes_per_op * 1e3 / result.ns_per_op << " MB/s";
+    }
+    std::cout << std::endl;
+}
+
+// Замеряет каждую операцию fn(i) отдельно, пока не пройдет min_seconds секунд (но не менее
+// operations операций), i пробегает 0..operations-1 по кругу. Время одной операции должно быть
+// заметно больше накладных расходов steady_clock (десятки наносекунд)
+template <typename Fn>
+LatencyResult RunLatencyBenchmark(const std::string& name, size_t operations, Fn&& fn, double min_seconds = 0.5)
+{
+    using clock = std::chrono::steady_clock;
+    for (size_t i = 0; i < operations; ++i)
+    {
+        fn(i); // Прогрев кэшей
+    }
+    constexpr size_t MAX_SAMPLES = 4000000; // Не больше 32 МБ на замер
+    std::vector<double> samples;
+    double total_ns = 0;
+    const auto start = clock::now();
+    for (size_t i = 0; samples.size() < operations || (total_ns < min_seconds * 1e9 && samples.size() < MAX_SAMPLES);
+         i = (i + 1) % operations)
+    {
+        const auto before = clock::now();
+        fn(i);
+        const auto after = clock::now();
+        samples.push_back(std::chrono::duration<double, std::nano>(after - before).count());
+        total_ns = std::chrono::duration<double, std::nano>(after - start).count();
+    }
+    std::sort(samples.begin(), samples.end());
+    const auto percentile = [&samples](double p)
+    {
+        return samples[std::min(samples.size() - 1, static_cast<size_t>(p * static_cast<double>(samples.size())))];
+    };
+    return LatencyResult{ name, samples.size(), static_cast<double>(samples.size()) * 1e9 / total_ns,
+                          percentile(0.5), percentile(0.9), percentile(0.99), percentile(0.999), samples.back() };
+}
+
+// Печатает пропускную способность и перцентили задержки одной строкой
+inline void PrintLatencyResult(const LatencyResult& result)
+{
+    CurrentBenchReport().latencies.emplace_back(CurrentBenchReport().suite, result);
+    const auto us = [](double ns) { return ns / 1000; };
+    std::cout << std::left << std::setw(48) << result.name << std::right << std::fixed << std::setprecision(1)
+              << std::setw(12) << result.ops_per_sec << " ops/s"
+              << std::setprecision(2) << "  p50 " << us(result.p50_ns) << "  p90 " << us(result.p90_ns)
+              << "  p99 " << us(result.p99_ns) << "  p99.9 " << us(result.p999_ns) << "  max " << us(result.max_ns)
+              << " us" << std::endl;
+}
+
+// Синтетический корпус: слова вида "w<номер>" с распределением Ципфа по номеру
+inline std::vector<std::string> MakeSyntheticCorpus(size_t num_docs, size_t words_per_doc,
+                                                    size_t vocabulary, uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::vector<double> weights(vocabulary);
+    for (size_t i = 0; i < vocabulary; ++i)
+    {
+        weights[i] = 1.0 / static_cast<double>(i + 1);
+    }
+    std::discrete_distribution<size_t> zipf(weights.begin(), weights.end());
+
+    std::vector<std::string> docs(num_docs);
+    for (auto& doc : docs)
+    {
+        for (size_t i = 0; i < words_per_doc; ++i)
+        {
+            doc += 'w';
+            doc += std::to_string(zipf(rng));
+            doc += ' ';
+        }
+    }
+    return docs;
+}
+
+// Наборы бенчмарков, запускаются из bench.cpp
+void RunQueryEvaluatorBench();
+void RunDynamicPruningBench();
+void RunBlockMaxBench();
+void RunConjunctiveBench();
+void RunTextNormalizerBench();
+void RunFuzzyTermBench();
+void RunAutocompleteBench();
+void RunCoreBench();
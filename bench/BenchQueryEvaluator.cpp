@@ -0,0 +1,325 @@
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <unordered_set>
+#include "BenchHarness.h"
+#include "InvertedIndex.h"
+#include "PostingIterator.h"
+#include "QueryEvaluator.h"
+#include "Scorers.h"
+#include "SearchServer.h"
+
+namespace
+{
+    // Разбивает запрос на уникальные нормализованные слова
+    std::vector<std::string> SplitQuery(const InvertedIndex& idx, const std::string& query)
+    {
+        std::unordered_set<std::string> words_set;
+        std::stringstream buffer_stream(query);
+        std::string word;
+        while (buffer_stream >> word)
+        {
+            std::string normalized = idx.normalizeWord(word);
+            if (!normalized.empty())
+            {
+                words_set.insert(std::move(normalized));
+            }
+        }
+        return { words_set.begin(), words_set.end() };
+    }
+
+    // Написанный вручную цикл подсчета релевантности - эталон для сравнения с шаблонным
+    std::vector<RelativeIndex> HandWrittenSearch(const InvertedIndex& idx,
+                                                 const std::vector<std::string>& terms, size_t limit)
+    {
+        std::vector<size_t> absolute_relevance(idx.GetTotalDocuments(), 0);
+        for (const auto& term : terms)
+        {
+            for (const auto& entry : idx.FindPostings(term).entries)
+            {
+                absolute_relevance[entry.doc_id] += entry.count;
+            }
+        }
+        return RankDocuments(absolute_relevance, limit);
+    }
+
+    template <typename Scorer>
+    std::vector<RelativeIndex> TemplateSearch(const InvertedIndex& idx,
+                                              const std::vector<std::string>& terms, size_t limit)
+    {
+        auto iterators = MakeIterators<EntryPostingIterator>(idx, terms);
+        return EvaluateExhaustive(iterators, Scorer{}, idx.GetTotalDocuments(), limit);
+    }
+
+    template <typename Scorer>
+    std::vector<RelativeIndex> MaxScoreSearch(const InvertedIndex& idx,
+                                          const std::vector<std::string>& terms, size_t limit)
+    {
+        auto iterators = MakeIterators<EntryPostingIterator>(idx, terms);
+        return EvaluateMaxScore(iterators, Scorer{}, idx.GetTotalDocuments(), limit);
+    }
+
+    template <typename Scorer>
+    std::vector<RelativeIndex> BlockMaxSearch(const InvertedIndex& idx,
+                                              const std::vector<std::string>& terms, size_t limit,
+                                              size_t* decoded = nullptr)
+    {
+        auto iterators = MakeIterators<BlockPostingIterator>(idx, terms);
+        auto result = EvaluateBlockMaxWand(iterators, Scorer{}, idx.GetTotalDocuments(), limit);
+        if (decoded)
+        {
+            for (const auto& it : iterators)
+            {
+                *decoded += it.Decoded();
+            }
+        }
+        return result;
+    }
+
+    template <typename Scorer>
+    std::vector<RelativeIndex> ConjunctiveSearch(const InvertedIndex& idx,
+                                                 const std::vector<std::string>& terms, size_t limit)
+    {
+        auto iterators = MakeIterators<EntryPostingIterator>(idx, terms);
+        return EvaluateConjunctive(iterators, Scorer{}, idx.GetTotalDocuments(), limit);
+    }
+
+    // Запросы из min_length..max_length слов синтетического корпуса,
+    // номер слова распределен примерно как 1/rank, как и в корпусе
+    std::vector<std::vector<std::string>> MakeQueries(const InvertedIndex& idx, size_t count,
+                                                      size_t min_length, size_t max_length,
+                                                      size_t vocabulary, uint32_t seed)
+    {
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<double> log_rank(0.0, std::log(static_cast<double>(vocabulary)));
+        std::vector<std::vector<std::string>> queries;
+        for (size_t i = 0; i < count; ++i)
+        {
+            std::string query;
+            const size_t length = min_length + rng() % (max_length - min_length + 1);
+            for (size_t j = 0; j < length; ++j)
+            {
+                query += "w" + std::to_string(static_cast<size_t>(std::exp(log_rank(rng))) - 1) + " ";
+            }
+            queries.push_back(SplitQuery(idx, query));
+        }
+        return queries;
+    }
+}
+
+// Сравнение шаблонного цикла обработки запроса с написанным вручную
+void RunQueryEvaluatorBench()
+{
+    std::cout << "\n[query evaluator: template vs hand-written loop]" << std::endl;
+
+    InvertedIndex idx;
+    idx.UpdateDocumentBase(MakeSyntheticCorpus(20000, 200, 20000, 42));
+
+    // Запросы из 1-6 слов, слова выбираются с тем же распределением, что и в корпусе
+    const auto queries = MakeQueries(idx, 200, 1, 6, 20000, 7);
+    const size_t limit = 5;
+
+    // Результаты шаблонного цикла должны совпадать с эталоном
+    for (const auto& terms : queries)
+    {
+        if (HandWrittenSearch(idx, terms, limit) != TemplateSearch<TermCountScorer>(idx, terms, limit))
+        {
+            std::cerr << "Mismatch between template and hand-written evaluation" << std::endl;
+            return;
+        }
+    }
+
+    PrintBenchResult(RunBenchmark("hand-written loop, 200 queries", [&]
+    {
+        for (const auto& terms : queries)
+        {
+            DoNotOptimize(HandWrittenSearch(idx, terms, limit));
+        }
+    }));
+    PrintBenchResult(RunBenchmark("template<TermCountScorer>, 200 queries", [&]
+    {
+        for (const auto& terms : queries)
+        {
+            DoNotOptimize(TemplateSearch<TermCountScorer>(idx, terms, limit));
+        }
+    }));
+    PrintBenchResult(RunBenchmark("template<TfIdfScorer>, 200 queries", [&]
+    {
+        for (const auto& terms : queries)
+        {
+            DoNotOptimize(TemplateSearch<TfIdfScorer>(idx, terms, limit));
+        }
+    }));
+}
+
+// Динамическое отсечение MaxScore против исчерпывающей обработки на длинных запросах
+void RunDynamicPruningBench()
+{
+    std::cout << "\n[dynamic pruning: MaxScore vs exhaustive, 6-10 term queries]" << std::endl;
+
+    InvertedIndex idx;
+    // Большое число коротких документов: исчерпывающая обработка тратит время на все документы корпуса
+    idx.UpdateDocumentBase(MakeSyntheticCorpus(200000, 50, 50000, 42));
+    const auto queries = MakeQueries(idx, 200, 6, 10, 50000, 11);
+    const size_t limit = 5;
+
+    // Отсечение не должно менять ответ
+    for (const auto& terms : queries)
+    {
+        if (TemplateSearch<TermCountScorer>(idx, terms, limit) != MaxScoreSearch<TermCountScorer>(idx, terms, limit))
+        {
+            std::cerr << "Mismatch between MaxScore and exhaustive evaluation" << std::endl;
+            return;
+        }
+    }
+
+    PrintBenchResult(RunBenchmark("exhaustive<TermCountScorer>, 200 queries", [&]
+    {
+        for (const auto& terms : queries)
+        {
+            DoNotOptimize(TemplateSearch<TermCountScorer>(idx, terms, limit));
+        }
+    }));
+    PrintBenchResult(RunBenchmark("maxscore<TermCountScorer>, 200 queries", [&]
+    {
+        for (const auto& terms : queries)
+        {
+            DoNotOptimize(MaxScoreSearch<TermCountScorer>(idx, terms, limit));
+        }
+    }));
+    PrintBenchResult(RunBenchmark("exhaustive<TfIdfScorer>, 200 queries", [&]
+    {
+        for (const auto& terms : queries)
+        {
+            DoNotOptimize(TemplateSearch<TfIdfScorer>(idx, terms, limit));
+        }
+    }));
+    PrintBenchResult(RunBenchmark("maxscore<TfIdfScorer>, 200 queries", [&]
+    {
+        for (const auto& terms : queries)
+        {
+            DoNotOptimize(MaxScoreSearch<TfIdfScorer>(idx, terms, limit));
+        }
+    }));
+}
+
+// Block-Max WAND: количество просмотренных вхождений и время против исчерпывающей обработки
+void RunBlockMaxBench()
+{
+    std::cout << "\n[block-max WAND vs exhaustive, 2-10 term queries]" << std::endl;
+
+    InvertedIndex idx;
+    idx.UpdateDocumentBase(MakeSyntheticCorpus(200000, 50, 50000, 42));
+    const auto queries = MakeQueries(idx, 200, 2, 10, 50000, 13);
+    const size_t limit = 5;
+
+    size_t exhaustive_decoded = 0;
+    size_t block_max_decoded = 0;
+    for (const auto& terms : queries)
+    {
+        for (const auto& term : terms)
+        {
+            exhaustive_decoded += idx.FindPostings(term).entries.size();
+        }
+        if (TemplateSearch<TermCountScorer>(idx, terms, limit) !=
+            BlockMaxSearch<TermCountScorer>(idx, terms, limit, &block_max_decoded))
+        {
+            std::cerr << "Mismatch between block-max WAND and exhaustive evaluation" << std::endl;
+            return;
+        }
+    }
+    std::cout << "postings decoded per query: exhaustive " << exhaustive_decoded / queries.size()
+              << ", block-max WAND " << block_max_decoded / queries.size() << std::endl;
+
+    PrintBenchResult(RunBenchmark("exhaustive<TermCountScorer>, 200 queries", [&]
+    {
+        for (const auto& terms : queries)
+        {
+            DoNotOptimize(TemplateSearch<TermCountScorer>(idx, terms, limit));
+        }
+    }));
+    PrintBenchResult(RunBenchmark("blockmax<TermCountScorer>, 200 queries", [&]
+    {
+        for (const auto& terms : queries)
+        {
+            DoNotOptimize(BlockMaxSearch<TermCountScorer>(idx, terms, limit));
+        }
+    }));
+    PrintBenchResult(RunBenchmark("blockmax<TfIdfScorer>, 200 queries", [&]
+    {
+        for (const auto& terms : queries)
+        {
+            DoNotOptimize(BlockMaxSearch<TfIdfScorer>(idx, terms, limit));
+        }
+    }));
+}
+
+// Режим "все слова" (пересечение списков) против режима "любое слово"
+void RunConjunctiveBench()
+{
+    std::cout << "\n[conjunctive (AND) vs disjunctive (OR), 2-5 term queries]" << std::endl;
+
+    InvertedIndex idx;
+    idx.UpdateDocumentBase(MakeSyntheticCorpus(200000, 50, 50000, 42));
+    const auto queries = MakeQueries(idx, 200, 2, 5, 50000, 17);
+    const size_t limit = 5;
+
+    PrintBenchResult(RunBenchmark("OR exhaustive<TermCountScorer>, 200 queries", [&]
+    {
+        for (const auto& terms : queries)
+        {
+            DoNotOptimize(TemplateSearch<TermCountScorer>(idx, terms, limit));
+        }
+    }));
+    PrintBenchResult(RunBenchmark("OR maxscore<TermCountScorer>, 200 queries", [&]
+    {
+        for (const auto& terms : queries)
+        {
+            DoNotOptimize(MaxScoreSearch<TermCountScorer>(idx, terms, limit));
+        }
+    }));
+    PrintBenchResult(RunBenchmark("AND intersection<TermCountScorer>, 200 queries", [&]
+    {
+        for (const auto& terms : queries)
+        {
+            DoNotOptimize(ConjunctiveSearch<TermCountScorer>(idx, terms, limit));
+        }
+    }));
+
+    // Тот же поток запросов через SearchServer с кэшем пересечений и без него
+    // (кэш результатов отключен, чтобы измерять только пересечения)
+    std::vector<CompiledQuery> compiled;
+    SearchServer srv(idx);
+    SearchOptions options;
+    options.mode = QueryMode::All;
+    options.cache_capacity = 0;
+    for (const auto& posting_cache_mb : { 0, 64 })
+    {
+        options.posting_cache_bytes = static_cast<size_t>(posting_cache_mb) << 20;
+        srv.SetOptions(options);
+        compiled.clear();
+        for (const auto& terms : queries)
+        {
+            std::string query;
+            for (const auto& term : terms)
+            {
+                query += term + " ";
+            }
+            compiled.push_back(srv.Compile(query));
+        }
+        PrintBenchResult(RunBenchmark("AND server, posting cache " + std::to_string(posting_cache_mb) +
+                                      " MB, 200 queries", [&]
+        {
+            for (const auto& query : compiled)
+            {
+                DoNotOptimize(srv.search(query, limit));
+            }
+        }));
+    }
+    const PostingCacheStats stats = srv.GetPostingCacheStats();
+    std::cout << "  posting cache: " << stats.entries << " pairs, " << (stats.bytes >> 10) << " KB, "
+              << stats.hits << " hits, " << stats.misses << " misses, " << stats.evictions << " evictions"
+              << std::endl;
+}
@@ -0,0 +1,142 @@
+#include <cctype>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include "BenchHarness.h"
+#include "InvertedIndex.h"
+#include "Stemmer.h"
+#include "TextNormalizer.h"
+
+namespace
+{
+    // Прежняя побайтовая нормализация (std::isalnum/std::tolower) - для сравнения скорости
+    std::string ByteNormalizeWord(const std::string& word)
+    {
+        std::string result;
+        result.reserve(word.size());
+        for (char c : word)
+        {
+            if (std::isalnum(static_cast<unsigned char>(c)))
+            {
+                result += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+            }
+        }
+        return result;
+    }
+
+    // Слова текста: заглавная буква в начале предложения, знаки препинания после части слов
+    std::vector<std::string> MakeWords(const std::vector<std::string>& vocabulary, size_t count, uint32_t seed)
+    {
+        std::mt19937 rng(seed);
+        std::vector<double> weights(vocabulary.size());
+        for (size_t i = 0; i < weights.size(); ++i)
+        {
+            weights[i] = 1.0 / static_cast<double>(i + 1);
+        }
+        std::discrete_distribution<size_t> zipf(weights.begin(), weights.end());
+        std::vector<std::string> words;
+        words.reserve(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            std::string word = vocabulary[zipf(rng)];
+            if (rng() % 10 == 0)
+            {
+                word += ',';
+            }
+            if (rng() % 12 == 0 && static_cast<unsigned char>(word[0]) < 0x80)
+            {
+                word[0] = static_cast<char>(std::toupper(static_cast<unsigned char>(word[0])));
+            }
+            words.push_back(std::move(word));
+        }
+        return words;
+    }
+
+    size_t TotalBytes(const std::vector<std::string>& words)
+    {
+        size_t bytes = 0;
+        for (const auto& word : words)
+        {
+            bytes += word.size();
+        }
+        return bytes;
+    }
+
+    template <typename Normalize>
+    void RunCorpus(const std::string& name, const std::vector<std::string>& words, Normalize normalize)
+    {
+        const BenchResult result = RunBenchmark(name, [&]
+        {
+            for (const auto& word : words)
+            {
+                DoNotOptimize(normalize(word));
+            }
+        });
+        PrintBenchResult(result);
+        const double megabytes = static_cast<double>(TotalBytes(words)) / (1 << 20);
+        std::cout << "  " << std::fixed << std::setprecision(1) << megabytes / (result.ns_per_op * 1e-9) << " MB/s"
+                  << std::endl;
+    }
+}
+
+void RunTextNormalizerBench()
+{
+    std::cout << "\n[word normalization throughput, 200k words]" << std::endl;
+
+    const std::vector<std::string> english =
+        {
+            "the", "of", "and", "capital", "moscow", "london", "is", "city", "international", "government",
+            "population", "information", "river", "century", "university", "history", "development", "russia"
+        };
+    const std::vector<std::string> russian =
+        {
+            "и", "в", "не", "на", "столица", "Москва", "город", "России", "правительство", "население",
+            "информация", "река", "века", "университет", "история", "развитие", "Ёлка", "район"
+        };
+    std::vector<std::string> mixed;
+    for (size_t i = 0; i < english.size(); ++i)
+    {
+        mixed.push_back(english[i]);
+        mixed.push_back(russian[i]);
+    }
+    const auto english_words = MakeWords(english, 200000, 1);
+    const auto russian_words = MakeWords(russian, 200000, 2);
+    const auto mixed_words = MakeWords(mixed, 200000, 3);
+
+    RunCorpus("english, byte isalnum/tolower", english_words, ByteNormalizeWord);
+    RunCorpus("english, NormalizeWord", english_words, [](const std::string& w) { return NormalizeWord(w); });
+    RunCorpus("russian, NormalizeWord", russian_words, [](const std::string& w) { return NormalizeWord(w); });
+    RunCorpus("mixed, NormalizeWord", mixed_words, [](const std::string& w) { return NormalizeWord(w); });
+
+    // Стемминг: без запоминания основ и со словарем основ потока
+    std::vector<std::string> normalized;
+    for (const auto& word : mixed_words)
+    {
+        normalized.push_back(NormalizeWord(word));
+    }
+    const Stemmer* stemmer = GetStemmer(StemmerType::Auto);
+    RunCorpus("mixed, Stem (no memo)", normalized, [&](const std::string& w) { return stemmer->Stem(w); });
+    RunCorpus("mixed, StemWord (memo)", normalized, [](const std::string& w) { return StemWord(StemmerType::Auto, w); });
+
+    // Индексация смешанного корпуса целиком
+    std::vector<std::string> docs(2000);
+    for (size_t i = 0; i < mixed_words.size(); ++i)
+    {
+        docs[i % docs.size()] += mixed_words[i] + ' ';
+    }
+    PrintBenchResult(RunBenchmark("index mixed corpus, 2000 docs", [&]
+    {
+        InvertedIndex idx;
+        idx.UpdateDocumentBase(docs);
+        DoNotOptimize(idx.GetTotalDocuments());
+    }));
+    PrintBenchResult(RunBenchmark("index mixed corpus + auto stemmer, 2000 docs", [&]
+    {
+        InvertedIndex idx;
+        IndexOptions options;
+        options.stemmer = StemmerType::Auto;
+        idx.SetOptions(options);
+        idx.UpdateDocumentBase(docs);
+        DoNotOptimize(idx.GetTotalDocuments());
+    }));
+}
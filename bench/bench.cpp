@@ -0,0 +1,136 @@
+#include <algorithm>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include "BenchHarness.h"
+
+namespace
+{
+    // Набор бенчмарков и его название для --suite
+    struct BenchSuite
+    {
+        std::string name;
+
+        std::function<void()> run;
+    };
+
+    const std::vector<BenchSuite>& Suites()
+    {
+        static const std::vector<BenchSuite> suites =
+            {
+                { "evaluator", RunQueryEvaluatorBench },
+                { "pruning", RunDynamicPruningBench },
+                { "blockmax", RunBlockMaxBench },
+                { "conjunctive", RunConjunctiveBench },
+                { "normalizer", RunTextNormalizerBench },
+                { "fuzzy", RunFuzzyTermBench },
+                { "autocomplete", RunAutocompleteBench },
+                { "core", RunCoreBench }
+            };
+        return suites;
+    }
+
+    // Отчет в JSON: условия запуска и все замеры, чтобы сравнивать версии между собой
+    void WriteReport(const std::string& path)
+    {
+        const BenchReport& report = CurrentBenchReport();
+        nlohmann::ordered_json json;
+        json["timestamp"] = static_cast<int64_t>(std::time(nullptr));
+#if defined(__clang__)
+        json["compiler"] = "clang " __clang_version__;
+#elif defined(__GNUC__)
+        json["compiler"] = "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+        json["compiler"] = "msvc " + std::to_string(_MSC_VER);
+#endif
+#ifdef NDEBUG
+        json["assertions"] = false;
+#else
+        json["assertions"] = true;
+#endif
+        json["results"] = nlohmann::ordered_json::array();
+        for (const auto& [suite, result] : report.results)
+        {
+            nlohmann::ordered_json item = {
+                { "suite", suite }, { "name", result.name }, { "iterations", result.iterations },
+                { "ns_per_op", result.ns_per_op }, { "ops_per_sec", 1e9 / result.ns_per_op }
+            };
+            if (result.bytes_per_op > 0)
+            {
+                item["bytes_per_sec"] = result.bytes_per_op * 1e9 / result.ns_per_op;
+            }
+            json["results"].push_back(std::move(item));
+        }
+        json["latencies"] = nlohmann::ordered_json::array();
+        for (const auto& [suite, result] : report.latencies)
+        {
+            json["latencies"].push_back({
+                { "suite", suite }, { "name", result.name }, { "operations", result.operations },
+                { "ops_per_sec", result.ops_per_sec }, { "p50_ns", result.p50_ns }, { "p90_ns", result.p90_ns },
+                { "p99_ns", result.p99_ns }, { "p999_ns", result.p999_ns }, { "max_ns", result.max_ns }
+            });
+        }
+        std::ofstream(path) << json.dump(4) << std::endl;
+    }
+}
+
+// Search_engine_bench [--suite <название>]... [--json <файл>] [--list]
+// Без --suite выполняются все наборы
+int main(int argc, char* argv[])
+{
+    std::vector<std::string> selected;
+    std::string json_path;
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        if (arg == "--suite" && i + 1 < argc)
+        {
+            selected.push_back(argv[++i]);
+        }
+        else if (arg == "--json" && i + 1 < argc)
+        {
+            json_path = argv[++i];
+        }
+        else if (arg == "--list")
+        {
+            for (const auto& suite : Suites())
+            {
+                std::cout << suite.name << std::endl;
+            }
+            return 0;
+        }
+        else
+        {
+            std::cerr << "Usage: " << argv[0] << " [--suite <name>]... [--json <file>] [--list]" << std::endl;
+            return 1;
+        }
+    }
+    for (const auto& name : selected)
+    {
+        if (std::none_of(Suites().begin(), Suites().end(), [&](const BenchSuite& suite) { return suite.name == name; }))
+        {
+            std::cerr << "Unknown suite: " << name << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << "Search_engine benchmarks" << std::endl;
+    for (const auto& suite : Suites())
+    {
+        if (selected.empty() || std::find(selected.begin(), selected.end(), suite.name) != selected.end())
+        {
+            CurrentBenchReport().suite = suite.name;
+            suite.run();
+        }
+    }
+    if (!json_path.empty())
+    {
+        WriteReport(json_path);
+        std::cout << "\nReport saved to " << json_path << std::endl;
+    }
+    return 0;
+}
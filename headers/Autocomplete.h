@@ -0,0 +1,84 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "InvertedIndex.h"
+#include "TermDictionary.h"
+
+// Вариант дополнения префикса и его вес (частота)
+struct Completion
+{
+    std::string text;
+
+    uint64_t weight;
+
+    bool operator==(const Completion& other) const
+    {
+        return text == other.text && weight == other.weight;
+    }
+};
+
+// Приводит текст запроса к виду, в котором хранятся дополнения: слова нормализуются
+// (NormalizeWord) и разделяются одним пробелом. Пробел в конце сохраняется - после него
+// дополняется следующее слово, а не текущее
+std::string NormalizeCompletion(std::string_view text);
+
+// Дополнение запроса: K самых частых вариантов, начинающихся с префикса.
+// Варианты хранятся в упорядоченном словаре (TermDictionary), поэтому варианты с одним
+// префиксом имеют подряд идущие номера. Над весами по номерам строится дерево отрезков
+// с номером самого частого варианта в каждом отрезке: лучший вариант диапазона находится
+// за O(log n), а K лучших - выбором из кучи отрезков, на которые диапазон делится найденными
+// вариантами. Память - словарь и 16 байт на вариант
+class Autocompleter
+{
+public:
+    // Строит по словарю индекса: вес слова - количество документов, в которых оно встречается.
+    // Со стеммером словарь содержит основы слов, они и предлагаются
+    void Build(const InvertedIndex& index);
+
+    // Строит по журналу запросов: пары {запрос, вес}, например количество повторов запроса.
+    // Запросы нормализуются (NormalizeCompletion), веса одинаковых запросов складываются
+    void Build(const std::vector<std::pair<std::string, uint64_t>>& queries);
+
+    // Не больше limit вариантов, начинающихся с нормализованного префикса, по убыванию веса,
+    // при равном весе - по возрастанию
+    std::vector<Completion> Complete(std::string_view prefix, size_t limit) const;
+
+    // Количество вариантов
+    size_t Size() const { return _weights.size(); }
+
+    // Память под словарь, веса и дерево отрезков в байтах
+    size_t MemoryBytes() const
+    {
+        return _dictionary.MemoryBytes() + _weights.capacity() * sizeof(uint64_t) + _tree.capacity() * sizeof(uint32_t);
+    }
+
+    void Clear();
+
+private:
+    // Строит дерево отрезков по _weights
+    void BuildTree();
+
+    // Лучший из двух вариантов: больший вес, при равенстве - меньший номер
+    uint32_t Better(uint32_t a, uint32_t b) const
+    {
+        if (a == NO_TERM || b == NO_TERM)
+        {
+            return a == NO_TERM ? b : a;
+        }
+        return _weights[a] > _weights[b] || (_weights[a] == _weights[b] && a < b) ? a : b;
+    }
+
+    // Номер лучшего варианта на полуинтервале номеров [first, last), NO_TERM для пустого
+    uint32_t Best(uint32_t first, uint32_t last) const;
+
+    TermDictionary _dictionary; // Варианты дополнения
+
+    std::vector<uint64_t> _weights; // Вес варианта по номеру
+
+    // Дерево отрезков снизу вверх: листья - _tree[n + i] = i, узел - лучший из двух детей
+    std::vector<uint32_t> _tree;
+};
@@ -0,0 +1,93 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "InvertedIndex.h"
+#include "QueryEvaluator.h"
+#include "SearchOptions.h"
+
+// Узел дерева разобранного запроса
+struct QueryNode
+{
+    enum class Type
+    {
+        Term,   // Одно нормализованное слово
+        Phrase, // Слова в кавычках
+        Near,     // Два слова на расстоянии не более distance
+        Wildcard, // Шаблон слова ("capit*", "c?pital"), раскрытый в слова словаря
+        Fuzzy,    // Нечеткое слово ("moscow~1"), раскрытое в близкие слова словаря
+        Substring, // Подстрока слова ("sub:4471")
+        Boolean   // Группа условий
+    };
+
+    Type type = Type::Boolean;
+
+    // Term - одно слово, Phrase - слова фразы по порядку, Near - два слова,
+    // Wildcard, Fuzzy - подходящие слова словаря по возрастанию
+    std::vector<std::string> terms;
+
+    // Wildcard - нормализованный шаблон, Fuzzy - нормализованное слово, Substring - нормализованная подстрока
+    std::string pattern;
+
+    std::vector<double> boosts; // Fuzzy - множители веса слов terms: чем больше правок, тем меньше
+
+    size_t distance = 0; // Near - наибольшее расстояние между словами (в словах), Fuzzy - наибольшее число правок
+
+    // Условия группы (Boolean). Документ найден, если он подходит под все must и ни под одно
+    // must_not; если must пусто - под хотя бы одно should. Условия should, кроме того,
+    // добавляют релевантность. Группа только из must_not не находит ничего
+    std::vector<std::shared_ptr<const QueryNode>> must;
+    std::vector<std::shared_ptr<const QueryNode>> should;
+    std::vector<std::shared_ptr<const QueryNode>> must_not;
+
+    // Проверяет, что группа состоит только из отдельных слов
+    static bool AllTerms(const std::vector<std::shared_ptr<const QueryNode>>& clauses);
+};
+
+// Запрос, разобранный один раз и пригодный для многократного выполнения
+struct CompiledQuery
+{
+    std::shared_ptr<const QueryNode> root; // nullptr - запрос без единого слова
+
+    // Канонический вид запроса: одинаков у запросов, отличающихся только порядком условий
+    // в группах и повторами слов. Используется как ключ кэша результатов
+    std::string key;
+
+    std::string text; // Исходная строка запроса
+
+    // Версия индекса (InvertedIndex::GetVersion), по словарю которой раскрыты шаблоны и нечеткие
+    // слова. После обновления индекса запрос разбирается заново из text
+    uint64_t version = 0;
+};
+
+// Разбор строки запроса в дерево.
+// Обычный синтаксис (QuerySyntax::Plain): слова через пробел, режим QueryMode определяет,
+// обязательны ли они все.
+// Логический синтаксис (QuerySyntax::Boolean):
+//   a b        - хотя бы одно из слов (или все, если mode = all);
+//   a AND b    - оба условия; a OR b - хотя бы одно; NOT a - исключение;
+//   a OR NOT b - равносильно a: условие только из исключений не находит документов, как и запрос NOT b;
+//   +a / -a    - обязательное / исключенное условие в последовательности;
+//   ( ... )    - группировка; "a b c" - фраза;
+//   a NEAR/k b - слова на расстоянии не более k слов в любом порядке (NEAR без числа - k = 5).
+// В обоих синтаксисах слово с "*" или "?" - шаблон: "capit*", "c?pital". Он раскрывается
+// в не более чем wildcard_limit слов словаря (самые частые), документ подходит под шаблон,
+// если содержит хотя бы одно из них. wildcard_limit = 0 - шаблоны не раскрываются,
+// а "*" и "?" отбрасываются как знаки препинания.
+// Слово "слово~k" (k = 1 или 2, "слово~" - k = 2) - нечеткое: находит слова словаря, отличающиеся
+// не более чем на k правок (не более fuzzy_limit ближайших). Вклад слова с d правками в релевантность
+// умножается на 1 / (1 + d) при любой функции ранжирования. fuzzy_limit = 0 - "~" отбрасывается.
+// Слово "sub:подстрока" находит документы со словами, содержащими подстроку (InvertedIndex::FindSubstring).
+// Фразы и NEAR проверяют позиции слов, если индекс построен с ними (IndexOptions::positions),
+// иначе находят документы, содержащие все их слова.
+// Операторы AND, OR, NOT, NEAR записываются заглавными буквами. Ошибки синтаксиса не прерывают
+// разбор: лишние скобки пропускаются, незакрытые скобки и кавычки закрываются в конце запроса
+CompiledQuery CompileQuery(const std::string& query, const InvertedIndex& index, QuerySyntax syntax, QueryMode mode,
+                           size_t wildcard_limit = DEFAULT_WILDCARD_LIMIT, size_t fuzzy_limit = DEFAULT_FUZZY_LIMIT);
+
+// Выполняет запрос с функцией ранжирования Scorer и возвращает не более limit документов.
+// Для узлов выбираются подходящие физические операторы: пересечение галопирующим поиском,
+// объединение слиянием, исключение - пропуском по спискам вхождений
+template <typename Scorer>
+std::vector<RelativeIndex> EvaluateQueryTree(const QueryNode& root, const InvertedIndex& index, size_t limit);
@@ -3,6 +3,9 @@
 #include <string>
 #include <vector>
 #include <nlohmann/json.hpp>
+#include "IndexOptions.h"
+#include "IndexingMetrics.h"
+#include "SearchOptions.h"
 
 using json = nlohmann::json;
 using ordered_json = nlohmann::ordered_json;
@@ -21,15 +24,43 @@ public:
     // в config.json
     std::vector<std::string> GetTextDocuments();
 
+    // Наблюдатель получает показатели чтения документов в GetTextDocuments не чаще раза
+    // в interval секунд и итоговые показатели в конце чтения
+    void SetProgressObserver(IndexingObserver observer, double interval = 1.0)
+    {
+        _observer = std::move(observer);
+        _observer_interval = interval;
+    }
+
+    // Показатели последнего чтения документов: количество, байты, время чтения
+    const IndexingMetrics& GetLoadMetrics() const { return _load_metrics; }
+
     // Метод считывает поле max_responses для определения максимального
     // количества ответов на один запрос
     int GetResponsesLimit();
 
+    // Метод считывает необязательную секцию search с настройками обработки запросов
+    // return Возвращает настройки, для отсутствующих полей - значения по умолчанию
+    SearchOptions GetSearchOptions();
+
+    // Метод считывает необязательную секцию index с настройками построения индекса
+    // return Возвращает настройки, для отсутствующих полей - значения по умолчанию
+    IndexOptions GetIndexOptions();
+
     // Метод получения запросов из файла requests.json
     // return Возвращает список запросов из файла requests.json
     std::vector<std::string> GetRequests();
 
     // Метод записи ответов.
-    // Положить в файл answers.json результаты поисковых запросов
-    void putAnswers(std::vector<std::vector<std::pair<int, float>>> answers);
+    // Положить в файл answers.json результаты поисковых запросов.
+    // suggestions - подсказки исправлений для запросов без результатов (пустая строка - без подсказки)
+    void putAnswers(std::vector<std::vector<std::pair<int, float>>> answers,
+                    const std::vector<std::string>& suggestions = {});
+
+private:
+    IndexingMetrics _load_metrics; // Показатели последнего чтения документов
+
+    IndexingObserver _observer; // Получатель отчетов о ходе чтения
+
+    double _observer_interval = 1.0; // Секунды между отчетами
 };
\ No newline at end of file
@@ -0,0 +1,106 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+#include "InvertedIndex.h"
+#include "TermDictionary.h"
+
+// Нечеткие слова в запросах: "слово~1", "слово~2" (слово~ - то же, что слово~2) находят
+// слова словаря, отличающиеся не более чем на заданное количество правок: вставка, удаление,
+// замена символа или перестановка двух соседних символов
+
+// Наибольшее допустимое количество правок
+constexpr size_t MAX_FUZZY_DISTANCE = 2;
+
+// Символы (кодовые точки) строки UTF-8. Некорректный байт считается отдельным символом
+std::vector<uint32_t> DecodeUtf8(std::string_view text);
+
+// Распознает нечеткое слово: word без "~k" в base и количество правок в distance
+// (не больше MAX_FUZZY_DISTANCE). false - слово не нечеткое
+bool ParseFuzzyTerm(std::string_view word, std::string& base, size_t& distance);
+
+// Расстояние между словами в символах UTF-8 с учетом перестановки соседних символов
+// (ограниченное расстояние Дамерау-Левенштейна)
+size_t EditDistance(std::string_view a, std::string_view b);
+
+// Множитель веса слова, найденного с distance правками: 1 / (1 + distance)
+inline double FuzzyBoost(size_t distance)
+{
+    return 1.0 / static_cast<double>(1 + distance);
+}
+
+// Автомат Левенштейна: допускает слова на расстоянии не больше distance от заданного.
+// Недетерминированный автомат по символам слова (состояния - прочитанная часть слова и
+// количество сделанных правок) детерминизируется по мере обхода словаря. Вход - байты UTF-8:
+// недочитанный многобайтовый символ хранится в состоянии
+class LevenshteinAutomaton : public TermAutomaton
+{
+public:
+    LevenshteinAutomaton(std::string_view word, size_t distance);
+
+    int Start() override { return _start; }
+
+    int Step(int state, uint8_t byte) override;
+
+    bool IsMatch(int state) override { return _matches[state]; }
+
+private:
+    // Детерминированное состояние: недочитанный символ и множество состояний
+    // недетерминированного автомата (позиция в слове, правки, начата ли перестановка)
+    struct State
+    {
+        uint32_t partial = 0; // Биты недочитанного символа
+        uint32_t pending = 0; // Сколько байтов символа осталось прочитать
+
+        std::vector<uint32_t> positions;
+
+        bool operator<(const State& other) const
+        {
+            return std::tie(partial, pending, positions) < std::tie(other.partial, other.pending, other.positions);
+        }
+    };
+
+    void AddClosure(std::vector<uint32_t>& positions, size_t index, size_t edits, bool transposing) const;
+
+    // Переходы недетерминированного автомата по символу
+    std::vector<uint32_t> StepCodePoint(const std::vector<uint32_t>& positions, uint32_t code_point) const;
+
+    int Intern(State state);
+
+    std::vector<uint32_t> _word; // Символы слова
+
+    size_t _distance;
+
+    std::map<State, int> _ids;
+
+    std::vector<State> _states;
+
+    std::vector<std::array<int, 256>> _transitions; // -2 - переход еще не вычислен
+
+    std::vector<bool> _matches;
+
+    int _start = -1;
+};
+
+// Слово словаря, найденное по нечеткому слову
+struct FuzzyMatch
+{
+    std::string term;
+
+    size_t distance; // Количество правок
+};
+
+// Слова словаря индекса на расстоянии не больше distance от нормализованного слова term,
+// по возрастанию. Если их больше limit, остаются ближайшие, при равном расстоянии - самые частые
+std::vector<FuzzyMatch> ExpandFuzzy(const InvertedIndex& index, const std::string& term, size_t distance, size_t limit);
+
+// Исправления нормализованного слова term для подсказки "возможно, вы имели в виду": слова словаря
+// индекса на расстоянии не больше distance, сначала ближайшие, при равном расстоянии - самые частые,
+// не больше limit. Кандидаты берутся из индекса удалений (IndexOptions::suggestions), если он
+// построен, иначе словарь обходится автоматом Левенштейна
+std::vector<FuzzyMatch> SuggestTerms(const InvertedIndex& index, const std::string& term, size_t distance, size_t limit);
@@ -0,0 +1,83 @@
+#pragma once
+#include <string>
+#include <vector>
+
+// Выделение основы слова (стемминг) при построении индекса и разборе запросов
+enum class StemmerType
+{
+    None,    // Слова не изменяются (по умолчанию)
+    Russian, // Стеммер Snowball для русского языка
+    English, // Стеммер Портера для английского языка
+    Auto     // Русский стеммер для слов на кириллице, английский - для слов на латинице
+};
+
+// Настройки построения индекса (секция "index" файла config.json).
+// Применяются при следующем вызове InvertedIndex::UpdateDocumentBase
+struct IndexOptions
+{
+    bool positions = false; // Хранить позиции слов в документах (нужны для фраз и NEAR)
+
+    StemmerType stemmer = StemmerType::None; // Стеммер, применяемый к словам документов и запросов
+
+    std::vector<std::string> stopwords; // Стоп-слова: не попадают в основной индекс и не ищутся
+
+    // Хранить стоп-слова в дополнительном позиционном индексе, чтобы фразы с ними
+    // проверялись точно (только вместе с positions)
+    bool stopwords_in_positions = false;
+
+    // Строить индекс триграмм нормализованных слов для поиска подстрок (sub:...)
+    bool substrings = false;
+
+    // Строить индекс удалений слов словаря для быстрых подсказок исправлений опечаток
+    bool suggestions = false;
+
+    // Секунды между отчетами о ходе чтения документов и построения индекса (IndexingMetrics),
+    // 0 - без отчетов
+    double progress_interval = 0;
+};
+
+// Встроенные списки стоп-слов: "english", "russian" или "auto" (оба списка).
+// Для неизвестного названия возвращается пустой список
+inline std::vector<std::string> GetBuiltinStopwords(const std::string& name)
+{
+    static const std::vector<std::string> english =
+        {
+            "a", "an", "and", "are", "as", "at", "be", "by", "for", "from", "has", "he", "in", "is", "it",
+            "its", "of", "on", "that", "the", "to", "was", "were", "will", "with"
+        };
+    static const std::vector<std::string> russian =
+        {
+            "и", "в", "во", "не", "что", "он", "на", "я", "с", "со", "как", "а", "то", "все", "она", "так",
+            "его", "но", "да", "ты", "к", "у", "же", "вы", "за", "бы", "по", "только", "ее", "мне", "было",
+            "вот", "от", "меня", "еще", "нет", "о", "из", "ему"
+        };
+    std::vector<std::string> result;
+    if (name == "english" || name == "auto")
+    {
+        result.insert(result.end(), english.begin(), english.end());
+    }
+    if (name == "russian" || name == "auto")
+    {
+        result.insert(result.end(), russian.begin(), russian.end());
+    }
+    return result;
+}
+
+// Преобразует название стеммера из config.json в StemmerType
+// Неизвестные названия приводят к значению по умолчанию
+inline StemmerType ParseStemmerType(const std::string& name)
+{
+    if (name == "russian")
+    {
+        return StemmerType::Russian;
+    }
+    if (name == "english")
+    {
+        return StemmerType::English;
+    }
+    if (name == "auto")
+    {
+        return StemmerType::Auto;
+    }
+    return StemmerType::None;
+}
@@ -0,0 +1,97 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+// Показатели чтения документов (ConverterJSON::GetTextDocuments) и построения индекса
+// (InvertedIndex::UpdateDocumentBase). Время этапов показывает, во что упирается построение:
+// в чтение файлов, в разбиение текста на слова или в словарь
+struct IndexingMetrics
+{
+    size_t documents = 0; // Обработанные документы
+
+    uint64_t bytes = 0; // Байты текста обработанных документов
+
+    uint64_t tokens = 0; // Нормализованные слова, включая стоп-слова
+
+    size_t unique_terms = 0; // Различные нормализованные слова, включая стоп-слова
+
+    // Память под списки вхождений и позиции. Во время построения - без блоков, в итоговом
+    // отчете - точное значение из InvertedIndex::GetIndexStats
+    size_t posting_bytes = 0;
+
+    size_t peak_memory = 0; // Наибольший объем памяти процесса в байтах, 0 - неизвестен
+
+    size_t memory_growth = 0; // Рост наибольшего объема памяти с начала чтения или построения
+
+    double seconds = 0; // Время с начала
+
+    double read_seconds = 0; // Чтение файлов документов
+
+    double tokenize_seconds = 0; // Разбиение на слова, нормализация и стемминг
+
+    double dictionary_seconds = 0; // Поиск и добавление слов во временный словарь
+
+    double postings_seconds = 0; // Группировка вхождений документа и запись в списки
+
+    double finalize_seconds = 0; // Упорядочивание словаря, FST, индекс удалений, блоки вхождений
+
+    bool finished = false; // Итоговый отчет
+};
+
+// Получает показатели во время чтения или построения не чаще заданного интервала и итоговые
+using IndexingObserver = std::function<void(const IndexingMetrics&)>;
+
+// Наибольший объем памяти процесса с момента запуска (peak RSS) в байтах,
+// 0 на платформах, где он неизвестен
+size_t GetPeakMemoryBytes();
+
+// Строка отчета: документы и байты в секунду, слова, словарь, память и доли времени этапов
+std::string FormatIndexingMetrics(const IndexingMetrics& metrics);
+
+// Замер времени этапов и периодические отчеты наблюдателю
+class IndexingProgress
+{
+public:
+    // interval - секунды между отчетами; без наблюдателя отчетов нет, но время этапов считается
+    IndexingProgress(IndexingMetrics& metrics, const IndexingObserver& observer, double interval);
+
+    // Прибавляет время с предыдущего замера к счетчику этапа
+    void Lap(double& phase_seconds)
+    {
+        const auto now = std::chrono::steady_clock::now();
+        phase_seconds += std::chrono::duration<double>(now - _last).count();
+        _last = now;
+    }
+
+    // Отчет наблюдателю, если с предыдущего прошло не меньше интервала
+    void Tick()
+    {
+        if (_observer && _last - _reported >= _interval)
+        {
+            Report(false);
+        }
+    }
+
+    // Итоговый отчет
+    void Finish() { Report(true); }
+
+private:
+    void Report(bool finished);
+
+    IndexingMetrics& _metrics;
+
+    const IndexingObserver& _observer;
+
+    std::chrono::duration<double> _interval;
+
+    std::chrono::steady_clock::time_point _start;
+
+    std::chrono::steady_clock::time_point _last; // Предыдущий замер этапа
+
+    std::chrono::steady_clock::time_point _reported; // Предыдущий отчет
+
+    size_t _initial_peak; // Наибольший объем памяти в начале
+};
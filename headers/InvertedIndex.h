@@ -1,9 +1,18 @@
 #pragma once
 
+#include <cstdint>
 #include <iostream>
 #include <vector>
 #include <string>
 #include <map>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include "IndexOptions.h"
+#include "IndexingMetrics.h"
+#include "PositionList.h"
+#include "SpellingIndex.h"
+#include "TermDictionary.h"
 
 // Структура для хранения информации о вхождении слова в документ
 struct Entry
@@ -19,29 +28,220 @@ struct Entry
     }
 };
 
+// Количество вхождений в одном блоке списка вхождений
+constexpr size_t POSTING_BLOCK_SIZE = 64;
+
+// Сведения о блоке из POSTING_BLOCK_SIZE подряд идущих вхождений (последний блок может быть короче)
+struct PostingBlock
+{
+    size_t last_doc;  // doc_id последнего вхождения блока
+
+    size_t max_count; // Максимальное количество вхождений слова в документ внутри блока
+};
+
+// Список вхождений слова (posting list) и сведения о нем для обработки запросов
+struct PostingList
+{
+    std::vector<Entry> entries; // Вхождения по возрастанию doc_id
+
+    std::vector<PostingBlock> blocks; // Блоки вхождений: позволяют пропускать их, не просматривая
+
+    size_t max_count = 0; // Максимальное количество вхождений слова в один документ
+
+    uint64_t total_count = 0; // Суммарное количество вхождений слова во все документы
+};
+
+// Статистика слова индекса
+struct TermStats
+{
+    size_t doc_freq = 0; // Количество документов, содержащих слово
+
+    uint64_t collection_freq = 0; // Количество вхождений слова во все документы
+
+    size_t posting_bytes = 0; // Память под список вхождений слова, его блоки и позиции
+};
+
+// Статистика индекса для функций ранжирования и оценки нужной памяти
+struct IndexStats
+{
+    size_t documents = 0; // Количество документов
+
+    size_t vocabulary = 0; // Количество слов словаря (без стоп-слов)
+
+    uint64_t tokens = 0; // Количество слов во всех документах, включая стоп-слова
+
+    double average_length = 0; // Средняя длина документа в словах
+
+    size_t dictionary_bytes = 0; // Память под словарь
+
+    size_t posting_bytes = 0; // Память под списки вхождений и их блоки
+
+    size_t position_bytes = 0; // Память под позиции слов
+
+    size_t substring_bytes = 0; // Память под индекс триграмм
+
+    size_t spelling_bytes = 0; // Память под индекс удалений для подсказок
+};
+
 class InvertedIndex
 {
 public:
     InvertedIndex() = default;
 
+    // Задает настройки построения индекса, применяются при следующем UpdateDocumentBase
+    void SetOptions(const IndexOptions& options) { _options = options; }
+
+    const IndexOptions& GetOptions() const { return _options; }
+
     // Обновляет базу документов, передается вектор строк с содержимым документов
     void UpdateDocumentBase(std::vector<std::string> input_docs);
 
+    // Наблюдатель получает показатели построения индекса не чаще раза в interval секунд
+    // и итоговые показатели в конце UpdateDocumentBase
+    void SetProgressObserver(IndexingObserver observer, double interval = 1.0)
+    {
+        _observer = std::move(observer);
+        _observer_interval = interval;
+    }
+
+    // Показатели последнего построения индекса
+    const IndexingMetrics& GetIndexingMetrics() const { return _metrics; }
+
     // Получает частоту слов для конкретного документа по его номеру в базе
     std::vector<Entry> GetWordCount(const std::string& word) const;
 
+    // Возвращает ссылку на список вхождений уже нормализованного слова без копирования.
+    // Для отсутствующего слова возвращается пустой список
+    const PostingList& FindPostings(const std::string& normalized_word) const;
+
+    // Номер нормализованного слова в словаре или NO_TERM
+    uint32_t FindTermId(const std::string& normalized_word) const { return _terms.Find(normalized_word); }
+
+    // Список вхождений слова по его номеру в словаре
+    const PostingList& GetPostings(uint32_t term_id) const { return _postings[term_id]; }
+
+    // Упорядоченный словарь слов индекса (без стоп-слов)
+    const TermDictionary& GetTermDictionary() const { return _terms; }
+
+    // Возвращает позиции нормализованного слова, параллельные его списку вхождений.
+    // nullptr, если индекс построен без позиций или слова нет
+    const PositionList* FindPositions(const std::string& normalized_word) const;
+
+    // Является ли нормализованное слово стоп-словом текущего индекса
+    bool IsStopword(const std::string& normalized_word) const
+    {
+        return !_stopwords.empty() && _stopwords.count(normalized_word) > 0;
+    }
+
+    // Список вхождений для проверки позиций слов (фразы, NEAR): для стоп-слов - из
+    // дополнительного позиционного индекса, если он построен, иначе то же, что FindPostings
+    const PostingList& FindPositionalPostings(const std::string& normalized_word) const;
+
+    // Построен ли индекс с позициями слов
+    bool HasPositions() const { return _has_positions; }
+
+    // Документы, в которых есть слово, содержащее подстроку (нормализованную без стемминга),
+    // и количество таких слов в документе. Кандидаты берутся из индекса триграмм
+    // (IndexOptions::substrings), если он построен, иначе проверяются все документы
+    std::vector<Entry> FindSubstring(const std::string& normalized_substring) const;
+
+    // Верхняя оценка количества документов FindSubstring без проверки текста
+    size_t EstimateSubstring(const std::string& normalized_substring) const;
+
+    // Построен ли индекс триграмм
+    bool HasSubstrings() const { return _has_substrings; }
+
+    // Индекс удалений слов словаря для подсказок исправлений, пустой без IndexOptions::suggestions
+    const SpellingIndex& GetSpellingIndex() const { return _spelling; }
+
+    // Номер версии индекса, увеличивается при каждом UpdateDocumentBase.
+    // Позволяет кэшам результатов определить, что индекс изменился
+    uint64_t GetVersion() const { return _version; }
+
+    // Написание слова словаря для показа пользователю: со стеммером словарь хранит основы,
+    // поэтому возвращается самое частое написание слова в документах (нормализованное, без
+    // стемминга). Без стеммера и для отсутствующих слов - само normalized_word
+    const std::string& GetSurfaceForm(const std::string& normalized_word) const;
+
+    // Приводит слово к виду, в котором оно хранится в индексе
+    // (нормализация и, если он включен, стемминг)
+    std::string normalizeWord(const std::string& word) const;
+
     size_t GetTotalDocuments() const
     {
         return docs.size();  // docs - это вектор документов
     }
 
+    // Статистика нормализованного слова, нули для отсутствующего слова и стоп-слов
+    TermStats GetTermStats(const std::string& normalized_word) const;
+
+    // Длина документа в словах (нормализованных, включая стоп-слова)
+    size_t GetDocumentLength(size_t doc_id) const { return _doc_lengths[doc_id]; }
+
+    // Средняя длина документа в словах, 0 для пустой базы
+    double GetAverageDocumentLength() const
+    {
+        return docs.empty() ? 0.0 : static_cast<double>(_total_tokens) / static_cast<double>(docs.size());
+    }
+
+    // Количество слов словаря (без стоп-слов)
+    size_t GetVocabularySize() const { return _terms.Size(); }
+
+    // Статистика индекса целиком. Количества собираются при построении индекса,
+    // память считается проходом по спискам слов
+    IndexStats GetIndexStats() const;
+
 private:
 
     std::vector<std::string> docs; // Вектор строк с содержимым документов
 
-    std::map<std::string, std::vector<Entry>> freq_dictionary; // Словарь частот слов в документах
+    std::vector<uint32_t> _doc_lengths; // Длина документа в словах по номеру
 
-    std::string normalizeWord(const std::string& word) const;
+    uint64_t _total_tokens = 0; // Количество слов во всех документах
+
+    TermDictionary _terms; // Словарь слов: слово - плотный номер
+
+    std::vector<PostingList> _postings; // Списки вхождений по номеру слова
+
+    std::vector<PositionList> _positions; // Позиции слов по номеру слова (только при options.positions)
+
+    std::map<std::string, PostingList> stopword_dictionary; // Вхождения стоп-слов для проверки фраз
+
+    std::map<std::string, PositionList> stopword_positions; // Позиции стоп-слов для проверки фраз
+
+    // Триграммы нормализованных слов (три байта в одном числе) - документы по возрастанию
+    std::unordered_map<uint32_t, std::vector<uint32_t>> _trigrams;
+
+    SpellingIndex _spelling; // Удаления слов словаря (только при options.suggestions)
+
+    std::vector<std::string> _surface_forms; // Написания слов по номеру слова (только со стеммером)
+
+    IndexOptions _options; // Настройки построения индекса
+
+    bool _has_positions = false; // Настройка positions, с которой построен текущий индекс
+
+    StemmerType _stemmer = StemmerType::None; // Стеммер, с которым построен текущий индекс
+
+    std::unordered_set<std::string> _stopwords; // Нормализованные стоп-слова текущего индекса
+
+    bool _stopword_positions = false; // Хранятся ли стоп-слова в позиционном индексе
+
+    bool _has_substrings = false; // Настройка substrings, с которой построен текущий индекс
+
+    bool _has_suggestions = false; // Настройка suggestions, с которой построен текущий индекс
+
+    // Документы-кандидаты для подстроки: содержат все ее триграммы
+    std::vector<uint32_t> SubstringCandidates(const std::string& normalized_substring) const;
+
+    // Применяет настройки _options перед построением индекса
+    void ApplyOptions();
+
+    uint64_t _version = 0; // Версия индекса
+
+    IndexingMetrics _metrics; // Показатели последнего построения
+
+    IndexingObserver _observer; // Получатель отчетов о ходе построения
 
+    double _observer_interval = 1.0; // Секунды между отчетами
 
 };
\ No newline at end of file
@@ -0,0 +1,54 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Позиции слова в документах - отдельный от списка вхождений поток данных, чтобы запросы
+// без фраз не читали его из памяти. i-й элемент offsets соответствует i-му вхождению
+// списка (Entry) и указывает начало его позиций в data. Позиции одного документа
+// хранятся разностями соседних значений в кодировке varint (7 бит на байт)
+struct PositionList
+{
+    std::vector<uint32_t> offsets; // Смещение позиций каждого вхождения в data
+
+    std::vector<uint8_t> data; // Сжатые позиции
+};
+
+// Добавляет позиции очередного вхождения (по возрастанию) в конец списка
+inline void AppendPositions(PositionList& list, const std::vector<uint32_t>& positions)
+{
+    list.offsets.push_back(static_cast<uint32_t>(list.data.size()));
+    uint32_t previous = 0;
+    for (uint32_t position : positions)
+    {
+        uint32_t delta = position - previous;
+        previous = position;
+        while (delta >= 0x80)
+        {
+            list.data.push_back(static_cast<uint8_t>(delta | 0x80));
+            delta >>= 7;
+        }
+        list.data.push_back(static_cast<uint8_t>(delta));
+    }
+}
+
+// Распаковывает count позиций вхождения с номером ordinal в out
+inline void DecodePositions(const PositionList& list, size_t ordinal, size_t count, std::vector<uint32_t>& out)
+{
+    out.clear();
+    const uint8_t* data = list.data.data() + list.offsets[ordinal];
+    uint32_t position = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        uint32_t delta = 0;
+        int shift = 0;
+        while (*data & 0x80)
+        {
+            delta |= static_cast<uint32_t>(*data++ & 0x7F) << shift;
+            shift += 7;
+        }
+        delta |= static_cast<uint32_t>(*data++) << shift;
+        position += delta;
+        out.push_back(position);
+    }
+}
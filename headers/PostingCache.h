@@ -0,0 +1,102 @@
+#pragma once
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include "InvertedIndex.h"
+
+// Пересечение списков вхождений двух слов: вхождения каждого слова только в общих документах.
+// Порядок и количества вхождений те же, что в исходных списках
+struct PairPostings
+{
+    PostingList first;
+
+    PostingList second;
+};
+
+// Статистика кэша пересечений
+struct PostingCacheStats
+{
+    uint64_t hits = 0;       // Пересечения, найденные в кэше
+
+    uint64_t misses = 0;     // Пересечения, вычисленные заново
+
+    uint64_t insertions = 0; // Добавленные пересечения
+
+    uint64_t evictions = 0;  // Вытесненные при нехватке памяти пересечения
+
+    uint64_t rejected = 0;   // Пересечения, не поместившиеся в бюджет целиком
+
+    size_t entries = 0;      // Количество пересечений в кэше
+
+    size_t bytes = 0;        // Занятая пересечениями память
+};
+
+// Кэш пересечений списков вхождений пар частых слов для запросов в режиме "все слова".
+// Списки вхождений хранятся в памяти в распакованном виде, поэтому кэшируются не сами списки,
+// а результаты самой дорогой части пересечения - двух самых коротких списков запроса.
+// Объем ограничен бюджетом памяти в байтах, вытесняются давно не использованные пересечения.
+// Пересечения коротких списков (короче min_length) дешевле вычислить, чем хранить, - они не кэшируются.
+// Потокобезопасен: пересечение вычисляется вне блокировки, а выданные указатели остаются
+// действительными и после вытеснения
+class PostingCache
+{
+public:
+    // Пересечения списков короче этого не кэшируются
+    static constexpr size_t DEFAULT_MIN_LENGTH = 1024;
+
+    // budget_bytes - наибольший объем памяти под пересечения, 0 - кэш отключен
+    explicit PostingCache(size_t budget_bytes = 0, size_t min_length = DEFAULT_MIN_LENGTH);
+
+    // Меняет бюджет памяти, содержимое сбрасывается.
+    // Нельзя вызывать одновременно с Intersect
+    void SetBudget(size_t budget_bytes);
+
+    size_t GetBudget() const { return _budget; }
+
+    // Возвращает пересечение списков вхождений двух нормализованных слов индекса index,
+    // вычисляя его при отсутствии в кэше. nullptr - пересечение кэшировать невыгодно
+    // (кэш отключен или один из списков короче min_length)
+    std::shared_ptr<const PairPostings> Intersect(const InvertedIndex& index,
+                                                  const std::string& first, const std::string& second);
+
+    // Удаляет все пересечения, статистика сохраняется
+    void Clear();
+
+    PostingCacheStats GetStats() const;
+
+private:
+    struct Item
+    {
+        std::string key;
+
+        std::shared_ptr<const PairPostings> postings;
+
+        size_t bytes;
+    };
+
+    // Объем памяти, который учитывается за пересечение
+    static size_t Footprint(const std::string& key, const PairPostings& postings);
+
+    // Пересекает списки вхождений галопирующим поиском
+    static PairPostings Compute(const PostingList& first, const PostingList& second);
+
+    // Вытесняет давно не использованные пересечения, пока объем больше бюджета
+    void Shrink();
+
+    size_t _budget;
+
+    size_t _min_length;
+
+    mutable std::mutex _mutex;
+
+    uint64_t _version = 0; // Версия индекса, по которой вычислены пересечения
+
+    std::list<Item> _items; // От недавно использованных к давно не использованным
+
+    std::unordered_map<std::string, std::list<Item>::iterator> _positions;
+
+    PostingCacheStats _stats;
+};
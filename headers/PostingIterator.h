@@ -0,0 +1,176 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <vector>
+#include "InvertedIndex.h"
+#include "QueryProfile.h"
+
+// Значение Doc() у итератора, дошедшего до конца списка
+constexpr size_t END_DOC = std::numeric_limits<size_t>::max();
+
+// Итератор по списку вхождений слова (posting list), хранящемуся как вектор Entry.
+// Вхождения упорядочены по возрастанию doc_id
+class EntryPostingIterator
+{
+public:
+    explicit EntryPostingIterator(const PostingList& postings)
+        : EntryPostingIterator(postings, postings.entries.size()) {}
+
+    // Итератор по части списка вхождений слова (например, по пересечению с другим списком).
+    // document_frequency - документная частота слова во всем индексе, от нее зависит вес слова
+    EntryPostingIterator(const PostingList& postings, size_t document_frequency)
+        : _begin(postings.entries.data()), _pos(postings.entries.data()),
+          _end(postings.entries.data() + postings.entries.size()), _max_count(postings.max_count),
+          _document_frequency(document_frequency) {}
+
+    // Идентификатор текущего документа или END_DOC
+    size_t Doc() const { return _pos != _end ? _pos->doc_id : END_DOC; }
+
+    // Количество вхождений слова в текущий документ
+    size_t Count() const { return _pos->count; }
+
+    bool AtEnd() const { return _pos == _end; }
+
+    // Количество документов, содержащих слово (документная частота)
+    size_t Size() const { return _document_frequency; }
+
+    // Максимальное количество вхождений слова в один документ по всему списку
+    size_t MaxCount() const { return _max_count; }
+
+    // Номер текущего вхождения в списке (для поиска его позиций в PositionList)
+    size_t Ordinal() const { return static_cast<size_t>(_pos - _begin); }
+
+    void Next() { ++_pos; }
+
+    // Переходит к первому документу с doc_id >= target.
+    // Галопирующий поиск: шаг удваивается, пока не перескочит target, затем двоичный поиск
+    void Advance(size_t target)
+    {
+        if (_pos == _end || _pos->doc_id >= target)
+        {
+            return;
+        }
+        size_t step = 1;
+        const Entry* low = _pos;
+        while (static_cast<size_t>(_end - low) > step && low[step].doc_id < target)
+        {
+            low += step;
+            step *= 2;
+        }
+        const Entry* high = static_cast<size_t>(_end - low) > step ? low + step + 1 : _end;
+        _pos = std::lower_bound(low, high, target, [](const Entry& entry, size_t doc)
+        {
+            return entry.doc_id < doc;
+        });
+    }
+
+private:
+    const Entry* _begin;
+    const Entry* _pos;
+    const Entry* _end;
+    size_t _max_count;
+    size_t _document_frequency;
+};
+
+// Итератор по списку вхождений с пропуском блоков (Block-Max).
+// Помимо операций EntryPostingIterator позволяет "поверхностно" перейти к блоку,
+// содержащему документ, не просматривая вхождения, и узнать максимальное количество
+// вхождений слова в этом блоке. Считает количество просмотренных вхождений
+class BlockPostingIterator
+{
+public:
+    explicit BlockPostingIterator(const PostingList& postings)
+        : _entries(postings.entries.data()), _size(postings.entries.size()),
+          _blocks(postings.blocks.data()), _block_count(postings.blocks.size()),
+          _max_count(postings.max_count), _decoded(_size ? 1 : 0) {}
+
+    // Идентификатор текущего документа или END_DOC
+    size_t Doc() const { return _pos < _size ? _entries[_pos].doc_id : END_DOC; }
+
+    // Количество вхождений слова в текущий документ
+    size_t Count() const { return _entries[_pos].count; }
+
+    bool AtEnd() const { return _pos >= _size; }
+
+    // Количество документов, содержащих слово (документная частота)
+    size_t Size() const { return _size; }
+
+    // Максимальное количество вхождений слова в один документ по всему списку
+    size_t MaxCount() const { return _max_count; }
+
+    void Next()
+    {
+        ++_pos;
+        _decoded += _pos < _size;
+        if (_block < _pos / POSTING_BLOCK_SIZE)
+        {
+            _block = _pos / POSTING_BLOCK_SIZE;
+        }
+    }
+
+    // Переходит к первому документу с doc_id >= target
+    void Advance(size_t target)
+    {
+        if (_pos >= _size || _entries[_pos].doc_id >= target)
+        {
+            return;
+        }
+        ShallowAdvance(target);
+        if (_block >= _block_count)
+        {
+            _pos = _size;
+            return;
+        }
+        // Блоки до текущего пропущены целиком, двоичный поиск только внутри блока
+        const size_t begin = std::max(_pos, _block * POSTING_BLOCK_SIZE);
+        const size_t end = std::min(_size, (_block + 1) * POSTING_BLOCK_SIZE);
+        const Entry* found = std::lower_bound(_entries + begin, _entries + end, target,
+                                              [](const Entry& entry, size_t doc) { return entry.doc_id < doc; });
+        _pos = static_cast<size_t>(found - _entries);
+        ++_decoded;
+    }
+
+    // Переходит к блоку, который может содержать target, не просматривая вхождения.
+    // Текущий документ не меняется
+    void ShallowAdvance(size_t target)
+    {
+        while (_block < _block_count && _blocks[_block].last_doc < target)
+        {
+            ++_block;
+        }
+    }
+
+    // Максимальное количество вхождений в текущем блоке (0, если блоки закончились)
+    size_t BlockMaxCount() const { return _block < _block_count ? _blocks[_block].max_count : 0; }
+
+    // Последний документ текущего блока (END_DOC, если блоки закончились)
+    size_t BlockLastDoc() const { return _block < _block_count ? _blocks[_block].last_doc : END_DOC; }
+
+    // Количество просмотренных (декодированных) вхождений
+    size_t Decoded() const { return _decoded; }
+
+private:
+    const Entry* _entries;
+    size_t _size;
+    const PostingBlock* _blocks;
+    size_t _block_count;
+    size_t _max_count;
+    size_t _pos = 0;
+    size_t _block = 0;
+    size_t _decoded;
+};
+
+// Создает итераторы по спискам вхождений нормализованных слов запроса
+template <typename Iterator>
+std::vector<Iterator> MakeIterators(const InvertedIndex& index, const std::vector<std::string>& terms)
+{
+    QUERY_PHASE(Lookup);
+    std::vector<Iterator> iterators;
+    iterators.reserve(terms.size());
+    for (const auto& term : terms)
+    {
+        iterators.emplace_back(index.FindPostings(term));
+    }
+    return iterators;
+}
@@ -0,0 +1,490 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <utility>
+#include <vector>
+#include "PostingIterator.h"
+#include "QueryProfile.h"
+
+// Документ из ответа на запрос и его относительная релевантность
+struct RelativeIndex
+{
+    size_t doc_id;
+    float rank;
+
+    bool operator ==(const RelativeIndex& other) const
+    {
+        return (doc_id == other.doc_id && rank == other.rank);
+    }
+};
+
+// Порядок документов в ответе: сначала более релевантные, при равенстве - по возрастанию doc_id
+inline bool RelativeIndexLess(const RelativeIndex& a, const RelativeIndex& b)
+{
+    const float EPS = 1e-6; // Погрешность = 0.000001
+    if (std::abs(a.rank - b.rank) > EPS)
+    {
+        return a.rank > b.rank; // Сначала более релевантные
+    }
+    return a.doc_id < b.doc_id; // При равенстве - по возрастанию doc_id
+}
+
+// Переводит абсолютную релевантность отобранных документов {doc_id, релевантность}
+// в относительную и сортирует их
+template <typename ScoreType>
+std::vector<RelativeIndex> RankCandidates(const std::vector<std::pair<size_t, ScoreType>>& candidates)
+{
+    QUERY_PHASE(Rank);
+    std::vector<RelativeIndex> result;
+    if (candidates.empty())
+    {
+        return result;
+    }
+    ScoreType max_score = candidates.front().second;
+    for (const auto& candidate : candidates)
+    {
+        max_score = std::max(max_score, candidate.second);
+    }
+    const float max_relevance = static_cast<float>(max_score);
+
+    result.reserve(candidates.size());
+    for (const auto& [doc_id, score] : candidates)
+    {
+        result.emplace_back(RelativeIndex{ doc_id, static_cast<float>(score) / max_relevance });
+    }
+    std::sort(result.begin(), result.end(), RelativeIndexLess);
+    return result;
+}
+
+// Отбор limit документов с наибольшей абсолютной релевантностью при обходе "документ за документом".
+// Документы должны поступать по возрастанию doc_id: при равной релевантности
+// новый документ хуже уже отобранного и не вытесняет его
+template <typename ScoreType>
+class TopKCollector
+{
+public:
+    explicit TopKCollector(size_t limit) : _limit(limit) { _top.reserve(limit); }
+
+    // Предлагает документ, возвращает true, если он попал в число отобранных
+    bool Push(size_t doc_id, ScoreType score)
+    {
+        ++_pushed;
+        if (_top.size() < _limit)
+        {
+            _top.emplace_back(doc_id, score);
+            std::push_heap(_top.begin(), _top.end(), Worse);
+            return true;
+        }
+        if (_limit == 0 || !(score > _top.front().second))
+        {
+            return false;
+        }
+        std::pop_heap(_top.begin(), _top.end(), Worse);
+        _top.back() = { doc_id, score };
+        std::push_heap(_top.begin(), _top.end(), Worse);
+        return true;
+    }
+
+    // Релевантность, которую нужно превысить, чтобы попасть в число отобранных
+    double Threshold() const
+    {
+        return _top.size() < _limit || _limit == 0 ? 0.0 : static_cast<double>(_top.front().second);
+    }
+
+    // Отобранные документы, отсортированные по относительной релевантности
+    std::vector<RelativeIndex> Rank() const
+    {
+        TraceDocumentsScored(_pushed);
+        return RankCandidates(_top);
+    }
+
+private:
+    // На вершине кучи - худший из отобранных документов
+    static bool Worse(const std::pair<size_t, ScoreType>& a, const std::pair<size_t, ScoreType>& b)
+    {
+        return a.second > b.second || (a.second == b.second && a.first < b.first);
+    }
+
+    size_t _limit;
+    std::vector<std::pair<size_t, ScoreType>> _top;
+    size_t _pushed = 0; // Предложенные документы - их релевантность подсчитана
+};
+
+// Переводит абсолютную релевантность документов в относительную
+// и оставляет не более limit наиболее релевантных документов
+template <typename ScoreType>
+std::vector<RelativeIndex> RankDocuments(const std::vector<ScoreType>& absolute_relevance, size_t limit)
+{
+    QUERY_PHASE(Rank);
+    std::vector<RelativeIndex> result;
+
+    // Самый релевантный докуммент
+    const auto max_it = std::max_element(absolute_relevance.begin(), absolute_relevance.end());
+    if (max_it == absolute_relevance.end() || !(*max_it > ScoreType{}))
+    {
+        return result;
+    }
+    // Сохраняем для нормализации
+    const float max_relevance = static_cast<float>(*max_it);
+
+    for (size_t doc_id = 0; doc_id < absolute_relevance.size(); ++doc_id)
+    {
+        if (absolute_relevance[doc_id] > ScoreType{})
+        {
+            result.emplace_back(RelativeIndex{ doc_id, static_cast<float>(absolute_relevance[doc_id]) / max_relevance });
+        }
+    }
+    TraceDocumentsScored(result.size());
+    // Полностью сортировать нужно только первые limit документов
+    const size_t top = std::min(limit, result.size());
+    std::partial_sort(result.begin(), result.begin() + top, result.end(), RelativeIndexLess);
+    result.resize(top);
+    return result;
+}
+
+// Исчерпывающая обработка запроса: все вхождения всех слов запроса суммируются
+// в массив абсолютной релевантности.
+// Scorer и Iterator - параметры шаблона, поэтому для каждой комбинации функции ранжирования
+// и формата списков вхождений компилятор строит отдельный цикл без виртуальных вызовов
+template <typename Scorer, typename Iterator>
+std::vector<RelativeIndex> EvaluateExhaustive(std::vector<Iterator>& iterators, const Scorer& scorer,
+                                              size_t total_docs, size_t limit)
+{
+    using score_type = typename Scorer::score_type;
+    std::vector<score_type> absolute_relevance(total_docs, score_type{});
+
+    for (auto& it : iterators)
+    {
+        const double weight = scorer.TermWeight(it.Size(), total_docs); // Вес слова считаем один раз
+        for (; !it.AtEnd(); it.Next())
+        {
+            absolute_relevance[it.Doc()] += scorer.Score(weight, it.Count());
+        }
+    }
+    return RankDocuments(absolute_relevance, limit);
+}
+
+// Обработка запроса "документ за документом" с динамическим отсечением MaxScore.
+// Для каждого слова известна верхняя граница его вклада. Слова упорядочиваются по возрастанию
+// границы; слова, сумма границ которых не превышает порог (релевантность худшего из limit лучших
+// найденных документов), становятся "необязательными": документ, в котором есть только они,
+// в ответ не попадет. Кандидаты берутся только из списков обязательных слов, а списки
+// необязательных слов проверяются переходом Advance к кандидату, пока это может изменить результат.
+// Возвращает те же limit документов, что и EvaluateExhaustive (для вещественных функций
+// ранжирования - с точностью до документов, релевантность которых отличается меньше, чем на EPS).
+// Документы, найденные в списках excluded (если они заданы), в ответ не попадают.
+template <typename Scorer, typename Iterator>
+std::vector<RelativeIndex> EvaluateMaxScore(std::vector<Iterator>& iterators, const Scorer& scorer,
+                                            size_t total_docs, size_t limit,
+                                            std::vector<Iterator>* excluded = nullptr)
+{
+    using score_type = typename Scorer::score_type;
+
+    // Слово запроса: итератор, его вес и верхняя граница вклада
+    struct Term
+    {
+        Iterator* it;
+        double weight;
+        double upper_bound;
+    };
+    std::vector<Term> terms;
+    terms.reserve(iterators.size());
+    for (auto& it : iterators)
+    {
+        if (it.AtEnd())
+        {
+            continue;
+        }
+        const double weight = scorer.TermWeight(it.Size(), total_docs);
+        terms.push_back(Term{ &it, weight, static_cast<double>(scorer.Score(weight, it.MaxCount())) });
+    }
+    if (limit == 0 || terms.empty())
+    {
+        return {};
+    }
+    std::sort(terms.begin(), terms.end(), [](const Term& a, const Term& b) { return a.upper_bound < b.upper_bound; });
+
+    // prefix_bound[i] - сумма верхних границ слов 0..i
+    std::vector<double> prefix_bound(terms.size());
+    double bound_sum = 0;
+    for (size_t i = 0; i < terms.size(); ++i)
+    {
+        bound_sum += terms[i].upper_bound;
+        prefix_bound[i] = bound_sum;
+    }
+
+    TopKCollector<score_type> top(limit);
+    double threshold = 0;        // Релевантность, которую нужно превысить, чтобы попасть в ответ
+    size_t first_essential = 0;  // Слова с меньшим номером - необязательные
+
+    // Наименьший текущий документ среди списков обязательных слов
+    const auto next_candidate = [&]()
+    {
+        size_t doc = END_DOC;
+        for (size_t i = first_essential; i < terms.size(); ++i)
+        {
+            doc = std::min(doc, terms[i].it->Doc());
+        }
+        return doc;
+    };
+
+    size_t doc = next_candidate();
+    while (doc != END_DOC)
+    {
+        // Считаем вклад обязательных слов и одновременно находим следующего кандидата
+        score_type score{};
+        size_t next_doc = END_DOC;
+        for (size_t i = first_essential; i < terms.size(); ++i)
+        {
+            Iterator& it = *terms[i].it;
+            if (it.Doc() == doc)
+            {
+                score += scorer.Score(terms[i].weight, it.Count());
+                it.Next();
+            }
+            next_doc = std::min(next_doc, it.Doc());
+        }
+        const size_t candidate = doc;
+        doc = next_doc;
+
+        // Исключенные документы пропускаем переходом по спискам исключений
+        if (excluded && std::any_of(excluded->begin(), excluded->end(), [candidate](Iterator& it)
+            {
+                it.Advance(candidate);
+                return it.Doc() == candidate;
+            }))
+        {
+            continue;
+        }
+
+        // Необязательные слова проверяем от самого весомого, пока документ может превысить порог
+        bool pruned = false;
+        for (size_t i = first_essential; i-- > 0;)
+        {
+            if (static_cast<double>(score) + prefix_bound[i] <= threshold)
+            {
+                pruned = true;
+                break;
+            }
+            terms[i].it->Advance(candidate);
+            if (terms[i].it->Doc() == candidate)
+            {
+                score += scorer.Score(terms[i].weight, terms[i].it->Count());
+            }
+        }
+        if (pruned)
+        {
+            continue;
+        }
+
+        if (!top.Push(candidate, score))
+        {
+            continue;
+        }
+        if (top.Threshold() > threshold)
+        {
+            // Порог вырос - часть слов может стать необязательной
+            threshold = top.Threshold();
+            const size_t old_first_essential = first_essential;
+            while (first_essential < terms.size() && prefix_bound[first_essential] <= threshold)
+            {
+                ++first_essential;
+            }
+            if (first_essential != old_first_essential)
+            {
+                doc = next_candidate(); // Кандидаты теперь берутся из меньшего набора списков
+            }
+        }
+    }
+    return top.Rank();
+}
+
+// Обработка запроса алгоритмом Block-Max WAND.
+// Слова упорядочиваются по текущему документу; опорный документ - первый, на котором сумма
+// глобальных верхних границ слов превышает порог. Затем для блоков, содержащих опорный документ,
+// складываются блочные верхние границы: если и они не превышают порог, все документы до конца
+// ближайшего из этих блоков пропускаются без просмотра вхождений.
+// Iterator должен поддерживать ShallowAdvance, BlockMaxCount и BlockLastDoc (BlockPostingIterator).
+// Возвращает те же limit документов, что и EvaluateExhaustive (для вещественных функций
+// ранжирования - с точностью до документов, релевантность которых отличается меньше, чем на EPS)
+template <typename Scorer, typename Iterator>
+std::vector<RelativeIndex> EvaluateBlockMaxWand(std::vector<Iterator>& iterators, const Scorer& scorer,
+                                                size_t total_docs, size_t limit)
+{
+    using score_type = typename Scorer::score_type;
+
+    // Слово запроса: итератор, его вес и верхняя граница вклада
+    struct Term
+    {
+        Iterator* it;
+        double weight;
+        double upper_bound;
+    };
+    std::vector<Term> terms;
+    terms.reserve(iterators.size());
+    for (auto& it : iterators)
+    {
+        if (it.AtEnd())
+        {
+            continue;
+        }
+        const double weight = scorer.TermWeight(it.Size(), total_docs);
+        terms.push_back(Term{ &it, weight, static_cast<double>(scorer.Score(weight, it.MaxCount())) });
+    }
+    if (limit == 0 || terms.empty())
+    {
+        return {};
+    }
+
+    TopKCollector<score_type> top(limit);
+    double threshold = 0; // Релевантность, которую нужно превысить, чтобы попасть в ответ
+
+    const auto by_doc = [](const Term& a, const Term& b) { return a.it->Doc() < b.it->Doc(); };
+    std::sort(terms.begin(), terms.end(), by_doc);
+
+    while (!terms.empty())
+    {
+        // Опорное слово: первое, на котором сумма глобальных границ превышает порог
+        double bound_sum = 0;
+        size_t pivot = 0;
+        for (; pivot < terms.size(); ++pivot)
+        {
+            bound_sum += terms[pivot].upper_bound;
+            if (bound_sum > threshold)
+            {
+                break;
+            }
+        }
+        if (pivot == terms.size())
+        {
+            break; // Ни один из оставшихся документов не попадет в ответ
+        }
+        const size_t pivot_doc = terms[pivot].it->Doc();
+        // Слова, стоящие на том же документе, что и опорное, тоже участвуют в оценке
+        while (pivot + 1 < terms.size() && terms[pivot + 1].it->Doc() == pivot_doc)
+        {
+            ++pivot;
+        }
+
+        // Сумма блочных верхних границ для блоков, содержащих pivot_doc
+        double block_bound = 0;
+        for (size_t i = 0; i <= pivot; ++i)
+        {
+            terms[i].it->ShallowAdvance(pivot_doc);
+            block_bound += static_cast<double>(scorer.Score(terms[i].weight, terms[i].it->BlockMaxCount()));
+        }
+
+        if (block_bound > threshold)
+        {
+            if (terms.front().it->Doc() == pivot_doc)
+            {
+                // Все слова до опорного стоят на pivot_doc - считаем полную релевантность документа
+                score_type score{};
+                for (size_t i = 0; i <= pivot; ++i)
+                {
+                    score += scorer.Score(terms[i].weight, terms[i].it->Count());
+                    terms[i].it->Next();
+                }
+                if (top.Push(pivot_doc, score))
+                {
+                    threshold = top.Threshold();
+                }
+            }
+            else
+            {
+                // Документы до pivot_doc не могут превысить порог по глобальным границам
+                for (size_t i = 0; i < pivot && terms[i].it->Doc() < pivot_doc; ++i)
+                {
+                    terms[i].it->Advance(pivot_doc);
+                }
+            }
+        }
+        else
+        {
+            // Ни один документ до конца ближайшего блока не превысит порог - пропускаем их
+            size_t next_doc = pivot + 1 < terms.size() ? terms[pivot + 1].it->Doc() : END_DOC;
+            for (size_t i = 0; i <= pivot; ++i)
+            {
+                const size_t block_last = terms[i].it->BlockLastDoc();
+                next_doc = std::min(next_doc, block_last == END_DOC ? END_DOC : block_last + 1);
+            }
+            for (size_t i = 0; i <= pivot; ++i)
+            {
+                terms[i].it->Advance(next_doc);
+            }
+        }
+        terms.erase(std::remove_if(terms.begin(), terms.end(), [](const Term& term) { return term.it->AtEnd(); }),
+                    terms.end());
+        std::sort(terms.begin(), terms.end(), by_doc);
+    }
+    return top.Rank();
+}
+
+// Обработка запроса в режиме "все слова" (конъюнкция).
+// Списки вхождений пересекаются, начиная с самого короткого: его документы - кандидаты,
+// остальные списки догоняют кандидата галопирующим переходом Advance; если какой-то список
+// перескочил кандидата, короткий список догоняет уже его документ. Релевантность считается
+// только для документов, содержащих все слова запроса
+template <typename Scorer, typename Iterator>
+std::vector<RelativeIndex> EvaluateConjunctive(std::vector<Iterator>& iterators, const Scorer& scorer,
+                                               size_t total_docs, size_t limit)
+{
+    using score_type = typename Scorer::score_type;
+    if (limit == 0 || iterators.empty())
+    {
+        return {};
+    }
+
+    std::vector<Iterator*> lists;
+    std::vector<double> weights;
+    lists.reserve(iterators.size());
+    for (auto& it : iterators)
+    {
+        if (it.AtEnd())
+        {
+            return {}; // Слова нет ни в одном документе - пересечение пусто
+        }
+        lists.push_back(&it);
+    }
+    std::sort(lists.begin(), lists.end(), [](const Iterator* a, const Iterator* b) { return a->Size() < b->Size(); });
+    weights.reserve(lists.size());
+    for (const Iterator* it : lists)
+    {
+        weights.push_back(scorer.TermWeight(it->Size(), total_docs));
+    }
+
+    TopKCollector<score_type> top(limit);
+    Iterator& shortest = *lists.front();
+    size_t doc = shortest.Doc();
+    while (doc != END_DOC)
+    {
+        // Догоняем кандидата всеми остальными списками
+        size_t i = 1;
+        for (; i < lists.size(); ++i)
+        {
+            lists[i]->Advance(doc);
+            if (lists[i]->Doc() != doc)
+            {
+                break;
+            }
+        }
+        if (i < lists.size())
+        {
+            // Список перескочил кандидата - следующий кандидат не меньше его документа
+            shortest.Advance(lists[i]->Doc());
+            doc = shortest.Doc();
+            continue;
+        }
+
+        score_type score{};
+        for (size_t j = 0; j < lists.size(); ++j)
+        {
+            score += scorer.Score(weights[j], lists[j]->Count());
+        }
+        top.Push(doc, score);
+        shortest.Next();
+        doc = shortest.Doc();
+    }
+    return top.Rank();
+}
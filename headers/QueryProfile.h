@@ -0,0 +1,209 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <nlohmann/json_fwd.hpp>
+
+// Профиль обработки запросов: время каждого этапа собирается в гистограммы задержек.
+// Гистограммы ведутся отдельно в каждом потоке (запись без блокировок и общих строк кэша)
+// и складываются при выгрузке. Сбор включается при сборке опцией SEARCH_ENGINE_PROFILING;
+// без нее таймеры этапов (QUERY_PHASE) не компилируются вовсе
+
+// Этапы обработки запроса
+enum class QueryPhase
+{
+    Parse,    // Разбор строки запроса (SearchServer::Compile)
+    Lookup,   // Поиск списков вхождений слов в индексе
+    Evaluate, // Обход списков вхождений и подсчет релевантности - при обходе "документ
+              // за документом" они чередуются, поэтому измеряются вместе
+    Rank,     // Отбор и сортировка лучших документов
+    Output,   // Подсказки и запись answers.json при обработке пакета запросов
+    Query,    // Выполнение запроса целиком, включая кэш результатов (без разбора)
+    Count
+};
+
+constexpr size_t QUERY_PHASE_COUNT = static_cast<size_t>(QueryPhase::Count);
+
+// Название этапа в выгрузке профиля
+const char* QueryPhaseName(QueryPhase phase);
+
+#ifdef SEARCH_ENGINE_PROFILING
+constexpr bool QUERY_PROFILING_ENABLED = true;
+#else
+constexpr bool QUERY_PROFILING_ENABLED = false;
+#endif
+
+// Гистограмма задержек в наносекундах в духе HdrHistogram: значения до 127 хранятся точно,
+// дальше каждый диапазон [2^k, 2^(k+1)) делится на 64 равные корзины - относительная погрешность
+// не больше 1/64 при фиксированных 16 КБ памяти. Значения больше MAX_VALUE (около 137 с)
+// попадают в последнюю корзину, точный максимум хранится отдельно.
+// Запись - из одного потока; читать (Count, Percentile, Add в другую гистограмму) можно
+// из любого потока одновременно с записью
+class LatencyHistogram
+{
+public:
+    static constexpr int SUB_BUCKET_BITS = 6;
+
+    static constexpr size_t SUB_BUCKETS = size_t{ 1 } << SUB_BUCKET_BITS;
+
+    static constexpr size_t BUCKETS = 2048;
+
+    static constexpr uint64_t MAX_VALUE = (uint64_t{ 2 } << (BUCKETS / SUB_BUCKETS - 2)) * SUB_BUCKETS - 1;
+
+    LatencyHistogram() = default;
+
+    LatencyHistogram(const LatencyHistogram& other) { Add(other); }
+
+    LatencyHistogram& operator=(const LatencyHistogram& other);
+
+    // Добавляет значение. Только из потока-владельца гистограммы
+    void Record(uint64_t value);
+
+    // Добавляет значения другой гистограммы
+    void Add(const LatencyHistogram& other);
+
+    void Clear();
+
+    uint64_t Count() const { return _count.load(std::memory_order_relaxed); }
+
+    uint64_t Min() const { return Count() == 0 ? 0 : _min.load(std::memory_order_relaxed); }
+
+    uint64_t Max() const { return _max.load(std::memory_order_relaxed); }
+
+    double Mean() const;
+
+    // Значение, не меньше которого доля q (от 0 до 1) значений: наибольшее значение корзины,
+    // но не больше максимума. 0 для пустой гистограммы
+    uint64_t Percentile(double q) const;
+
+    // {"count", "mean_ns", "min_ns", "p50_ns", "p90_ns", "p99_ns", "p999_ns", "max_ns", "buckets"},
+    // buckets - непустые корзины [наибольшее значение корзины, количество] для объединения выгрузок
+    nlohmann::ordered_json ToJson() const;
+
+    // Номер корзины значения и наибольшее значение корзины
+    static size_t BucketIndex(uint64_t value);
+
+    static uint64_t BucketValue(size_t index);
+
+private:
+    std::array<std::atomic<uint64_t>, BUCKETS> _counts{};
+
+    std::atomic<uint64_t> _count{ 0 };
+
+    std::atomic<uint64_t> _sum{ 0 };
+
+    std::atomic<uint64_t> _min{ UINT64_MAX };
+
+    std::atomic<uint64_t> _max{ 0 };
+};
+
+// Сведения о выполнении одного запроса для журнала медленных запросов (SlowQueryLog).
+// Собираются, пока указатель на них установлен в ActiveQueryTrace() потока, выполняющего запрос
+struct QueryTrace
+{
+    // Собственное время этапов, как в гистограммах (только со сборкой SEARCH_ENGINE_PROFILING)
+    std::array<uint64_t, QUERY_PHASE_COUNT> phase_ns{};
+
+    size_t docs_scored = 0; // Документы, релевантность которых подсчитана полностью
+
+    const char* strategy = ""; // Физический оператор, выполнивший запрос
+};
+
+// Сведения о запросе, который выполняет текущий поток, или nullptr
+inline QueryTrace*& ActiveQueryTrace()
+{
+    thread_local QueryTrace* trace = nullptr;
+    return trace;
+}
+
+// Учитывает документы, релевантность которых подсчитана, в сведениях о текущем запросе
+inline void TraceDocumentsScored(size_t count)
+{
+    if (QueryTrace* trace = ActiveQueryTrace())
+    {
+        trace->docs_scored += count;
+    }
+}
+
+// Запоминает физический оператор текущего запроса (строковая константа)
+inline void TraceStrategy(const char* strategy)
+{
+    if (QueryTrace* trace = ActiveQueryTrace())
+    {
+        trace->strategy = strategy;
+    }
+}
+
+// Добавляет время этапа в гистограмму текущего потока и в сведения о текущем запросе
+void RecordQueryPhase(QueryPhase phase, uint64_t nanoseconds);
+
+// Гистограмма этапа, сложенная по всем потокам, в том числе завершившимся
+LatencyHistogram GetQueryPhaseHistogram(QueryPhase phase);
+
+// Профиль всех этапов: {"profiling": включен ли сбор, "threads": потоки с записями, "phases": {...}}
+nlohmann::ordered_json DumpQueryProfile();
+
+// Сбрасывает гистограммы всех потоков
+void ResetQueryProfile();
+
+// Записывает профиль в файл path при завершении программы (std::exit или возврат из main)
+void WriteQueryProfileAtExit(const std::string& path);
+
+// Таймер этапа: время от создания до уничтожения добавляется в гистограмму этапа.
+// Таймеры вкладываются друг в друга, и этап получает только собственное время - без времени
+// вложенных этапов, поэтому сумма этапов равна общему времени. Исключение - QueryPhase::Query:
+// время запроса целиком. Таймер внутри таймера того же этапа ничего не записывает
+class PhaseTimer
+{
+public:
+    explicit PhaseTimer(QueryPhase phase)
+        : _phase(phase), _parent(_current), _start(std::chrono::steady_clock::now())
+    {
+        _current = this;
+    }
+
+    ~PhaseTimer()
+    {
+        const uint64_t elapsed = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - _start).count());
+        _current = _parent;
+        if (_parent && _parent->_phase == _phase)
+        {
+            return; // Вложенный таймер того же этапа - время учтет внешний
+        }
+        if (_parent)
+        {
+            _parent->_children += elapsed;
+        }
+        RecordQueryPhase(_phase, _phase == QueryPhase::Query ? elapsed : elapsed - std::min(_children, elapsed));
+    }
+
+    PhaseTimer(const PhaseTimer&) = delete;
+
+    PhaseTimer& operator=(const PhaseTimer&) = delete;
+
+private:
+    QueryPhase _phase;
+
+    PhaseTimer* _parent; // Внешний таймер этого потока
+
+    std::chrono::steady_clock::time_point _start;
+
+    uint64_t _children = 0; // Время вложенных таймеров
+
+    inline static thread_local PhaseTimer* _current = nullptr; // Самый вложенный таймер потока
+};
+
+#define QUERY_PHASE_CONCAT_IMPL(a, b) a##b
+#define QUERY_PHASE_CONCAT(a, b) QUERY_PHASE_CONCAT_IMPL(a, b)
+
+// Измеряет время до конца блока как этап QueryPhase::phase
+#ifdef SEARCH_ENGINE_PROFILING
+#define QUERY_PHASE(phase) const PhaseTimer QUERY_PHASE_CONCAT(query_phase_timer_, __LINE__)(QueryPhase::phase)
+#else
+#define QUERY_PHASE(phase) static_cast<void>(0)
+#endif
@@ -0,0 +1,114 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "QueryEvaluator.h"
+
+// Статистика кэша результатов
+struct ResultCacheStats
+{
+    uint64_t hits = 0;          // Найденные в кэше ответы
+
+    uint64_t misses = 0;        // Запросы, которых не было в кэше
+
+    uint64_t insertions = 0;    // Добавленные ответы
+
+    uint64_t evictions = 0;     // Вытесненные при нехватке места ответы
+
+    uint64_t invalidations = 0; // Сбросы сегментов кэша из-за смены версии индекса
+
+    size_t size = 0;            // Текущее количество ответов в кэше
+};
+
+// Ограниченный потокобезопасный кэш ответов на запросы.
+// Вытеснение - сегментированный LRU (SLRU): новый ответ попадает в испытательную часть
+// и переходит в защищенную только при повторном обращении. Поток разовых запросов
+// вытесняет лишь испытательную часть и не трогает популярные запросы.
+// Ключи распределены по независимым сегментам (shard) со своими мьютексами, чтобы
+// параллельные запросы не конкурировали за одну блокировку.
+// Каждый ответ помечен версией индекса: при смене версии сегмент очищается при первом обращении
+class ResultCache
+{
+public:
+    // capacity - наибольшее количество ответов в кэше, 0 - кэш отключен
+    explicit ResultCache(size_t capacity = 0);
+
+    // Меняет емкость кэша, содержимое сбрасывается.
+    // Нельзя вызывать одновременно с Get/Put
+    void SetCapacity(size_t capacity);
+
+    size_t GetCapacity() const { return _capacity; }
+
+    // Ищет ответ по ключу среди ответов, вычисленных по индексу версии version.
+    // Возвращает true и копирует ответ в result, если он найден
+    bool Get(const std::string& key, uint64_t version, std::vector<RelativeIndex>& result);
+
+    // Сохраняет ответ, вычисленный по индексу версии version
+    void Put(const std::string& key, uint64_t version, std::vector<RelativeIndex> result);
+
+    // Удаляет все ответы, статистика сохраняется
+    void Clear();
+
+    ResultCacheStats GetStats() const;
+
+private:
+    struct Item
+    {
+        std::string key;
+
+        std::vector<RelativeIndex> result;
+    };
+
+    using ItemList = std::list<Item>;
+
+    struct Position
+    {
+        ItemList::iterator item;
+
+        bool is_protected; // В какой части сегмента находится ответ
+    };
+
+    struct Shard
+    {
+        std::mutex mutex;
+
+        uint64_t version = 0; // Версия индекса, по которой вычислены ответы сегмента
+
+        size_t probation_capacity = 0;
+
+        size_t protected_capacity = 0;
+
+        ItemList probation_items; // Ответы, запрошенные один раз, от новых к старым
+
+        ItemList protected_items; // Ответы, запрошенные повторно, от новых к старым
+
+        std::unordered_map<std::string, Position> positions;
+    };
+
+    Shard& ShardFor(const std::string& key) const;
+
+    // Очищает сегмент, если его ответы вычислены по другой версии индекса
+    void CheckVersion(Shard& shard, uint64_t version);
+
+    // Вытесняет самые старые ответы испытательной части сверх ее емкости
+    void TrimProbation(Shard& shard);
+
+    size_t _capacity = 0;
+
+    std::vector<std::unique_ptr<Shard>> _shards;
+
+    std::atomic<uint64_t> _hits{ 0 };
+
+    std::atomic<uint64_t> _misses{ 0 };
+
+    std::atomic<uint64_t> _insertions{ 0 };
+
+    std::atomic<uint64_t> _evictions{ 0 };
+
+    std::atomic<uint64_t> _invalidations{ 0 };
+};
@@ -0,0 +1,53 @@
+#pragma once
+#include <cmath>
+#include <cstddef>
+
+// Функции ранжирования подставляются в цикл обработки запроса как параметры шаблона,
+// поэтому в горячем цикле нет виртуальных вызовов.
+// Каждая функция определяет:
+//   score_type - тип накапливаемой абсолютной релевантности;
+//   TermWeight(doc_freq, total_docs) - вес слова, вычисляется один раз на запрос;
+//   Score(weight, count) - вклад одного вхождения слова в документ.
+// Score не убывает по count, поэтому Score(weight, max_count) - верхняя граница вклада слова,
+// на которой основано динамическое отсечение документов (MaxScore).
+// В дереве операторов вес слова нечеткого запроса умножается на FuzzyBoost, а вклад считает
+// BoostedScore(weight, count). Веса всех слов дерева дополнительно умножаются на BOOST_SCALE,
+// чтобы при целой релевантности вклад с множителем 1/2 или 1/3 остался целым; относительная
+// релевантность от общего множителя не меняется.
+
+// Абсолютная релевантность - суммарное количество вхождений слов запроса в документ
+struct TermCountScorer
+{
+    using score_type = size_t;
+
+    // Общее кратное знаменателей FuzzyBoost (1, 2, 3) при расстоянии до MAX_FUZZY_DISTANCE
+    static constexpr double BOOST_SCALE = 6.0;
+
+    double TermWeight(size_t /*doc_freq*/, size_t /*total_docs*/) const { return 1.0; }
+
+    score_type Score(double /*weight*/, size_t count) const { return count; }
+
+    // Вес - целый множитель количества вхождений: BOOST_SCALE, умноженный на FuzzyBoost
+    score_type BoostedScore(double weight, size_t count) const { return static_cast<score_type>(weight + 0.5) * count; }
+};
+
+// Количество вхождений, умноженное на обратную документную частоту слова
+struct TfIdfScorer
+{
+    using score_type = float;
+
+    static constexpr double BOOST_SCALE = 1.0;
+
+    double TermWeight(size_t doc_freq, size_t total_docs) const
+    {
+        // Сглаженный idf, всегда положительный
+        return std::log(1.0 + static_cast<double>(total_docs) / static_cast<double>(doc_freq ? doc_freq : 1));
+    }
+
+    score_type Score(double weight, size_t count) const
+    {
+        return static_cast<score_type>(weight * static_cast<double>(count));
+    }
+
+    score_type BoostedScore(double weight, size_t count) const { return Score(weight, count); }
+};
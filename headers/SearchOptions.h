@@ -0,0 +1,119 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+// Функция ранжирования документов
+enum class ScorerType
+{
+    TermCount, // Сумма количества вхождений слов запроса (по умолчанию)
+    TfIdf      // Количество вхождений, взвешенное обратной документной частотой
+};
+
+// Способ обхода списков вхождений при обработке запроса
+enum class EvaluationStrategy
+{
+    Exhaustive,  // Суммирование всех вхождений всех слов запроса
+    MaxScore,    // Обход "документ за документом" с отсечением документов, не попадающих в ответ
+    BlockMaxWand // Block-Max WAND: дополнительно пропускает целые блоки вхождений по блочным границам
+};
+
+// Какие документы считаются найденными по запросу из нескольких слов
+enum class QueryMode
+{
+    Any, // Документы, содержащие хотя бы одно слово запроса (по умолчанию)
+    All  // Документы, содержащие все слова запроса
+};
+
+// Синтаксис строки запроса
+enum class QuerySyntax
+{
+    Plain,  // Слова через пробел (по умолчанию)
+    Boolean // Операторы AND, OR, NOT, +/-, скобки и фразы в кавычках
+};
+
+// Наибольшее количество слов, в которые раскрывается шаблон запроса, по умолчанию
+constexpr size_t DEFAULT_WILDCARD_LIMIT = 1024;
+
+// Наибольшее количество слов, в которые раскрывается нечеткое слово запроса, по умолчанию
+constexpr size_t DEFAULT_FUZZY_LIMIT = 64;
+
+// Наибольшее количество правок в слове подсказки "возможно, вы имели в виду" по умолчанию
+constexpr size_t DEFAULT_SUGGESTION_DISTANCE = 2;
+
+// Настройки обработки поисковых запросов (секция "search" файла config.json)
+struct SearchOptions
+{
+    ScorerType scorer = ScorerType::TermCount; // Функция ранжирования
+
+    EvaluationStrategy strategy = EvaluationStrategy::MaxScore; // Способ обхода списков вхождений
+
+    QueryMode mode = QueryMode::Any; // Режим сопоставления слов запроса
+
+    QuerySyntax syntax = QuerySyntax::Plain; // Синтаксис строки запроса
+
+    size_t cache_capacity = 1024; // Количество ответов в кэше результатов, 0 - кэш отключен
+
+    size_t posting_cache_bytes = 16 << 20; // Память под кэш пересечений списков вхождений, 0 - кэш отключен
+
+    size_t wildcard_limit = DEFAULT_WILDCARD_LIMIT; // Наибольшее количество слов шаблона, 0 - шаблоны отключены
+
+    size_t fuzzy_limit = DEFAULT_FUZZY_LIMIT; // Наибольшее количество слов нечеткого слова, 0 - нечеткий поиск отключен
+
+    // Наибольшее количество правок в слове подсказки для запросов без результатов, 0 - подсказки отключены
+    size_t suggestion_distance = DEFAULT_SUGGESTION_DISTANCE;
+
+    // Файл, в который при завершении программы записывается профиль этапов обработки запросов
+    // (QueryProfile.h), пустая строка - профиль не записывается
+    std::string profile_file;
+
+    // Порог времени выполнения запроса в миллисекундах: более медленные запросы записываются
+    // в журнал медленных запросов (SlowQueryLog), 0 - журнал отключен
+    double slow_query_ms = 0;
+
+    std::string slow_query_log; // Файл журнала медленных запросов, пустая строка - std::cerr
+};
+
+// Преобразует название функции ранжирования из config.json в ScorerType
+// Неизвестные названия приводят к значению по умолчанию
+inline ScorerType ParseScorerType(const std::string& name)
+{
+    if (name == "tfidf")
+    {
+        return ScorerType::TfIdf;
+    }
+    return ScorerType::TermCount;
+}
+
+// Преобразует название способа обхода из config.json в EvaluationStrategy
+inline EvaluationStrategy ParseEvaluationStrategy(const std::string& name)
+{
+    if (name == "exhaustive")
+    {
+        return EvaluationStrategy::Exhaustive;
+    }
+    if (name == "blockmax")
+    {
+        return EvaluationStrategy::BlockMaxWand;
+    }
+    return EvaluationStrategy::MaxScore;
+}
+
+// Преобразует название режима сопоставления из config.json в QueryMode
+inline QueryMode ParseQueryMode(const std::string& name)
+{
+    if (name == "all")
+    {
+        return QueryMode::All;
+    }
+    return QueryMode::Any;
+}
+
+// Преобразует название синтаксиса запросов из config.json в QuerySyntax
+inline QuerySyntax ParseQuerySyntax(const std::string& name)
+{
+    if (name == "boolean")
+    {
+        return QuerySyntax::Boolean;
+    }
+    return QuerySyntax::Plain;
+}
@@ -1,18 +1,14 @@
 #pragma once
 #include <vector>
 #include <string>
+#include "BooleanQuery.h"
 #include "InvertedIndex.h"
+#include "PostingCache.h"
+#include "QueryEvaluator.h"
+#include "ResultCache.h"
+#include "SearchOptions.h"
+#include "SlowQueryLog.h"
 
-struct RelativeIndex
-{
-    size_t doc_id;
-    float rank;
-
-    bool operator ==(const RelativeIndex& other) const
-    {
-        return (doc_id == other.doc_id && rank == other.rank);
-    }
-};
 // Класс позволяет определять наиболее релевантные, соответствующие поисковому запросу,
 // документы по прочитанным из файла requests.json поисковым запросам
 class SearchServer
@@ -20,25 +16,80 @@ class SearchServer
 public:
     // idx в конструктор класса передается ссылка на класс InvertedIndex,
     // чтобы SearchServer мог узнать частоту слов встречаемых в запросе
-    SearchServer(InvertedIndex& idx) : _index(idx) {};
+    SearchServer(InvertedIndex& idx)
+        : _index(idx), _cache(_options.cache_capacity), _posting_cache(_options.posting_cache_bytes) {};
+
+    // Задает настройки обработки запросов (функцию ранжирования и т.д.).
+    // При изменении емкости кэш результатов сбрасывается
+    void SetOptions(const SearchOptions& options);
+
+    const SearchOptions& GetOptions() const { return _options; }
 
     // Метод обработки поисковых запросов
     // queries_input поисковые запросы взятые из файла requests.json
     // Возвращает отсортированный список релевантных ответов для заданных запросов
+    // Одинаковые запросы разбираются один раз на весь пакет
     std::vector<std::vector<RelativeIndex>> search(const std::vector<std::string>& queries_input);
 
-private:
-    InvertedIndex& _index;
-};
+    // Разбирает запрос с учетом текущих настроек (синтаксис, режим сопоставления слов).
+    // Результат можно выполнять многократно, пока не изменились настройки; после обновления
+    // индекса search разбирает запрос заново
+    CompiledQuery Compile(const std::string& query) const;
 
+    // Выполняет разобранный запрос, возвращает не более limit наиболее релевантных документов.
+    // Ответы на повторные запросы берутся из кэша, пока не изменился индекс.
+    // Запросы, выполнявшиеся дольше SearchOptions::slow_query_ms, попадают в журнал медленных запросов.
+    // Можно вызывать из нескольких потоков одновременно
+    std::vector<RelativeIndex> search(const CompiledQuery& query, size_t limit) const;
 
+    // Подсказка "возможно, вы имели в виду" для запроса без результатов: запрос, в котором
+    // слова, отсутствующие в индексе, заменены ближайшими (при равном расстоянии - самыми частыми)
+    // словами индекса в нормализованном виде. Пустая строка, если исправлять нечего
+    std::string Suggest(const std::string& query) const;
 
+    // Статистика кэша результатов
+    ResultCacheStats GetCacheStats() const { return _cache.GetStats(); }
 
+    // Статистика кэша пересечений списков вхождений - для подбора его размера
+    PostingCacheStats GetPostingCacheStats() const { return _posting_cache.GetStats(); }
 
+    // Последние записи журнала медленных запросов, от старых к новым
+    std::vector<SlowQueryRecord> GetSlowQueries() const { return _slow_log.GetRecent(); }
 
+private:
+    // Выполнение запроса, инстанцированное для конкретной функции ранжирования
+    template <typename Scorer>
+    std::vector<RelativeIndex> evaluate(const QueryNode& root, size_t limit) const;
+
+    // Итераторы для пересечения списков вхождений слов и пересечение из кэша, в которое они
+    // указывают. Владение пересечением держит его, пока итераторы используются: кэш мог его
+    // не сохранить (больше бюджета) или вытеснить другим запросом
+    struct ConjunctionIterators
+    {
+        std::vector<EntryPostingIterator> iterators;
+
+        std::shared_ptr<const PairPostings> pair;
+    };
+
+    // Пересечение двух самых коротких списков берется из кэша пересечений, если его выгодно кэшировать
+    ConjunctionIterators conjunctionIterators(std::vector<std::string> terms) const;
 
+    // Выполнение запроса без обращения к кэшу
+    std::vector<RelativeIndex> evaluate(const CompiledQuery& query, size_t limit) const;
 
+    // Выполнение запроса с обращением к кэшу
+    std::vector<RelativeIndex> execute(const CompiledQuery& query, size_t limit) const;
 
+    // Запись журнала медленных запросов: слова запроса и длины их списков вхождений
+    SlowQueryRecord makeSlowQueryRecord(const CompiledQuery& query, size_t limit) const;
 
+    InvertedIndex& _index;
+
+    SearchOptions _options;
 
+    mutable ResultCache _cache; // Кэш ответов, ключ - канонический вид запроса и параметры ранжирования
 
+    mutable PostingCache _posting_cache; // Кэш пересечений списков вхождений пар частых слов
+
+    mutable SlowQueryLog _slow_log; // Журнал запросов, выполнявшихся дольше порога
+};
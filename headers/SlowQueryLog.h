@@ -0,0 +1,86 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+#include <nlohmann/json_fwd.hpp>
+#include "QueryProfile.h"
+
+// Наибольшее количество слов запроса в записи журнала: шаблоны раскрываются в сотни слов
+constexpr size_t SLOW_QUERY_MAX_TERMS = 64;
+
+// Запись журнала медленных запросов: профиль выполнения одного запроса
+struct SlowQueryRecord
+{
+    std::string query; // Канонический вид запроса (CompiledQuery::key)
+
+    size_t limit = 0; // Наибольшее количество документов в ответе
+
+    uint64_t latency_ns = 0; // Время выполнения запроса
+
+    // Слова запроса (после раскрытия шаблонов и нечетких слов) и длины их списков вхождений,
+    // не больше SLOW_QUERY_MAX_TERMS
+    std::vector<std::pair<std::string, size_t>> terms;
+
+    size_t docs_scored = 0; // Документы, релевантность которых подсчитана полностью
+
+    // Физический оператор: "maxscore", "blockmax", "exhaustive", "conjunctive", "maxscore_not"
+    // (объединение с исключениями), "tree" (дерево операторов) или "cache" (ответ из кэша)
+    std::string strategy;
+
+    // Собственное время этапов (QueryPhase); нули при сборке без SEARCH_ENGINE_PROFILING
+    std::array<uint64_t, QUERY_PHASE_COUNT> phase_ns{};
+
+    size_t results = 0; // Документы в ответе
+};
+
+// Запись в виде объекта JSON: {"query", "limit", "latency_ns", "results", "docs_scored",
+// "strategy", "terms": [[слово, длина списка], ...], "phases_ns": {этап: время}}
+nlohmann::ordered_json SlowQueryRecordToJson(const SlowQueryRecord& record);
+
+// Журнал запросов, выполнявшихся дольше порога. Записи дописываются в файл в формате
+// JSON Lines (без файла - в std::cerr), последние MAX_RECENT хранятся в памяти.
+// Можно вызывать из нескольких потоков одновременно
+class SlowQueryLog
+{
+public:
+    // Количество последних записей, доступных через GetRecent
+    static constexpr size_t MAX_RECENT = 256;
+
+    // Порог времени выполнения запроса в наносекундах, 0 - журнал отключен
+    void SetThreshold(uint64_t threshold_ns) { _threshold_ns = threshold_ns; }
+
+    uint64_t GetThreshold() const { return _threshold_ns; }
+
+    // Файл журнала (дописывается), пустая строка - std::cerr.
+    // Нельзя вызывать одновременно с Write
+    void SetFile(const std::string& path);
+
+    const std::string& GetFile() const { return _path; }
+
+    void Write(SlowQueryRecord record);
+
+    // Последние записи, от старых к новым
+    std::vector<SlowQueryRecord> GetRecent() const;
+
+    // Количество записей с момента создания
+    uint64_t GetCount() const;
+
+private:
+    uint64_t _threshold_ns = 0;
+
+    std::string _path;
+
+    std::ofstream _file;
+
+    mutable std::mutex _mutex;
+
+    std::deque<SlowQueryRecord> _recent;
+
+    uint64_t _count = 0;
+};
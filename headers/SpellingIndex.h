@@ -0,0 +1,56 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Количество первых символов слова, по которым строятся удаления
+constexpr size_t SPELLING_PREFIX_LENGTH = 7;
+
+// Количество правок, для которого строится индекс удалений
+constexpr size_t SPELLING_MAX_DISTANCE = 2;
+
+// Индекс симметричных удалений (SymSpell) для подсказок исправлений. Для каждого слова словаря
+// хранятся хэши всех строк, получающихся удалением не больше max_distance символов из его
+// первых SPELLING_PREFIX_LENGTH символов. Если слова отличаются не больше чем на d правок, то из
+// префиксов обоих можно удалить не больше d символов так, чтобы они совпали, поэтому кандидаты
+// находятся несколькими десятками поисков по хэшу без обхода словаря. Кандидаты - надмножество
+// ответа (совпадение хэшей, обрезанные префиксы), расстояние до них проверяется отдельно.
+// Слова, длина которых отличается больше чем на distance символов, отсеиваются сразу
+class SpellingIndex
+{
+public:
+    // Строит индекс по словам словаря: номер слова - его позиция в terms
+    void Build(const std::vector<std::string>& terms, size_t max_distance);
+
+    void Clear();
+
+    bool Empty() const { return _entries.empty(); }
+
+    // Наибольшее количество правок, для которого индекс находит все слова
+    size_t MaxDistance() const { return _max_distance; }
+
+    // Номера слов, которые могут отличаться от word не больше чем на distance правок
+    // (distance не больше MaxDistance), по возрастанию без повторов
+    std::vector<uint32_t> Candidates(std::string_view word, size_t distance) const;
+
+    // Память под индекс в байтах
+    size_t MemoryBytes() const
+    {
+        return _entries.capacity() * sizeof(uint64_t) + _buckets.capacity() * sizeof(uint32_t) + _lengths.capacity();
+    }
+
+private:
+    // Хэш удаления в старших 32 битах, номер слова - в младших; по возрастанию
+    std::vector<uint64_t> _entries;
+
+    // Начало корзины в _entries по старшим битам хэша, последний элемент - _entries.size()
+    std::vector<uint32_t> _buckets;
+
+    std::vector<uint8_t> _lengths; // Длина слова в символах по номеру (не больше 255)
+
+    unsigned _shift = 32; // Сдвиг хэша, оставляющий номер корзины
+
+    size_t _max_distance = 0;
+};
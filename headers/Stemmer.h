@@ -0,0 +1,43 @@
+#pragma once
+#include <string>
+#include "IndexOptions.h"
+
+// Выделение основы слова. Принимает слово, уже нормализованное NormalizeWord
+// (нижний регистр, без знаков препинания), и возвращает его основу.
+// Слова, к которым стеммер неприменим (другой алфавит, цифры), возвращаются без изменений
+class Stemmer
+{
+public:
+    virtual ~Stemmer() = default;
+
+    virtual std::string Stem(const std::string& word) const = 0;
+};
+
+// Стеммер Snowball для русского языка
+class RussianStemmer : public Stemmer
+{
+public:
+    std::string Stem(const std::string& word) const override;
+};
+
+// Стеммер Портера для английского языка
+class PorterStemmer : public Stemmer
+{
+public:
+    std::string Stem(const std::string& word) const override;
+};
+
+// Выбирает стеммер по алфавиту слова: кириллица - русский, латиница - английский
+class AutoStemmer : public Stemmer
+{
+public:
+    std::string Stem(const std::string& word) const override;
+};
+
+// Возвращает стеммер заданного вида, nullptr для StemmerType::None
+const Stemmer* GetStemmer(StemmerType type);
+
+// Основа слова с запоминанием: для каждого потока хранится словарь "слово - основа",
+// поэтому на тексте с распределением Ципфа основа большинства слов вычисляется один раз.
+// Словарь ограничен по размеру и очищается при переполнении
+std::string StemWord(StemmerType type, const std::string& word);
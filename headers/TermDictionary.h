@@ -0,0 +1,137 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Номер, которого нет ни у одного слова словаря
+constexpr uint32_t NO_TERM = std::numeric_limits<uint32_t>::max();
+
+// Детерминированный автомат над байтами слова, с которым пересекается словарь
+// (TermDictionary::Intersect). Состояния - неотрицательные числа, -1 - тупиковое состояние:
+// ни одно продолжение слова не подходит, и обход словаря дальше не идет
+class TermAutomaton
+{
+public:
+    virtual ~TermAutomaton() = default;
+
+    virtual int Start() = 0;
+
+    virtual int Step(int state, uint8_t byte) = 0;
+
+    // Подходит ли слово, прочитанное до этого состояния
+    virtual bool IsMatch(int state) = 0;
+};
+
+// Неизменяемый упорядоченный словарь слов индекса. Слова получают плотные номера
+// 0..Size()-1 в лексикографическом порядке, по номеру списки вхождений лежат в массиве.
+//
+// Словарь хранится как минимальный ациклический конечный преобразователь (FST): общие
+// префиксы и общие окончания слов записаны один раз. Выход перехода - количество слов,
+// которые меньше любого слова, проходящего по этому переходу, поэтому номер слова равен
+// сумме выходов на его пути. Все слова с одним префиксом имеют подряд идущие номера.
+//
+// Автомат записан в непрерывный буфер с относительными ссылками и не содержит указателей:
+// буфер можно сохранить в файл и затем подключить через Attach (например, из mmap) без копирования
+class TermDictionary
+{
+public:
+    // Строит словарь из слов, упорядоченных по возрастанию и не повторяющихся
+    void Build(const std::vector<std::string>& sorted_terms);
+
+    // Подключает ранее построенный буфер (Data()) без копирования. Память должна
+    // оставаться доступной, пока используется словарь. Все достижимые состояния автомата
+    // проверяются одним проходом; false - буфер обрезан или поврежден, словарь остается пустым
+    bool Attach(const uint8_t* data, size_t size);
+
+    // Буфер автомата для сохранения
+    std::pair<const uint8_t*, size_t> Data() const { return { Bytes(), _bytes_size }; }
+
+    // Номер слова или NO_TERM, если его нет в словаре
+    uint32_t Find(std::string_view term) const;
+
+    // Количество слов словаря, меньших term (номер первого слова не меньше term)
+    uint32_t LowerBound(std::string_view term) const;
+
+    // Номера слов с заданным префиксом: полуинтервал [first, second)
+    std::pair<uint32_t, uint32_t> PrefixRange(std::string_view prefix) const;
+
+    // Слово по номеру
+    std::string Term(uint32_t id) const;
+
+    // Перебирает по возрастанию слова, допускаемые автоматом, обходя словарь и автомат
+    // одновременно: ветви, в которых автомат попадает в тупик, не просматриваются.
+    // visit возвращает false, чтобы прекратить перебор
+    void Intersect(TermAutomaton& automaton, const std::function<bool(const std::string&, uint32_t)>& visit) const;
+
+    // Количество слов
+    size_t Size() const { return _size; }
+
+    // Память, занимаемая словарем, в байтах
+    size_t MemoryBytes() const { return _bytes_size; }
+
+    void Clear();
+
+    // Перебор слов словаря по возрастанию, начиная с произвольного места
+    class Iterator
+    {
+    public:
+        explicit Iterator(const TermDictionary& dictionary);
+
+        // Переходит к первому слову, не меньшему target
+        void Seek(std::string_view target);
+
+        bool AtEnd() const { return _at_end; }
+
+        const std::string& Term() const { return _term; }
+
+        uint32_t Id() const { return _id; }
+
+        void Next();
+
+    private:
+        struct Frame
+        {
+            uint32_t state;   // Адрес состояния
+            size_t cursor;    // Адрес следующего непросмотренного перехода
+            size_t arcs_left; // Количество непросмотренных переходов
+            uint32_t id;      // Номер первого слова, проходящего через состояние
+        };
+
+        // Открывает состояние: кладет его в стек, возвращает, является ли оно конечным
+        bool Push(uint32_t state, uint32_t id);
+
+        // Ищет следующее слово обходом в глубину от вершины стека
+        void FindNext();
+
+        const TermDictionary& _dictionary;
+
+        std::vector<Frame> _stack;
+
+        std::string _term;
+
+        uint32_t _id = 0;
+
+        bool _at_end = true;
+    };
+
+private:
+    const uint8_t* Bytes() const { return _external != nullptr ? _external : _buffer.data(); }
+
+    // Количество слов, проходящих через состояние
+    uint32_t StateCount(uint32_t state) const;
+
+    std::vector<uint8_t> _buffer; // Собственный буфер автомата (после Build)
+
+    const uint8_t* _external = nullptr; // Подключенный внешний буфер (после Attach)
+
+    size_t _bytes_size = 0; // Размер буфера автомата
+
+    uint32_t _root = 0; // Адрес начального состояния
+
+    size_t _size = 0; // Количество слов
+};
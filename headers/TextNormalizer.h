@@ -0,0 +1,24 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// Нормализация слов текста в кодировке UTF-8 без сторонних библиотек.
+// Из слова остаются только буквы и цифры, буквы приводятся к нижнему регистру по таблице.
+// Поддерживаются латиница (включая расширенную A), греческий алфавит, кириллица,
+// армянский, иврит, арабский; символы за пределами U+07FF сохраняются как есть, кроме
+// блоков знаков препинания и символов (U+2000-U+2BFF, U+3000-U+303F, U+FE30-U+FE4F,
+// U+FF01-U+FF0F) и символов вне основной плоскости (эмодзи).
+// Буква "ё" приводится к "е", разложенные "и" + U+0306 и "е" + U+0308 собираются в "й" и "е",
+// остальные комбинируемые знаки удаляются. Некорректные последовательности байтов пропускаются.
+// ASCII-часть слова обрабатывается по 8 байт за раз (SWAR), поэтому английский текст
+// нормализуется не медленнее побайтового std::isalnum/std::tolower
+
+// Дописывает нормализованное слово в конец out
+void AppendNormalizedWord(std::string_view word, std::string& out);
+
+// Возвращает нормализованное слово
+std::string NormalizeWord(std::string_view word);
+
+// Приводит кодовую точку к нижнему регистру, 0 - не буква и не цифра
+uint32_t FoldCodePoint(uint32_t code_point);
@@ -0,0 +1,66 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "InvertedIndex.h"
+#include "TermDictionary.h"
+
+// Шаблоны слов в запросах: "*" - любая последовательность символов (в том числе пустая),
+// "?" - ровно один символ. Шаблон раскрывается в слова словаря индекса
+
+// Есть ли в слове символы шаблона
+bool IsWildcardPattern(std::string_view word);
+
+// Нормализует шаблон: части между "*" и "?" приводятся к виду слов индекса (NormalizeWord),
+// повторяющиеся "*" склеиваются. Стеммер к шаблону не применяется
+std::string NormalizeWildcard(std::string_view pattern);
+
+// Автомат, допускающий слова, подходящие под нормализованный шаблон. Строится из
+// недетерминированного автомата по позициям шаблона; детерминированные состояния
+// вычисляются по мере обхода словаря. "?" соответствует одному символу UTF-8
+class WildcardAutomaton : public TermAutomaton
+{
+public:
+    explicit WildcardAutomaton(std::string_view pattern);
+
+    int Start() override { return _start; }
+
+    int Step(int state, uint8_t byte) override;
+
+    bool IsMatch(int state) override { return _matches[state]; }
+
+private:
+    // Элемент шаблона
+    struct Element
+    {
+        enum class Kind { Byte, AnyChar, AnyString };
+
+        Kind kind;
+        uint8_t byte = 0;
+    };
+
+    // Добавляет состояние недетерминированного автомата вместе с переходами по пустому слову
+    void AddClosure(std::vector<uint32_t>& states, size_t element, uint32_t pending) const;
+
+    // Номер детерминированного состояния для множества состояний, -1 для пустого множества
+    int Intern(std::vector<uint32_t> states);
+
+    std::vector<Element> _elements;
+
+    std::map<std::vector<uint32_t>, int> _ids; // Множество состояний - номер состояния
+
+    std::vector<std::vector<uint32_t>> _states; // Номер состояния - множество состояний
+
+    std::vector<std::array<int, 256>> _transitions; // -2 - переход еще не вычислен
+
+    std::vector<bool> _matches;
+
+    int _start = -1;
+};
+
+// Раскрывает нормализованный шаблон в слова словаря индекса по возрастанию. Если подходящих
+// слов больше limit, остаются limit слов с наибольшей документной частотой
+std::vector<std::string> ExpandWildcard(const InvertedIndex& index, const std::string& pattern, size_t limit);
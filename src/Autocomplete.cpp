@@ -0,0 +1,160 @@
+#include "Autocomplete.h"
+#include <algorithm>
+#include <cctype>
+#include <queue>
+#include <sstream>
+#include <tuple>
+#include "TextNormalizer.h"
+
+// Нормализует слова запроса и разделяет их одним пробелом
+std::string NormalizeCompletion(std::string_view text)
+{
+    std::string normalized;
+    std::istringstream stream{ std::string(text) };
+    std::string word;
+    while (stream >> word)
+    {
+        const size_t size = normalized.size();
+        if (size > 0)
+        {
+            normalized += ' ';
+        }
+        const size_t start = normalized.size();
+        AppendNormalizedWord(word, normalized);
+        if (normalized.size() == start)
+        {
+            normalized.resize(size); // слово без букв и цифр не занимает места
+        }
+    }
+    if (!normalized.empty() && !text.empty() && std::isspace(static_cast<unsigned char>(text.back())))
+    {
+        normalized += ' ';
+    }
+    return normalized;
+}
+
+// Варианты - слова словаря индекса, веса - их документная частота
+void Autocompleter::Build(const InvertedIndex& index)
+{
+    _dictionary = index.GetTermDictionary();
+    _weights.resize(_dictionary.Size());
+    for (uint32_t id = 0; id < _weights.size(); ++id)
+    {
+        _weights[id] = index.GetPostings(id).entries.size();
+    }
+    BuildTree();
+}
+
+// Варианты - нормализованные запросы журнала
+void Autocompleter::Build(const std::vector<std::pair<std::string, uint64_t>>& queries)
+{
+    std::vector<std::pair<std::string, uint64_t>> normalized;
+    normalized.reserve(queries.size());
+    for (const auto& [query, weight] : queries)
+    {
+        std::string text = NormalizeCompletion(query);
+        while (!text.empty() && text.back() == ' ')
+        {
+            text.pop_back();
+        }
+        if (!text.empty())
+        {
+            normalized.emplace_back(std::move(text), weight);
+        }
+    }
+    std::sort(normalized.begin(), normalized.end());
+
+    std::vector<std::string> texts;
+    _weights.clear();
+    for (auto& [text, weight] : normalized)
+    {
+        if (!texts.empty() && texts.back() == text)
+        {
+            _weights.back() += weight;
+            continue;
+        }
+        texts.push_back(std::move(text));
+        _weights.push_back(weight);
+    }
+    _dictionary.Build(texts);
+    BuildTree();
+}
+
+void Autocompleter::BuildTree()
+{
+    const size_t n = _weights.size();
+    _weights.shrink_to_fit();
+    _tree.assign(2 * n, NO_TERM);
+    for (size_t i = 0; i < n; ++i)
+    {
+        _tree[n + i] = static_cast<uint32_t>(i);
+    }
+    for (size_t i = n; i-- > 1;)
+    {
+        _tree[i] = Better(_tree[2 * i], _tree[2 * i + 1]);
+    }
+}
+
+void Autocompleter::Clear()
+{
+    _dictionary.Clear();
+    _weights.clear();
+    _weights.shrink_to_fit();
+    _tree.clear();
+    _tree.shrink_to_fit();
+}
+
+// Подъем по дереву от границ полуинтервала к корню
+uint32_t Autocompleter::Best(uint32_t first, uint32_t last) const
+{
+    const size_t n = _weights.size();
+    uint32_t best = NO_TERM;
+    for (size_t left = first + n, right = last + n; left < right; left /= 2, right /= 2)
+    {
+        if (left & 1)
+        {
+            best = Better(best, _tree[left++]);
+        }
+        if (right & 1)
+        {
+            best = Better(best, _tree[--right]);
+        }
+    }
+    return best;
+}
+
+// K лучших вариантов диапазона префикса: лучший вариант отрезка делит его на два,
+// из которых следующий лучший выбирается по куче
+std::vector<Completion> Autocompleter::Complete(std::string_view prefix, size_t limit) const
+{
+    std::vector<Completion> completions;
+    if (limit == 0 || _weights.empty())
+    {
+        return completions;
+    }
+    const auto [first, last] = _dictionary.PrefixRange(NormalizeCompletion(prefix));
+    // Отрезок в куче: {лучший вариант, начало, конец}; сверху - лучший вариант
+    using Segment = std::tuple<uint32_t, uint32_t, uint32_t>;
+    const auto worse = [this](const Segment& a, const Segment& b)
+    {
+        return Better(std::get<0>(a), std::get<0>(b)) == std::get<0>(b);
+    };
+    std::priority_queue<Segment, std::vector<Segment>, decltype(worse)> heap(worse);
+    const auto push = [&](uint32_t begin, uint32_t end)
+    {
+        if (begin < end)
+        {
+            heap.emplace(Best(begin, end), begin, end);
+        }
+    };
+    push(first, last);
+    while (!heap.empty() && completions.size() < limit)
+    {
+        const auto [id, begin, end] = heap.top();
+        heap.pop();
+        completions.push_back({ _dictionary.Term(id), _weights[id] });
+        push(begin, id);
+        push(id + 1, end);
+    }
+    return completions;
+}
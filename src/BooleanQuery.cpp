@@ -0,0 +1,1128 @@
+#include <algorithm>
+#include <bit>
+#include <cctype>
+#include <charconv>
+#include <cstdint>
+#include <queue>
+#include <sstream>
+#include "BooleanQuery.h"
+#include "FuzzyTerm.h"
+#include "PostingIterator.h"
+#include "Scorers.h"
+#include "TextNormalizer.h"
+#include "Wildcard.h"
+
+using NodePtr = std::shared_ptr<const QueryNode>;
+
+// Проверяет, что группа состоит только из отдельных слов
+bool QueryNode::AllTerms(const std::vector<std::shared_ptr<const QueryNode>>& clauses)
+{
+    return std::all_of(clauses.begin(), clauses.end(), [](const NodePtr& clause)
+    {
+        return clause->type == Type::Term;
+    });
+}
+
+namespace
+{
+    // Лексема логического запроса
+    struct Token
+    {
+        enum class Kind { Word, Phrase, LParen, RParen, And, Or, Not, Near, Plus, Minus, End };
+
+        Kind kind;
+        std::string text; // Слово или содержимое фразы
+
+        size_t distance = 0; // Near - допустимое расстояние между словами
+    };
+
+    // Расстояние для NEAR без явного числа
+    constexpr size_t DEFAULT_NEAR_DISTANCE = 5;
+
+    // Наибольшее расстояние для NEAR: позиции слов - uint32_t, большее расстояние ничего не меняет
+    constexpr size_t MAX_NEAR_DISTANCE = UINT32_MAX;
+
+    // Распознает оператор "NEAR" или "NEAR/k". Возвращает false, если слово - не оператор
+    bool ParseNear(const std::string& word, size_t& distance)
+    {
+        if (word.compare(0, 4, "NEAR") != 0)
+        {
+            return false;
+        }
+        if (word.size() == 4)
+        {
+            distance = DEFAULT_NEAR_DISTANCE;
+            return true;
+        }
+        if (word[4] != '/' || word.size() == 5 ||
+            !std::all_of(word.begin() + 5, word.end(), [](char c) { return std::isdigit(static_cast<unsigned char>(c)); }))
+        {
+            return false;
+        }
+        // Число, не помещающееся в size_t, тоже ограничивается MAX_NEAR_DISTANCE
+        size_t value = MAX_NEAR_DISTANCE;
+        std::from_chars(word.data() + 5, word.data() + word.size(), value);
+        distance = std::min(value, MAX_NEAR_DISTANCE);
+        return true;
+    }
+
+    bool IsDelimiter(char c)
+    {
+        return std::isspace(static_cast<unsigned char>(c)) || c == '(' || c == ')' || c == '"';
+    }
+
+    // Разбивает строку логического запроса на лексемы
+    std::vector<Token> Tokenize(const std::string& query)
+    {
+        std::vector<Token> tokens;
+        size_t i = 0;
+        while (i < query.size())
+        {
+            const char c = query[i];
+            if (std::isspace(static_cast<unsigned char>(c)))
+            {
+                ++i;
+            }
+            else if (c == '(' || c == ')')
+            {
+                tokens.push_back({ c == '(' ? Token::Kind::LParen : Token::Kind::RParen, {} });
+                ++i;
+            }
+            else if (c == '"')
+            {
+                // Незакрытая кавычка закрывается в конце запроса
+                const size_t close = query.find('"', i + 1);
+                const size_t end = close == std::string::npos ? query.size() : close;
+                tokens.push_back({ Token::Kind::Phrase, query.substr(i + 1, end - i - 1) });
+                i = end + 1;
+            }
+            else if ((c == '+' || c == '-') && i + 1 < query.size() &&
+                     !std::isspace(static_cast<unsigned char>(query[i + 1])))
+            {
+                tokens.push_back({ c == '+' ? Token::Kind::Plus : Token::Kind::Minus, {} });
+                ++i;
+            }
+            else
+            {
+                size_t end = i;
+                while (end < query.size() && !IsDelimiter(query[end]))
+                {
+                    ++end;
+                }
+                std::string word = query.substr(i, end - i);
+                if (word == "AND")
+                {
+                    tokens.push_back({ Token::Kind::And, {} });
+                }
+                else if (word == "OR")
+                {
+                    tokens.push_back({ Token::Kind::Or, {} });
+                }
+                else if (word == "NOT")
+                {
+                    tokens.push_back({ Token::Kind::Not, {} });
+                }
+                else if (size_t distance = 0; ParseNear(word, distance))
+                {
+                    tokens.push_back({ Token::Kind::Near, {}, distance });
+                }
+                else
+                {
+                    tokens.push_back({ Token::Kind::Word, std::move(word) });
+                }
+                i = end;
+            }
+        }
+        tokens.push_back({ Token::Kind::End, {} });
+        return tokens;
+    }
+
+    // Шаблон слова: узел Wildcard с подходящими словами словаря. Шаблон, раскрывшийся
+    // в одно слово, - обычное слово. Шаблон без единой буквы или цифры ("*") не ищется
+    NodePtr MakeWildcard(const std::string& word, const InvertedIndex& index, size_t limit)
+    {
+        std::string pattern = NormalizeWildcard(word);
+        if (pattern.find_first_not_of("*?") == std::string::npos)
+        {
+            return nullptr;
+        }
+        auto node = std::make_shared<QueryNode>();
+        node->terms = ExpandWildcard(index, pattern, limit);
+        node->type = node->terms.size() == 1 ? QueryNode::Type::Term : QueryNode::Type::Wildcard;
+        if (node->type == QueryNode::Type::Wildcard)
+        {
+            node->pattern = std::move(pattern);
+        }
+        return node;
+    }
+
+    // Нечеткое слово: узел Fuzzy с близкими словами словаря и их множителями веса.
+    // Если найдено только само слово - обычное слово
+    NodePtr MakeFuzzy(const std::string& base, size_t distance, const InvertedIndex& index, size_t limit)
+    {
+        std::string normalized = index.normalizeWord(base);
+        if (normalized.empty() || index.IsStopword(normalized))
+        {
+            return nullptr;
+        }
+        auto node = std::make_shared<QueryNode>();
+        for (auto& match : ExpandFuzzy(index, normalized, distance, limit))
+        {
+            node->terms.push_back(std::move(match.term));
+            node->boosts.push_back(FuzzyBoost(match.distance));
+        }
+        if (node->terms.size() == 1 && node->terms.front() == normalized)
+        {
+            node->type = QueryNode::Type::Term;
+            node->boosts.clear();
+            return node;
+        }
+        node->type = QueryNode::Type::Fuzzy;
+        node->pattern = std::move(normalized);
+        node->distance = distance;
+        return node;
+    }
+
+    // Узел для слова запроса, раскрываемого по словарю (IsExpandedTerm): нечеткого слова или шаблона
+    NodePtr MakeExpandedTerm(const std::string& word, const InvertedIndex& index, size_t wildcard_limit, size_t fuzzy_limit)
+    {
+        std::string base;
+        size_t distance = 0;
+        if (fuzzy_limit > 0 && ParseFuzzyTerm(word, base, distance))
+        {
+            return MakeFuzzy(base, distance, index, fuzzy_limit);
+        }
+        if (wildcard_limit > 0 && IsWildcardPattern(word))
+        {
+            return MakeWildcard(word, index, wildcard_limit);
+        }
+        return nullptr;
+    }
+
+    // Является ли слово запроса нечетким словом или шаблоном
+    bool IsExpandedTerm(const std::string& word, size_t wildcard_limit, size_t fuzzy_limit)
+    {
+        std::string base;
+        size_t distance = 0;
+        return (fuzzy_limit > 0 && ParseFuzzyTerm(word, base, distance)) || (wildcard_limit > 0 && IsWildcardPattern(word));
+    }
+
+    // Префикс слова запроса, задающего поиск подстроки
+    constexpr std::string_view SUBSTRING_PREFIX = "sub:";
+
+    bool IsSubstringTerm(const std::string& word)
+    {
+        return word.size() > SUBSTRING_PREFIX.size() && word.compare(0, SUBSTRING_PREFIX.size(), SUBSTRING_PREFIX) == 0;
+    }
+
+    // Подстрока нормализуется без стемминга: основа может быть короче искомой части слова
+    NodePtr MakeSubstring(const std::string& word)
+    {
+        std::string substring = NormalizeWord(std::string_view(word).substr(SUBSTRING_PREFIX.size()));
+        if (substring.empty())
+        {
+            return nullptr;
+        }
+        auto node = std::make_shared<QueryNode>();
+        node->type = QueryNode::Type::Substring;
+        node->pattern = std::move(substring);
+        return node;
+    }
+
+    // Вид условия в группе
+    enum class Occur { Must, Should, MustNot };
+
+    // Добавляет условие в группу, раскрывая вложенные группы того же вида:
+    // "a AND (b AND c)" превращается в одну группу из трех обязательных условий,
+    // а исключения из группы, состоящей только из них, переносятся в родительскую группу
+    void AddClause(QueryNode& group, const NodePtr& clause, Occur occur)
+    {
+        if (!clause)
+        {
+            return;
+        }
+        if (clause->type == QueryNode::Type::Boolean)
+        {
+            const bool only_must_not = clause->must.empty() && clause->should.empty();
+            const bool only_must = clause->should.empty() && clause->must_not.empty();
+            const bool only_should = clause->must.empty() && clause->must_not.empty();
+            if (only_must_not && occur != Occur::MustNot)
+            {
+                group.must_not.insert(group.must_not.end(), clause->must_not.begin(), clause->must_not.end());
+                return;
+            }
+            if ((only_must && occur == Occur::Must) || (only_should && occur == Occur::Should))
+            {
+                auto& target = occur == Occur::Must ? group.must : group.should;
+                const auto& source = occur == Occur::Must ? clause->must : clause->should;
+                target.insert(target.end(), source.begin(), source.end());
+                return;
+            }
+        }
+        auto& target = occur == Occur::Must ? group.must : occur == Occur::Should ? group.should : group.must_not;
+        // Повтор того же слова в группе не меняет результат - пропускаем его
+        if (clause->type == QueryNode::Type::Term &&
+            std::any_of(target.begin(), target.end(), [&](const NodePtr& other)
+            {
+                return other->type == QueryNode::Type::Term && other->terms == clause->terms;
+            }))
+        {
+            return;
+        }
+        target.push_back(clause);
+    }
+
+    // Упрощает группу: группа из одного should- или must-условия заменяется им самим
+    NodePtr Simplify(std::shared_ptr<QueryNode> group)
+    {
+        const size_t clauses = group->must.size() + group->should.size() + group->must_not.size();
+        if (clauses == 0)
+        {
+            return nullptr;
+        }
+        if (clauses == 1 && group->must_not.empty())
+        {
+            return group->must.empty() ? group->should.front() : group->must.front();
+        }
+        return group;
+    }
+
+    // Разбор логического запроса методом рекурсивного спуска:
+    //   or_expr  := and_expr ("OR" and_expr)*
+    //   and_expr := sequence ("AND" sequence)*
+    //   sequence := clause+           (условия без оператора, вид задается режимом QueryMode)
+    //   clause   := ("+" | "-" | "NOT") clause | primary
+    //   primary  := "(" or_expr ")" | "фраза" | слово ("NEAR/k" слово)*
+    class Parser
+    {
+    public:
+        Parser(std::vector<Token> tokens, const InvertedIndex& index, QueryMode mode, size_t wildcard_limit,
+               size_t fuzzy_limit)
+            : _tokens(std::move(tokens)), _index(index), _mode(mode), _wildcard_limit(wildcard_limit),
+              _fuzzy_limit(fuzzy_limit) {}
+
+        NodePtr Parse()
+        {
+            NodePtr root = ParseOr();
+            // Лишние закрывающие скобки пропускаем и продолжаем разбор как последовательность
+            while (Peek() != Token::Kind::End)
+            {
+                ++_pos;
+                auto group = std::make_shared<QueryNode>();
+                AddClause(*group, root, DefaultOccur());
+                AddClause(*group, ParseOr(), DefaultOccur());
+                root = Simplify(group);
+            }
+            return root;
+        }
+
+    private:
+        Token::Kind Peek() const { return _tokens[_pos].kind; }
+
+        Occur DefaultOccur() const { return _mode == QueryMode::All ? Occur::Must : Occur::Should; }
+
+        NodePtr ParseOr()
+        {
+            NodePtr first = ParseAnd();
+            if (Peek() != Token::Kind::Or)
+            {
+                return first;
+            }
+            auto group = std::make_shared<QueryNode>();
+            AddOrOperand(*group, first);
+            while (Peek() == Token::Kind::Or)
+            {
+                ++_pos;
+                AddOrOperand(*group, ParseAnd());
+            }
+            return Simplify(group);
+        }
+
+        // Операнд OR только из исключений (a OR NOT b) остается вложенной группой и, как запрос NOT b,
+        // не находит документов. AddClause подняла бы его исключения в группу OR: a AND NOT b
+        static void AddOrOperand(QueryNode& group, const NodePtr& operand)
+        {
+            if (operand && operand->type == QueryNode::Type::Boolean && operand->must.empty() && operand->should.empty())
+            {
+                group.should.push_back(operand);
+                return;
+            }
+            AddClause(group, operand, Occur::Should);
+        }
+
+        NodePtr ParseAnd()
+        {
+            NodePtr first = ParseSequence();
+            if (Peek() != Token::Kind::And)
+            {
+                return first;
+            }
+            auto group = std::make_shared<QueryNode>();
+            AddClause(*group, first, Occur::Must);
+            while (Peek() == Token::Kind::And)
+            {
+                ++_pos;
+                AddClause(*group, ParseSequence(), Occur::Must);
+            }
+            return Simplify(group);
+        }
+
+        NodePtr ParseSequence()
+        {
+            auto group = std::make_shared<QueryNode>();
+            while (true)
+            {
+                const Token::Kind kind = Peek();
+                if (kind != Token::Kind::Word && kind != Token::Kind::Phrase && kind != Token::Kind::LParen &&
+                    kind != Token::Kind::Plus && kind != Token::Kind::Minus && kind != Token::Kind::Not)
+                {
+                    break;
+                }
+                ParseClause(*group, DefaultOccur());
+            }
+            return Simplify(group);
+        }
+
+        void ParseClause(QueryNode& group, Occur occur)
+        {
+            switch (Peek())
+            {
+            case Token::Kind::Plus:
+                ++_pos;
+                ParseClause(group, Occur::Must);
+                return;
+            case Token::Kind::Minus:
+            case Token::Kind::Not:
+                ++_pos;
+                ParseClause(group, Occur::MustNot);
+                return;
+            default:
+                AddClause(group, ParsePrimary(), occur);
+            }
+        }
+
+        NodePtr ParsePrimary()
+        {
+            const Token& token = _tokens[_pos++];
+            switch (token.kind)
+            {
+            case Token::Kind::Word:
+                return Peek() == Token::Kind::Near ? ParseNearChain(token.text) : MakeTerm(token.text);
+            case Token::Kind::Phrase:
+                return MakePhrase(token.text);
+            case Token::Kind::LParen:
+            {
+                NodePtr inner = ParseOr();
+                if (Peek() == Token::Kind::RParen)
+                {
+                    ++_pos;
+                }
+                return inner;
+            }
+            default:
+                --_pos; // Оператор без операнда - не потребляем лексему
+                return nullptr;
+            }
+        }
+
+        // "a NEAR b NEAR c" - каждая пара соседних слов должна стоять рядом
+        NodePtr ParseNearChain(const std::string& first)
+        {
+            auto group = std::make_shared<QueryNode>();
+            std::string left = first;
+            while (Peek() == Token::Kind::Near)
+            {
+                const size_t distance = _tokens[_pos++].distance;
+                if (Peek() != Token::Kind::Word)
+                {
+                    break; // NEAR без второго слова игнорируется
+                }
+                std::string right = _tokens[_pos++].text;
+                AddClause(*group, MakeNear(left, right, distance), Occur::Must);
+                left = std::move(right);
+            }
+            if (group->must.empty())
+            {
+                return MakeTerm(first);
+            }
+            return Simplify(group);
+        }
+
+        NodePtr MakeNear(const std::string& left, const std::string& right, size_t distance) const
+        {
+            NodePtr a = MakeNormalizedTerm(_index.normalizeWord(left));
+            NodePtr b = MakeNormalizedTerm(_index.normalizeWord(right));
+            if (!a || !b)
+            {
+                // Одно из слов пустое после нормализации - остается другое
+                return a ? a : b;
+            }
+            auto node = std::make_shared<QueryNode>();
+            node->type = QueryNode::Type::Near;
+            node->terms = { a->terms.front(), b->terms.front() };
+            node->distance = distance;
+            return node;
+        }
+
+        NodePtr MakeTerm(const std::string& word) const
+        {
+            if (IsSubstringTerm(word))
+            {
+                return MakeSubstring(word);
+            }
+            if (IsExpandedTerm(word, _wildcard_limit, _fuzzy_limit))
+            {
+                return MakeExpandedTerm(word, _index, _wildcard_limit, _fuzzy_limit);
+            }
+            return MakeNormalizedTerm(_index.normalizeWord(word));
+        }
+
+        // Стоп-слова вне фраз не ищутся
+        NodePtr MakeNormalizedTerm(std::string normalized) const
+        {
+            if (normalized.empty() || _index.IsStopword(normalized))
+            {
+                return nullptr;
+            }
+            auto node = std::make_shared<QueryNode>();
+            node->type = QueryNode::Type::Term;
+            node->terms.push_back(std::move(normalized));
+            return node;
+        }
+
+        NodePtr MakePhrase(const std::string& text) const
+        {
+            auto node = std::make_shared<QueryNode>();
+            node->type = QueryNode::Type::Phrase;
+            std::istringstream words(text);
+            std::string word;
+            while (words >> word)
+            {
+                std::string normalized = _index.normalizeWord(word);
+                if (!normalized.empty())
+                {
+                    node->terms.push_back(std::move(normalized));
+                }
+            }
+            if (node->terms.size() <= 1)
+            {
+                // Фраза из одного слова - просто слово
+                return node->terms.empty() ? nullptr : MakeNormalizedTerm(node->terms.front());
+            }
+            return node;
+        }
+
+        std::vector<Token> _tokens;
+        const InvertedIndex& _index;
+        QueryMode _mode;
+        size_t _wildcard_limit;
+        size_t _fuzzy_limit;
+        size_t _pos = 0;
+    };
+
+    // Обычный запрос: уникальные нормализованные слова через пробел
+    NodePtr ParsePlain(const std::string& query, const InvertedIndex& index, QueryMode mode, size_t wildcard_limit,
+                       size_t fuzzy_limit)
+    {
+        std::vector<std::string> words;
+        std::vector<std::string> patterns;
+        std::istringstream buffer_stream(query);
+        std::string word;
+        while (buffer_stream >> word)
+        {
+            if (IsSubstringTerm(word) || IsExpandedTerm(word, wildcard_limit, fuzzy_limit))
+            {
+                patterns.push_back(std::move(word));
+                continue;
+            }
+            std::string normalized = index.normalizeWord(word);
+            if (!normalized.empty() && !index.IsStopword(normalized))
+            {
+                words.push_back(std::move(normalized));
+            }
+        }
+        std::sort(words.begin(), words.end());
+        words.erase(std::unique(words.begin(), words.end()), words.end());
+
+        auto group = std::make_shared<QueryNode>();
+        auto& target = mode == QueryMode::All ? group->must : group->should;
+        for (auto& normalized : words)
+        {
+            auto node = std::make_shared<QueryNode>();
+            node->type = QueryNode::Type::Term;
+            node->terms.push_back(std::move(normalized));
+            target.push_back(std::move(node));
+        }
+        for (const auto& pattern : patterns)
+        {
+            AddClause(*group, IsSubstringTerm(pattern) ? MakeSubstring(pattern)
+                                                       : MakeExpandedTerm(pattern, index, wildcard_limit, fuzzy_limit),
+                      mode == QueryMode::All ? Occur::Must : Occur::Should);
+        }
+        return group;
+    }
+
+    // Канонический вид узла: условия групп упорядочены, поэтому "a b" и "b a" совпадают
+    std::string CanonicalForm(const QueryNode& node)
+    {
+        switch (node.type)
+        {
+        case QueryNode::Type::Term:
+            return node.terms.front();
+        case QueryNode::Type::Phrase:
+        {
+            std::string form = "\"";
+            for (size_t i = 0; i < node.terms.size(); ++i)
+            {
+                form += (i ? " " : "") + node.terms[i];
+            }
+            return form + "\"";
+        }
+        case QueryNode::Type::Near:
+            return node.terms[0] + " NEAR/" + std::to_string(node.distance) + " " + node.terms[1];
+        case QueryNode::Type::Wildcard:
+            // Раскрытие шаблона при той же версии индекса определяется количеством слов
+            return node.pattern + "/" + std::to_string(node.terms.size());
+        case QueryNode::Type::Fuzzy:
+            return node.pattern + "~" + std::to_string(node.distance) + "/" + std::to_string(node.terms.size());
+        case QueryNode::Type::Substring:
+            return std::string(SUBSTRING_PREFIX) + node.pattern;
+        case QueryNode::Type::Boolean:
+        default:
+        {
+            std::vector<std::string> clauses;
+            const auto add = [&](const std::vector<NodePtr>& group, const char* prefix)
+            {
+                for (const auto& clause : group)
+                {
+                    clauses.push_back(prefix + CanonicalForm(*clause));
+                }
+            };
+            add(node.must, "+");
+            add(node.should, "");
+            add(node.must_not, "-");
+            std::sort(clauses.begin(), clauses.end());
+            std::string form = "(";
+            for (size_t i = 0; i < clauses.size(); ++i)
+            {
+                form += (i ? " " : "") + clauses[i];
+            }
+            return form + ")";
+        }
+        }
+    }
+
+    // Шаблон, раскрывшийся не более чем в столько слов, объединяется слиянием через кучу
+    constexpr size_t WILDCARD_HEAP_MAX_TERMS = 8;
+
+    // Иначе битовая карта используется, если вхождений хотя бы 1/16 от количества документов
+    constexpr size_t WILDCARD_BITSET_DENSITY = 16;
+
+    // Выполнение дерева запроса. Результат узла - документы, подходящие под узел,
+    // по возрастанию doc_id вместе с их абсолютной релевантностью
+    template <typename Scorer>
+    class TreeEvaluator
+    {
+    public:
+        using score_type = typename Scorer::score_type;
+        using Matches = std::vector<std::pair<size_t, score_type>>;
+
+        explicit TreeEvaluator(const InvertedIndex& index) : _index(index), _total_docs(index.GetTotalDocuments()) {}
+
+        Matches Evaluate(const QueryNode& node) const
+        {
+            switch (node.type)
+            {
+            case QueryNode::Type::Term:
+                return Materialize(node.terms.front());
+            case QueryNode::Type::Phrase:
+                return EvaluatePhrase(node);
+            case QueryNode::Type::Near:
+                return EvaluateNear(node);
+            case QueryNode::Type::Wildcard:
+            case QueryNode::Type::Fuzzy:
+                return EvaluateExpansion(node);
+            case QueryNode::Type::Substring:
+                return EvaluateSubstring(node);
+            case QueryNode::Type::Boolean:
+            default:
+                return EvaluateBoolean(node);
+            }
+        }
+
+    private:
+        // Оценка количества документов в результате узла - для выбора порядка пересечения
+        size_t Estimate(const QueryNode& node) const
+        {
+            switch (node.type)
+            {
+            case QueryNode::Type::Term:
+                return _index.FindPostings(node.terms.front()).entries.size();
+            case QueryNode::Type::Phrase:
+            case QueryNode::Type::Near:
+            {
+                size_t estimate = _total_docs;
+                for (const auto& term : node.terms)
+                {
+                    estimate = std::min(estimate, _index.FindPositionalPostings(term).entries.size());
+                }
+                return estimate;
+            }
+            case QueryNode::Type::Wildcard:
+            case QueryNode::Type::Fuzzy:
+            {
+                size_t estimate = 0;
+                for (const auto& term : node.terms)
+                {
+                    estimate += _index.FindPostings(term).entries.size();
+                }
+                return std::min(estimate, _total_docs);
+            }
+            case QueryNode::Type::Substring:
+                return _index.EstimateSubstring(node.pattern);
+            case QueryNode::Type::Boolean:
+            default:
+            {
+                if (!node.must.empty())
+                {
+                    size_t estimate = _total_docs;
+                    for (const auto& clause : node.must)
+                    {
+                        estimate = std::min(estimate, Estimate(*clause));
+                    }
+                    return estimate;
+                }
+                size_t estimate = 0;
+                for (const auto& clause : node.should)
+                {
+                    estimate += Estimate(*clause);
+                }
+                return std::min(estimate, _total_docs);
+            }
+            }
+        }
+
+        // Вес слова для Scorer::BoostedScore: множитель нечеткого слова boost и общий множитель BOOST_SCALE
+        double Weight(size_t doc_freq, double boost = 1.0) const
+        {
+            return _scorer.TermWeight(doc_freq, _total_docs) * boost * Scorer::BOOST_SCALE;
+        }
+
+        // Документы, содержащие слово, и вклад слова в их релевантность (вес слова умножается на boost)
+        Matches Materialize(const std::string& term, double boost = 1.0) const
+        {
+            const PostingList& postings = _index.FindPostings(term);
+            const double weight = Weight(postings.entries.size(), boost);
+            Matches matches;
+            matches.reserve(postings.entries.size());
+            for (const auto& entry : postings.entries)
+            {
+                matches.emplace_back(entry.doc_id, _scorer.BoostedScore(weight, entry.count));
+            }
+            return matches;
+        }
+
+        // Проходит по документам matches и ищет каждый в списке вхождений слова галопирующим переходом.
+        // keep_missing - оставлять ли документы без слова, keep_found - с ним
+        void ProbeTerm(Matches& matches, const std::string& term, bool keep_found, bool keep_missing) const
+        {
+            const PostingList& postings = _index.FindPostings(term);
+            const double weight = Weight(postings.entries.size());
+            EntryPostingIterator it(postings);
+            size_t out = 0;
+            for (size_t i = 0; i < matches.size(); ++i)
+            {
+                it.Advance(matches[i].first);
+                const bool found = it.Doc() == matches[i].first;
+                if (found && keep_found)
+                {
+                    matches[i].second += _scorer.BoostedScore(weight, it.Count());
+                }
+                if (found ? keep_found : keep_missing)
+                {
+                    matches[out++] = matches[i];
+                }
+            }
+            matches.resize(out);
+        }
+
+        // То же, что ProbeTerm, но для произвольного уже вычисленного результата other
+        void ProbeMatches(Matches& matches, const Matches& other, bool keep_found, bool keep_missing) const
+        {
+            auto it = other.begin();
+            size_t out = 0;
+            for (size_t i = 0; i < matches.size(); ++i)
+            {
+                it = std::lower_bound(it, other.end(), matches[i].first,
+                                      [](const std::pair<size_t, score_type>& match, size_t doc) { return match.first < doc; });
+                const bool found = it != other.end() && it->first == matches[i].first;
+                if (found && keep_found)
+                {
+                    matches[i].second += it->second;
+                }
+                if (found ? keep_found : keep_missing)
+                {
+                    matches[out++] = matches[i];
+                }
+            }
+            matches.resize(out);
+        }
+
+        // Применяет условие clause ко всем документам matches
+        void Probe(Matches& matches, const QueryNode& clause, bool keep_found, bool keep_missing) const
+        {
+            if (matches.empty())
+            {
+                return;
+            }
+            if (clause.type == QueryNode::Type::Term)
+            {
+                ProbeTerm(matches, clause.terms.front(), keep_found, keep_missing);
+            }
+            else
+            {
+                ProbeMatches(matches, Evaluate(clause), keep_found, keep_missing);
+            }
+        }
+
+        // Объединение результатов слиянием через кучу, релевантность одного документа суммируется
+        Matches Union(const std::vector<Matches>& parts) const
+        {
+            using Cursor = std::pair<size_t, size_t>; // {номер части, позиция в ней}
+            const auto greater = [&](const Cursor& a, const Cursor& b)
+            {
+                return parts[a.first][a.second].first > parts[b.first][b.second].first;
+            };
+            std::priority_queue<Cursor, std::vector<Cursor>, decltype(greater)> heap(greater);
+            size_t total = 0;
+            for (size_t i = 0; i < parts.size(); ++i)
+            {
+                if (!parts[i].empty())
+                {
+                    heap.emplace(i, 0);
+                    total += parts[i].size();
+                }
+            }
+            Matches result;
+            result.reserve(total);
+            while (!heap.empty())
+            {
+                auto [part, pos] = heap.top();
+                heap.pop();
+                const auto& match = parts[part][pos];
+                if (!result.empty() && result.back().first == match.first)
+                {
+                    result.back().second += match.second;
+                }
+                else
+                {
+                    result.push_back(match);
+                }
+                if (pos + 1 < parts[part].size())
+                {
+                    heap.emplace(part, pos + 1);
+                }
+            }
+            return result;
+        }
+
+        // Подстрока: документы, найденные индексом триграмм и проверенные по тексту. Слова,
+        // содержащие подстроку, считаются вхождениями одного слова
+        Matches EvaluateSubstring(const QueryNode& node) const
+        {
+            const std::vector<Entry> entries = _index.FindSubstring(node.pattern);
+            const double weight = Weight(entries.size());
+            Matches matches;
+            matches.reserve(entries.size());
+            for (const auto& entry : entries)
+            {
+                matches.emplace_back(entry.doc_id, _scorer.BoostedScore(weight, entry.count));
+            }
+            return matches;
+        }
+
+        // Шаблон или нечеткое слово: объединение списков вхождений подходящих слов. Для немногих
+        // слов или редких вхождений - слиянием через кучу, иначе вклады накапливаются в массиве
+        // по doc_id, а найденные документы отмечаются в битовой карте и выбираются из нее по порядку
+        Matches EvaluateExpansion(const QueryNode& node) const
+        {
+            const auto boost = [&node](size_t i) { return node.boosts.empty() ? 1.0 : node.boosts[i]; };
+            size_t total = 0;
+            for (const auto& term : node.terms)
+            {
+                total += _index.FindPostings(term).entries.size();
+            }
+            if (node.terms.size() <= WILDCARD_HEAP_MAX_TERMS || total * WILDCARD_BITSET_DENSITY < _total_docs)
+            {
+                std::vector<Matches> parts;
+                parts.reserve(node.terms.size());
+                for (size_t i = 0; i < node.terms.size(); ++i)
+                {
+                    parts.push_back(Materialize(node.terms[i], boost(i)));
+                }
+                return parts.size() == 1 ? std::move(parts.front()) : Union(parts);
+            }
+            std::vector<score_type> scores(_total_docs);
+            std::vector<uint64_t> found((_total_docs + 63) / 64);
+            for (size_t i = 0; i < node.terms.size(); ++i)
+            {
+                const PostingList& postings = _index.FindPostings(node.terms[i]);
+                const double weight = Weight(postings.entries.size(), boost(i));
+                for (const auto& entry : postings.entries)
+                {
+                    scores[entry.doc_id] += _scorer.BoostedScore(weight, entry.count);
+                    found[entry.doc_id / 64] |= uint64_t{1} << (entry.doc_id % 64);
+                }
+            }
+            Matches matches;
+            matches.reserve(std::min(total, _total_docs));
+            for (size_t word = 0; word < found.size(); ++word)
+            {
+                for (uint64_t bits = found[word]; bits != 0; bits &= bits - 1)
+                {
+                    const size_t doc_id = word * 64 + static_cast<size_t>(std::countr_zero(bits));
+                    matches.emplace_back(doc_id, scores[doc_id]);
+                }
+            }
+            return matches;
+        }
+
+        // Документы, содержащие все слова terms, без проверки позиций. Стоп-слова не учитываются
+        Matches EvaluateAllTerms(std::vector<std::string> terms) const
+        {
+            terms.erase(std::remove_if(terms.begin(), terms.end(), [&](const std::string& term)
+            {
+                return _index.IsStopword(term);
+            }), terms.end());
+            if (terms.empty())
+            {
+                return {};
+            }
+            std::sort(terms.begin(), terms.end(), [&](const std::string& a, const std::string& b)
+            {
+                return _index.FindPostings(a).entries.size() < _index.FindPostings(b).entries.size();
+            });
+            Matches matches = Materialize(terms.front());
+            for (size_t i = 1; i < terms.size(); ++i)
+            {
+                ProbeTerm(matches, terms[i], true, false);
+            }
+            return matches;
+        }
+
+        // Пересекает списки вхождений слов terms и для каждого общего документа распаковывает
+        // позиции слов. count_matches по позициям (в порядке terms) возвращает, сколько раз
+        // условие выполнено в документе; документы с нулем не попадают в результат.
+        // Релевантность - сумма вкладов слов, как если бы каждое встретилось столько раз
+        template <typename CountMatches>
+        Matches EvaluatePositional(const std::vector<std::string>& terms, CountMatches count_matches) const
+        {
+            std::vector<EntryPostingIterator> iterators;
+            std::vector<const PositionList*> positions;
+            std::vector<double> weights;
+            for (const auto& term : terms)
+            {
+                const PositionList* list = _index.FindPositions(term);
+                if (!list)
+                {
+                    return {};
+                }
+                iterators.emplace_back(_index.FindPositionalPostings(term));
+                positions.push_back(list);
+                weights.push_back(Weight(iterators.back().Size()));
+            }
+            std::vector<std::vector<uint32_t>> decoded(terms.size());
+            Matches matches;
+            size_t candidate = 0;
+            while (true)
+            {
+                // Пересечение перешагиванием: все итераторы догоняют самый дальний документ
+                bool aligned = true;
+                for (auto& it : iterators)
+                {
+                    it.Advance(candidate);
+                    if (it.AtEnd())
+                    {
+                        return matches;
+                    }
+                    if (it.Doc() != candidate)
+                    {
+                        candidate = it.Doc();
+                        aligned = false;
+                    }
+                }
+                if (!aligned)
+                {
+                    continue;
+                }
+                for (size_t i = 0; i < iterators.size(); ++i)
+                {
+                    DecodePositions(*positions[i], iterators[i].Ordinal(), iterators[i].Count(), decoded[i]);
+                }
+                if (const size_t frequency = count_matches(decoded); frequency > 0)
+                {
+                    score_type score{};
+                    for (double weight : weights)
+                    {
+                        score += _scorer.BoostedScore(weight, frequency);
+                    }
+                    matches.emplace_back(candidate, score);
+                }
+                ++candidate;
+            }
+        }
+
+        // Фраза: слова стоят подряд в указанном порядке
+        Matches EvaluatePhrase(const QueryNode& node) const
+        {
+            if (!_index.HasPositions())
+            {
+                return EvaluateAllTerms(node.terms);
+            }
+            // Стоп-слова без позиций пропускаются, но их места во фразе учитываются
+            std::vector<std::string> terms;
+            std::vector<uint32_t> offsets;
+            for (size_t i = 0; i < node.terms.size(); ++i)
+            {
+                if (!_index.IsStopword(node.terms[i]) || _index.FindPositions(node.terms[i]))
+                {
+                    terms.push_back(node.terms[i]);
+                    offsets.push_back(static_cast<uint32_t>(i));
+                }
+            }
+            if (terms.empty())
+            {
+                return {};
+            }
+            return EvaluatePositional(terms, [&offsets](const std::vector<std::vector<uint32_t>>& decoded)
+            {
+                size_t frequency = 0;
+                for (uint32_t start : decoded.front())
+                {
+                    bool found = true;
+                    for (size_t i = 1; i < decoded.size() && found; ++i)
+                    {
+                        found = std::binary_search(decoded[i].begin(), decoded[i].end(), start + offsets[i] - offsets[0]);
+                    }
+                    frequency += found;
+                }
+                return frequency;
+            });
+        }
+
+        // NEAR/k: вхождения первого слова, рядом с которыми (не дальше k слов) есть второе
+        Matches EvaluateNear(const QueryNode& node) const
+        {
+            if (!_index.HasPositions())
+            {
+                return EvaluateAllTerms(node.terms);
+            }
+            const size_t distance = node.distance;
+            return EvaluatePositional(node.terms, [distance](const std::vector<std::vector<uint32_t>>& decoded)
+            {
+                const auto& left = decoded[0];
+                const auto& right = decoded[1];
+                size_t frequency = 0;
+                size_t j = 0;
+                for (uint32_t position : left)
+                {
+                    // Оба списка возрастают - указатель по второму только движется вперед
+                    while (j < right.size() && right[j] + distance < position)
+                    {
+                        ++j;
+                    }
+                    // Одно и то же слово (a NEAR a) не считается соседом самого себя
+                    size_t k = j;
+                    while (k < right.size() && right[k] == position)
+                    {
+                        ++k;
+                    }
+                    frequency += k < right.size() && right[k] <= position + distance;
+                }
+                return frequency;
+            });
+        }
+
+        Matches EvaluateBoolean(const QueryNode& node) const
+        {
+            Matches matches;
+            if (!node.must.empty())
+            {
+                // Пересечение: начинаем с самого узкого условия, остальные проверяем для его документов
+                std::vector<const QueryNode*> must;
+                for (const auto& clause : node.must)
+                {
+                    must.push_back(clause.get());
+                }
+                std::sort(must.begin(), must.end(), [&](const QueryNode* a, const QueryNode* b)
+                {
+                    return Estimate(*a) < Estimate(*b);
+                });
+                matches = Evaluate(*must.front());
+                for (size_t i = 1; i < must.size(); ++i)
+                {
+                    Probe(matches, *must[i], true, false);
+                }
+                // Необязательные условия только добавляют релевантность
+                for (const auto& clause : node.should)
+                {
+                    Probe(matches, *clause, true, true);
+                }
+            }
+            else if (!node.should.empty())
+            {
+                std::vector<Matches> parts;
+                parts.reserve(node.should.size());
+                for (const auto& clause : node.should)
+                {
+                    parts.push_back(Evaluate(*clause));
+                }
+                matches = parts.size() == 1 ? std::move(parts.front()) : Union(parts);
+            }
+            // Исключения - пропуском по их спискам вхождений
+            for (const auto& clause : node.must_not)
+            {
+                Probe(matches, *clause, false, true);
+            }
+            return matches;
+        }
+
+        const InvertedIndex& _index;
+        size_t _total_docs;
+        Scorer _scorer;
+    };
+}
+
+CompiledQuery CompileQuery(const std::string& query, const InvertedIndex& index, QuerySyntax syntax, QueryMode mode,
+                           size_t wildcard_limit, size_t fuzzy_limit)
+{
+    if (syntax == QuerySyntax::Plain)
+    {
+        NodePtr root = ParsePlain(query, index, mode, wildcard_limit, fuzzy_limit);
+        return CompiledQuery{ root, CanonicalForm(*root), query, index.GetVersion() };
+    }
+    NodePtr root = Parser(Tokenize(query), index, mode, wildcard_limit, fuzzy_limit).Parse();
+    if (root && root->type != QueryNode::Type::Boolean)
+    {
+        // Корень всегда группа - так проще выбирать физические операторы
+        auto group = std::make_shared<QueryNode>();
+        AddClause(*group, root, mode == QueryMode::All ? Occur::Must : Occur::Should);
+        root = group;
+    }
+    return CompiledQuery{ root, root ? CanonicalForm(*root) : std::string(), query, index.GetVersion() };
+}
+
+template <typename Scorer>
+std::vector<RelativeIndex> EvaluateQueryTree(const QueryNode& root, const InvertedIndex& index, size_t limit)
+{
+    const auto matches = TreeEvaluator<Scorer>(index).Evaluate(root);
+    TopKCollector<typename Scorer::score_type> top(limit);
+    for (const auto& [doc_id, score] : matches)
+    {
+        top.Push(doc_id, score);
+    }
+    return top.Rank();
+}
+
+template std::vector<RelativeIndex> EvaluateQueryTree<TermCountScorer>(const QueryNode&, const InvertedIndex&, size_t);
+template std::vector<RelativeIndex> EvaluateQueryTree<TfIdfScorer>(const QueryNode&, const InvertedIndex&, size_t);
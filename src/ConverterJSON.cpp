@@ -49,6 +49,8 @@ bool ConverterJSON::CheckConfigFiles() const {
 std::vector<std::string> ConverterJSON::GetTextDocuments()
 {
     std::vector<std::string> documents;
+    _load_metrics = IndexingMetrics();
+    IndexingProgress progress(_load_metrics, _observer, _observer_interval);
     // Открытие и чтение конфигурационного файла
     const std::string configPath(GetJsonPath("config.json")); // Сохраняем путь для сообщений об ошибках
     std::ifstream config_file(configPath);
@@ -87,17 +89,22 @@ std::vector<std::string> ConverterJSON::GetTextDocuments()
 
                 if (!content.empty())
                 {
+                    _load_metrics.bytes += content.size();
                     documents.push_back(std::move(content));
                 }
                 doc_file.close();
             } else {
                 std::cerr << "Error: Could not open document file: " << path << std::endl;
             }
+            progress.Lap(_load_metrics.read_seconds);
+            _load_metrics.documents = documents.size();
+            progress.Tick();
         }
     }
     catch (const json::exception& e) {
         std::cerr << "JSON parsing error in GetTextDocuments: " << e.what() << std::endl;
     }
+    progress.Finish();
     return documents;
 }
 
@@ -133,6 +140,206 @@ int ConverterJSON::GetResponsesLimit()
     return 5; // Возвращаем значение по умолчанию
 }
 
+// Метод считывает необязательную секцию search с настройками обработки запросов
+SearchOptions ConverterJSON::GetSearchOptions()
+{
+    SearchOptions options;
+    const std::string configPath = GetJsonPath("config.json");
+    std::ifstream config_file(configPath);
+
+    if (!config_file.is_open())
+    {
+        std::cerr << "Warning: Could not open config.json, using default search options" << std::endl;
+        return options;
+    }
+    try
+    {
+        json config = json::parse(config_file);
+        config_file.close();
+
+        if (!config.contains("search"))
+        {
+            return options;
+        }
+        const json& search = config["search"];
+
+        if (search.contains("scorer"))
+        {
+            options.scorer = ParseScorerType(search["scorer"].get<std::string>());
+        }
+        if (search.contains("strategy"))
+        {
+            options.strategy = ParseEvaluationStrategy(search["strategy"].get<std::string>());
+        }
+        if (search.contains("mode"))
+        {
+            options.mode = ParseQueryMode(search["mode"].get<std::string>());
+        }
+        if (search.contains("syntax"))
+        {
+            options.syntax = ParseQuerySyntax(search["syntax"].get<std::string>());
+        }
+        if (search.contains("cache_size"))
+        {
+            const int cache_size = search["cache_size"].get<int>();
+            if (cache_size < 0)
+            {
+                std::cerr << "Warning: cache_size must be non-negative, using default value: "
+                          << options.cache_capacity << std::endl;
+            }
+            else
+            {
+                options.cache_capacity = static_cast<size_t>(cache_size);
+            }
+        }
+        if (search.contains("posting_cache_mb"))
+        {
+            const int posting_cache_mb = search["posting_cache_mb"].get<int>();
+            if (posting_cache_mb < 0)
+            {
+                std::cerr << "Warning: posting_cache_mb must be non-negative, using default value: "
+                          << (options.posting_cache_bytes >> 20) << std::endl;
+            }
+            else
+            {
+                options.posting_cache_bytes = static_cast<size_t>(posting_cache_mb) << 20;
+            }
+        }
+        if (search.contains("wildcard_limit"))
+        {
+            const int wildcard_limit = search["wildcard_limit"].get<int>();
+            if (wildcard_limit < 0)
+            {
+                std::cerr << "Warning: wildcard_limit must be non-negative, using default value: "
+                          << options.wildcard_limit << std::endl;
+            }
+            else
+            {
+                options.wildcard_limit = static_cast<size_t>(wildcard_limit);
+            }
+        }
+        if (search.contains("fuzzy_limit"))
+        {
+            const int fuzzy_limit = search["fuzzy_limit"].get<int>();
+            if (fuzzy_limit < 0)
+            {
+                std::cerr << "Warning: fuzzy_limit must be non-negative, using default value: "
+                          << options.fuzzy_limit << std::endl;
+            }
+            else
+            {
+                options.fuzzy_limit = static_cast<size_t>(fuzzy_limit);
+            }
+        }
+        if (search.contains("suggestion_distance"))
+        {
+            const int suggestion_distance = search["suggestion_distance"].get<int>();
+            if (suggestion_distance < 0)
+            {
+                std::cerr << "Warning: suggestion_distance must be non-negative, using default value: "
+                          << options.suggestion_distance << std::endl;
+            }
+            else
+            {
+                options.suggestion_distance = static_cast<size_t>(suggestion_distance);
+            }
+        }
+        if (search.contains("profile"))
+        {
+            options.profile_file = search["profile"].get<std::string>();
+        }
+        if (search.contains("slow_query_ms"))
+        {
+            const double slow_query_ms = search["slow_query_ms"].get<double>();
+            if (slow_query_ms < 0)
+            {
+                std::cerr << "Warning: slow_query_ms must be non-negative, slow query log is disabled" << std::endl;
+            }
+            else
+            {
+                options.slow_query_ms = slow_query_ms;
+            }
+        }
+        if (search.contains("slow_query_log"))
+        {
+            options.slow_query_log = search["slow_query_log"].get<std::string>();
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << "JSON parsing error in GetSearchOptions: " << e.what() << std::endl;
+    }
+    return options;
+}
+
+// Метод считывает необязательную секцию index с настройками построения индекса
+IndexOptions ConverterJSON::GetIndexOptions()
+{
+    IndexOptions options;
+    const std::string configPath = GetJsonPath("config.json");
+    std::ifstream config_file(configPath);
+
+    if (!config_file.is_open())
+    {
+        std::cerr << "Warning: Could not open config.json, using default index options" << std::endl;
+        return options;
+    }
+    try
+    {
+        json config = json::parse(config_file);
+        config_file.close();
+
+        if (!config.contains("index"))
+        {
+            return options;
+        }
+        const json& index = config["index"];
+
+        if (index.contains("positions"))
+        {
+            options.positions = index["positions"].get<bool>();
+        }
+        if (index.contains("stemmer"))
+        {
+            options.stemmer = ParseStemmerType(index["stemmer"].get<std::string>());
+        }
+        if (index.contains("stopwords"))
+        {
+            // Название встроенного списка или список слов
+            const json& stopwords = index["stopwords"];
+            options.stopwords = stopwords.is_string() ? GetBuiltinStopwords(stopwords.get<std::string>())
+                                                      : stopwords.get<std::vector<std::string>>();
+        }
+        if (index.contains("stopwords_in_positions"))
+        {
+            options.stopwords_in_positions = index["stopwords_in_positions"].get<bool>();
+        }
+        if (index.contains("substrings"))
+        {
+            options.substrings = index["substrings"].get<bool>();
+        }
+        if (index.contains("suggestions"))
+        {
+            options.suggestions = index["suggestions"].get<bool>();
+        }
+        if (index.contains("progress_interval"))
+        {
+            const double progress_interval = index["progress_interval"].get<double>();
+            if (progress_interval < 0)
+            {
+                std::cerr << "Warning: progress_interval must be non-negative, progress reports are disabled" << std::endl;
+            }
+            else
+            {
+                options.progress_interval = progress_interval;
+            }
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << "JSON parsing error in GetIndexOptions: " << e.what() << std::endl;
+    }
+    return options;
+}
+
 // Метод получения запросов из файла requests.json
 // return Возвращает список запросов из файла requests.json
 std::vector<std::string> ConverterJSON::GetRequests()
@@ -173,7 +380,8 @@ std::vector<std::string> ConverterJSON::GetRequests()
 
 // Метод записи ответов
 // Положить в файл answers.json результаты поисковых запросов
-void ConverterJSON::putAnswers(std::vector<std::vector<std::pair<int, float>>> answers)
+void ConverterJSON::putAnswers(std::vector<std::vector<std::pair<int, float>>> answers,
+                               const std::vector<std::string>& suggestions)
 {
     const std::string answersPath = GetJsonPath("answers.json");
     std::ofstream output_file;
@@ -195,14 +403,17 @@ void ConverterJSON::putAnswers(std::vector<std::vector<std::pair<int, float>>> a
         {
             const auto& answer = answers[i]; // Ссылка для избежания копирования
 
-            // Форматируем номер запроса с ведущими нулями (001, 002...)
-            std::string requestKey = "request" +
-                                     std::string(3 - std::to_string(i + 1).length(), '0') +
-                                     std::to_string(i + 1);
+            // Форматируем номер запроса с ведущими нулями до трех цифр (001, 002..., 1000)
+            const std::string number = std::to_string(i + 1);
+            std::string requestKey = "request" + std::string(number.size() < 3 ? 3 - number.size() : 0, '0') + number;
 
             // Создаем json объект для текущего запроса и добавляем его в поле answers
             ordered_json requestResult;
             requestResult["result"] = !answer.empty();
+            if (answer.empty() && i < suggestions.size() && !suggestions[i].empty())
+            {
+                requestResult["suggestion"] = suggestions[i]; // "возможно, вы имели в виду"
+            }
 
             // Если ответ не пустой, заполняем поле docid и rank
             if (!answer.empty())
@@ -253,4 +464,4 @@ void ConverterJSON::putAnswers(std::vector<std::vector<std::pair<int, float>>> a
         throw; // Передаем исключение дальше
     }
     output_file.close();
-}
\ No newline at end of file
+}
@@ -0,0 +1,324 @@
+#include "FuzzyTerm.h"
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+
+namespace
+{
+    // Состояние недетерминированного автомата в одном числе
+    constexpr uint32_t Position(size_t index, size_t edits, bool transposing)
+    {
+        return static_cast<uint32_t>(index * 8 + edits * 2 + (transposing ? 1 : 0));
+    }
+
+    constexpr size_t PositionIndex(uint32_t position) { return position / 8; }
+
+    constexpr size_t PositionEdits(uint32_t position) { return (position % 8) / 2; }
+
+    constexpr bool PositionTransposing(uint32_t position) { return (position & 1) != 0; }
+}
+
+// Символы UTF-8 строки. Некорректный байт считается отдельным символом
+std::vector<uint32_t> DecodeUtf8(std::string_view text)
+{
+    std::vector<uint32_t> code_points;
+    code_points.reserve(text.size());
+    for (size_t i = 0; i < text.size();)
+    {
+        const auto lead = static_cast<uint8_t>(text[i]);
+        const size_t length = lead < 0x80 ? 1 : (lead & 0xE0) == 0xC0 ? 2 : (lead & 0xF0) == 0xE0 ? 3 :
+                              (lead & 0xF8) == 0xF0 ? 4 : 1;
+        if (length == 1 || i + length > text.size())
+        {
+            code_points.push_back(lead);
+            ++i;
+            continue;
+        }
+        uint32_t c = lead & (0x7F >> length);
+        for (size_t j = 1; j < length; ++j)
+        {
+            c = (c << 6) | (static_cast<uint8_t>(text[i + j]) & 0x3F);
+        }
+        code_points.push_back(c);
+        i += length;
+    }
+    return code_points;
+}
+
+// Распознает "слово~k"
+bool ParseFuzzyTerm(std::string_view word, std::string& base, size_t& distance)
+{
+    const size_t tilde = word.rfind('~');
+    if (tilde == std::string_view::npos || tilde == 0)
+    {
+        return false;
+    }
+    const std::string_view digits = word.substr(tilde + 1);
+    if (!std::all_of(digits.begin(), digits.end(), [](char c) { return std::isdigit(static_cast<unsigned char>(c)); }))
+    {
+        return false;
+    }
+    distance = MAX_FUZZY_DISTANCE;
+    if (!digits.empty())
+    {
+        // Число, не помещающееся в size_t, тоже ограничивается MAX_FUZZY_DISTANCE
+        size_t value = 0;
+        if (std::from_chars(digits.data(), digits.data() + digits.size(), value).ec == std::errc())
+        {
+            distance = std::min(value, MAX_FUZZY_DISTANCE);
+        }
+    }
+    base = word.substr(0, tilde);
+    return true;
+}
+
+// Ограниченное расстояние Дамерау-Левенштейна по символам
+size_t EditDistance(std::string_view a, std::string_view b)
+{
+    const std::vector<uint32_t> x = DecodeUtf8(a);
+    const std::vector<uint32_t> y = DecodeUtf8(b);
+    // Три последние строки таблицы: перестановке нужна строка на две выше текущей
+    std::vector<size_t> before(y.size() + 1);
+    std::vector<size_t> previous(y.size() + 1);
+    std::vector<size_t> current(y.size() + 1);
+    for (size_t j = 0; j <= y.size(); ++j)
+    {
+        previous[j] = j;
+    }
+    for (size_t i = 1; i <= x.size(); ++i)
+    {
+        current[0] = i;
+        for (size_t j = 1; j <= y.size(); ++j)
+        {
+            const size_t cost = x[i - 1] == y[j - 1] ? 0 : 1;
+            current[j] = std::min({ previous[j] + 1, current[j - 1] + 1, previous[j - 1] + cost });
+            if (i > 1 && j > 1 && x[i - 1] == y[j - 2] && x[i - 2] == y[j - 1])
+            {
+                current[j] = std::min(current[j], before[j - 2] + 1);
+            }
+        }
+        std::swap(before, previous);
+        std::swap(previous, current);
+    }
+    return previous[y.size()];
+}
+
+LevenshteinAutomaton::LevenshteinAutomaton(std::string_view word, size_t distance)
+    : _word(DecodeUtf8(word)), _distance(distance)
+{
+    State start;
+    AddClosure(start.positions, 0, 0, false);
+    _start = Intern(std::move(start));
+}
+
+// Удаление символа слова не читает входа, поэтому добавляется вместе с состоянием
+void LevenshteinAutomaton::AddClosure(std::vector<uint32_t>& positions, size_t index, size_t edits, bool transposing) const
+{
+    positions.push_back(Position(index, edits, transposing));
+    if (!transposing && index < _word.size() && edits < _distance)
+    {
+        AddClosure(positions, index + 1, edits + 1, false);
+    }
+}
+
+std::vector<uint32_t> LevenshteinAutomaton::StepCodePoint(const std::vector<uint32_t>& positions, uint32_t code_point) const
+{
+    std::vector<uint32_t> next;
+    for (const uint32_t position : positions)
+    {
+        const size_t index = PositionIndex(position);
+        const size_t edits = PositionEdits(position);
+        if (PositionTransposing(position))
+        {
+            // Вторая половина перестановки: после word[index + 1] прочитан word[index]
+            if (index + 1 < _word.size() && code_point == _word[index])
+            {
+                AddClosure(next, index + 2, edits, false);
+            }
+            continue;
+        }
+        if (index < _word.size() && _word[index] == code_point)
+        {
+            AddClosure(next, index + 1, edits, false);
+        }
+        if (edits < _distance)
+        {
+            AddClosure(next, index, edits + 1, false); // Вставка
+            if (index < _word.size())
+            {
+                AddClosure(next, index + 1, edits + 1, false); // Замена
+            }
+            if (index + 1 < _word.size() && _word[index + 1] == code_point && _word[index] != code_point)
+            {
+                AddClosure(next, index, edits + 1, true); // Начало перестановки
+            }
+        }
+    }
+    std::sort(next.begin(), next.end());
+    next.erase(std::unique(next.begin(), next.end()), next.end());
+    return next;
+}
+
+int LevenshteinAutomaton::Intern(State state)
+{
+    if (state.positions.empty())
+    {
+        return -1;
+    }
+    if (auto it = _ids.find(state); it != _ids.end())
+    {
+        return it->second;
+    }
+    const int id = static_cast<int>(_states.size());
+    bool match = false;
+    if (state.pending == 0)
+    {
+        for (const uint32_t position : state.positions)
+        {
+            match |= !PositionTransposing(position) && PositionIndex(position) == _word.size();
+        }
+    }
+    _matches.push_back(match);
+    _ids.emplace(state, id);
+    _states.push_back(std::move(state));
+    _transitions.emplace_back();
+    _transitions.back().fill(-2);
+    return id;
+}
+
+int LevenshteinAutomaton::Step(int state, uint8_t byte)
+{
+    if (const int cached = _transitions[state][byte]; cached != -2)
+    {
+        return cached;
+    }
+    const State& current = _states[state];
+    State next;
+    int id = -1;
+    if (current.pending > 0)
+    {
+        // Продолжение многобайтового символа
+        if ((byte & 0xC0) == 0x80)
+        {
+            const uint32_t partial = (current.partial << 6) | (byte & 0x3F);
+            if (current.pending > 1)
+            {
+                next.partial = partial;
+                next.pending = current.pending - 1;
+                next.positions = current.positions;
+            }
+            else
+            {
+                next.positions = StepCodePoint(current.positions, partial);
+            }
+            id = Intern(std::move(next));
+        }
+    }
+    else if (byte < 0x80)
+    {
+        next.positions = StepCodePoint(current.positions, byte);
+        id = Intern(std::move(next));
+    }
+    else if ((byte & 0xC0) != 0x80)
+    {
+        // Первый байт многобайтового символа: переход по символу - после последнего байта
+        next.pending = (byte & 0xE0) == 0xC0 ? 1 : (byte & 0xF0) == 0xE0 ? 2 : 3;
+        next.partial = byte & (0x3F >> next.pending);
+        next.positions = current.positions;
+        id = Intern(std::move(next));
+    }
+    _transitions[state][byte] = id;
+    return id;
+}
+
+// Слова словаря на расстоянии не больше distance
+std::vector<FuzzyMatch> ExpandFuzzy(const InvertedIndex& index, const std::string& term, size_t distance, size_t limit)
+{
+    const TermDictionary& dictionary = index.GetTermDictionary();
+    std::vector<std::pair<uint32_t, size_t>> found; // {номер слова, расстояние}
+    LevenshteinAutomaton automaton(term, distance);
+    dictionary.Intersect(automaton, [&](const std::string& candidate, uint32_t id)
+    {
+        found.emplace_back(id, EditDistance(term, candidate));
+        return true;
+    });
+    if (found.size() > limit)
+    {
+        std::nth_element(found.begin(), found.begin() + static_cast<std::ptrdiff_t>(limit), found.end(),
+                         [&index](const auto& a, const auto& b)
+        {
+            if (a.second != b.second)
+            {
+                return a.second < b.second;
+            }
+            const size_t a_size = index.GetPostings(a.first).entries.size();
+            const size_t b_size = index.GetPostings(b.first).entries.size();
+            return a_size != b_size ? a_size > b_size : a.first < b.first;
+        });
+        found.resize(limit);
+        std::sort(found.begin(), found.end());
+    }
+    std::vector<FuzzyMatch> matches;
+    matches.reserve(found.size());
+    for (const auto& [id, edits] : found)
+    {
+        matches.push_back({ dictionary.Term(id), edits });
+    }
+    return matches;
+}
+
+// Исправления слова: ближайшие, затем самые частые слова словаря
+std::vector<FuzzyMatch> SuggestTerms(const InvertedIndex& index, const std::string& term, size_t distance, size_t limit)
+{
+    const TermDictionary& dictionary = index.GetTermDictionary();
+    const SpellingIndex& spelling = index.GetSpellingIndex();
+    std::vector<std::pair<uint32_t, size_t>> found; // {номер слова, расстояние}
+    if (!spelling.Empty() && distance <= spelling.MaxDistance())
+    {
+        // Кандидаты индекса удалений проверяются точным расстоянием. Большинство опечаток -
+        // одна правка, поэтому следующее расстояние просматривается, только если ближе
+        // нашлось меньше limit слов: кандидатов на одну правку в разы меньше
+        for (size_t edits = 0; edits <= distance && found.size() < limit; ++edits)
+        {
+            for (const uint32_t id : spelling.Candidates(term, edits))
+            {
+                if (EditDistance(term, dictionary.Term(id)) == edits)
+                {
+                    found.emplace_back(id, edits);
+                }
+            }
+        }
+    }
+    else
+    {
+        LevenshteinAutomaton automaton(term, distance);
+        dictionary.Intersect(automaton, [&](const std::string& candidate, uint32_t id)
+        {
+            found.emplace_back(id, EditDistance(term, candidate));
+            return true;
+        });
+    }
+    const auto better = [&index](const auto& a, const auto& b)
+    {
+        if (a.second != b.second)
+        {
+            return a.second < b.second;
+        }
+        const size_t a_size = index.GetPostings(a.first).entries.size();
+        const size_t b_size = index.GetPostings(b.first).entries.size();
+        return a_size != b_size ? a_size > b_size : a.first < b.first;
+    };
+    if (found.size() > limit)
+    {
+        std::nth_element(found.begin(), found.begin() + static_cast<std::ptrdiff_t>(limit), found.end(), better);
+        found.resize(limit);
+    }
+    std::sort(found.begin(), found.end(), better);
+    std::vector<FuzzyMatch> matches;
+    matches.reserve(found.size());
+    for (const auto& [id, edits] : found)
+    {
+        matches.push_back({ dictionary.Term(id), edits });
+    }
+    return matches;
+}
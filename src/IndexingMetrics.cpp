@@ -0,0 +1,99 @@
+#include "IndexingMetrics.h"
+#include <iomanip>
+#include <sstream>
+#include <utility>
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <psapi.h>
+#elif defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+size_t GetPeakMemoryBytes()
+{
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+    {
+        return counters.PeakWorkingSetSize;
+    }
+    return 0;
+#elif defined(__unix__) || defined(__APPLE__)
+    rusage usage{};
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+    {
+        return 0;
+    }
+#if defined(__APPLE__)
+    return static_cast<size_t>(usage.ru_maxrss); // в байтах
+#else
+    return static_cast<size_t>(usage.ru_maxrss) * 1024; // в килобайтах
+#endif
+#else
+    return 0;
+#endif
+}
+
+std::string FormatIndexingMetrics(const IndexingMetrics& metrics)
+{
+    constexpr double MB = 1 << 20;
+    const double seconds = metrics.seconds > 0 ? metrics.seconds : 1e-9;
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(1) << metrics.documents << " docs, " << metrics.bytes / MB << " MB, "
+        << std::setprecision(0) << metrics.documents / seconds << " docs/s, " << std::setprecision(1)
+        << metrics.bytes / MB / seconds << " MB/s, " << metrics.tokens << " tokens, " << metrics.unique_terms
+        << " terms, postings " << metrics.posting_bytes / MB << " MB";
+    if (metrics.peak_memory > 0)
+    {
+        out << ", peak memory " << metrics.peak_memory / MB << " MB (+" << metrics.memory_growth / MB << " MB)";
+    }
+    const double phases = metrics.read_seconds + metrics.tokenize_seconds + metrics.dictionary_seconds +
+                          metrics.postings_seconds + metrics.finalize_seconds;
+    if (phases > 0)
+    {
+        // Доли этапов, которые выполнялись; ведущий этап показывает, во что упирается работа
+        const std::pair<const char*, double> parts[] = {
+            { "read", metrics.read_seconds },
+            { "tokenize", metrics.tokenize_seconds },
+            { "dictionary", metrics.dictionary_seconds },
+            { "postings", metrics.postings_seconds },
+            { "finalize", metrics.finalize_seconds }
+        };
+        out << ", time:" << std::setprecision(0);
+        for (const auto& [name, part] : parts)
+        {
+            if (part > 0)
+            {
+                out << ' ' << name << ' ' << 100 * part / phases << '%';
+            }
+        }
+    }
+    out << std::setprecision(2) << " (" << metrics.seconds << " s)";
+    return out.str();
+}
+
+IndexingProgress::IndexingProgress(IndexingMetrics& metrics, const IndexingObserver& observer, double interval)
+    : _metrics(metrics),
+      _observer(observer),
+      _interval(interval),
+      _start(std::chrono::steady_clock::now()),
+      _last(_start),
+      _reported(_start),
+      _initial_peak(GetPeakMemoryBytes())
+{
+}
+
+void IndexingProgress::Report(bool finished)
+{
+    const auto now = std::chrono::steady_clock::now();
+    _reported = now;
+    _metrics.seconds = std::chrono::duration<double>(now - _start).count();
+    _metrics.peak_memory = GetPeakMemoryBytes();
+    _metrics.memory_growth = _metrics.peak_memory > _initial_peak ? _metrics.peak_memory - _initial_peak : 0;
+    _metrics.finished = finished;
+    if (_observer)
+    {
+        _observer(_metrics);
+    }
+}
@@ -1,19 +1,81 @@
-#include <cctype>
 #include <algorithm>
 #include <sstream>
+#include <unordered_map>
 #include "InvertedIndex.h"
+#include "Stemmer.h"
+#include "TextNormalizer.h"
+
+namespace
+{
+    // Подстроки короче трех байтов не имеют триграмм - для них проверяются все документы
+    constexpr size_t TRIGRAM_LENGTH = 3;
+
+    // Дописывает триграммы нормализованного слова: три подряд идущих байта в одном числе
+    void AppendTrigrams(std::string_view word, std::vector<uint32_t>& out)
+    {
+        for (size_t i = 0; i + TRIGRAM_LENGTH <= word.size(); ++i)
+        {
+            out.push_back(static_cast<uint32_t>(static_cast<uint8_t>(word[i])) << 16 |
+                          static_cast<uint32_t>(static_cast<uint8_t>(word[i + 1])) << 8 |
+                          static_cast<uint32_t>(static_cast<uint8_t>(word[i + 2])));
+        }
+    }
+
+    // Количество слов документа, нормализованный вид которых содержит подстроку
+    size_t CountSubstringWords(const std::string& doc, const std::string& substring)
+    {
+        std::istringstream iss(doc);
+        std::string word;
+        size_t count = 0;
+        while (iss >> word)
+        {
+            count += NormalizeWord(word).find(substring) != std::string::npos;
+        }
+        return count;
+    }
+}
 
 // Обновляет базу документов, передается вектор строк с содержимым документов
 void InvertedIndex::UpdateDocumentBase(std::vector<std::string> input_docs)
 {
-    if (input_docs.empty()) // проверка на пустой вектор
+    ++_version; // любые результаты, вычисленные по старой базе, устарели
+    docs = std::move(input_docs); // перемещаем вектор (вместо копирования)
+    _terms.Clear();               // очищаем словарь
+    _postings.clear();            // очищаем списки вхождений
+    _positions.clear();           // очищаем позиции слов
+    stopword_dictionary.clear();  // очищаем вхождения стоп-слов
+    stopword_positions.clear();
+    _trigrams.clear();            // очищаем индекс триграмм
+    _spelling.Clear();            // очищаем индекс удалений
+    _surface_forms.clear();       // очищаем написания слов
+    _doc_lengths.assign(docs.size(), 0);
+    _total_tokens = 0;
+    _metrics = IndexingMetrics();
+    IndexingProgress progress(_metrics, _observer, _observer_interval);
+    ApplyOptions();
+    if (docs.empty()) // проверка на пустой вектор
     {
-        docs.clear();            // очищаем вектор
-        freq_dictionary.clear(); // очищаем словарь
-        return;                  // выходим из функции
+        progress.Finish();
+        return;
     }
-    docs = std::move(input_docs); // перемещаем вектор (вместо копирования)
-    freq_dictionary.clear();      // очищаем частотный словарь
+
+    // Пока документы читаются, слова получают временные номера в порядке появления,
+    // так что строка слова хранится один раз, а не копируется для каждого вхождения
+    std::unordered_map<std::string, uint32_t> build_ids;
+    std::vector<std::string> build_terms;        // слово по временному номеру
+    std::vector<PostingList> build_postings;     // вхождения по временному номеру
+    std::vector<PositionList> build_positions;   // позиции по временному номеру
+    // Со стеммером - написания слова до стемминга и их количества по временному номеру
+    std::vector<std::unordered_map<std::string, size_t>> build_surfaces;
+
+    // Вхождения текущего документа: пары (временный номер слова, позиция)
+    std::vector<std::pair<uint32_t, uint32_t>> tokens;
+    std::vector<uint32_t> positions;
+    std::vector<uint32_t> trigrams; // триграммы слов текущего документа
+    // Нормализованные слова текущего документа. Документ сначала целиком разбивается на слова,
+    // затем слова ищутся в словаре - так время этих этапов измеряется раз на документ
+    std::vector<std::string> words;
+    std::vector<std::string> surfaces; // те же слова до стемминга (только со стеммером)
 
     // Обрабатываем каждый документ
     for (size_t doc_id = 0; doc_id < docs.size(); ++doc_id)
@@ -21,7 +83,9 @@ void InvertedIndex::UpdateDocumentBase(std::vector<std::string> input_docs)
         if (docs[doc_id].empty()) continue; // пропускаем пустые документы
 
         std::istringstream iss(docs[doc_id]); // создаем строковый поток для чтения из содержимого документа
-        std::map<std::string, size_t> word_counts; // временный словарь для подсчета количества слов в документе
+        tokens.clear();
+        trigrams.clear();
+        uint32_t position = 0; // номер текущего непустого слова в документе
 
         std::string word;
 
@@ -30,20 +94,210 @@ void InvertedIndex::UpdateDocumentBase(std::vector<std::string> input_docs)
         while (iss >> word)
         {
             // Нормализуем слово(приводим к нижнему регистру и удаляем ненужные символы)
-            word = normalizeWord(word);
+            word = NormalizeWord(word);
+            if (_has_substrings)
+            {
+                AppendTrigrams(word, trigrams); // подстроки ищутся в словах без стемминга
+            }
 
             if (!word.empty()) // Если после нормализации слово не пустое
             {
-                ++word_counts[word]; // Увеличиваем счетчик для этого слова
+                if (position == words.size())
+                {
+                    words.emplace_back();
+                    surfaces.emplace_back();
+                }
+                if (_stemmer != StemmerType::None)
+                {
+                    words[position] = StemWord(_stemmer, word); // основа слова
+                    surfaces[position].swap(word);
+                }
+                else
+                {
+                    words[position].swap(word);
+                }
+                ++position; // стоп-слова тоже занимают позицию, чтобы фразы учитывали пропуск
+            }
+        }
+        progress.Lap(_metrics.tokenize_seconds);
+
+        for (uint32_t i = 0; i < position; ++i)
+        {
+            if (_stopword_positions || !IsStopword(words[i]))
+            {
+                auto [it, inserted] = build_ids.try_emplace(words[i], static_cast<uint32_t>(build_terms.size()));
+                if (inserted)
+                {
+                    build_terms.push_back(words[i]);
+                    build_postings.emplace_back();
+                    if (_has_positions)
+                    {
+                        build_positions.emplace_back();
+                    }
+                    if (_stemmer != StemmerType::None)
+                    {
+                        build_surfaces.emplace_back();
+                    }
+                }
+                tokens.emplace_back(it->second, i);
+                if (_stemmer != StemmerType::None)
+                {
+                    ++build_surfaces[it->second][surfaces[i]];
+                }
+            }
+        }
+        progress.Lap(_metrics.dictionary_seconds);
+        _doc_lengths[doc_id] = position;
+        _total_tokens += position;
+        // Документ попадает в список каждой своей триграммы один раз
+        std::sort(trigrams.begin(), trigrams.end());
+        trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+        for (const uint32_t trigram : trigrams)
+        {
+            _trigrams[trigram].push_back(static_cast<uint32_t>(doc_id));
+        }
+        // Группируем вхождения по словам, позиции внутри слова идут по возрастанию
+        std::sort(tokens.begin(), tokens.end());
+        for (size_t begin = 0; begin < tokens.size();)
+        {
+            const uint32_t id = tokens[begin].first;
+            size_t end = begin;
+            positions.clear();
+            while (end < tokens.size() && tokens[end].first == id)
+            {
+                positions.push_back(tokens[end].second);
+                ++end;
+            }
+            const size_t count = end - begin;
+            PostingList& postings = build_postings[id];
+            postings.entries.emplace_back(Entry{doc_id, count});
+            postings.max_count = std::max(postings.max_count, count); // Верхняя граница для отсечения
+            postings.total_count += count;
+            _metrics.posting_bytes += sizeof(Entry);
+            // Позиции пишутся в отдельный поток в том же порядке, что и вхождения
+            if (_has_positions)
+            {
+                const size_t before = build_positions[id].data.size();
+                AppendPositions(build_positions[id], positions);
+                _metrics.posting_bytes += build_positions[id].data.size() - before + sizeof(uint32_t);
+            }
+            begin = end;
+        }
+        progress.Lap(_metrics.postings_seconds);
+        _metrics.documents = doc_id + 1;
+        _metrics.bytes += docs[doc_id].size();
+        _metrics.tokens += position;
+        _metrics.unique_terms = build_terms.size();
+        progress.Tick();
+    }
+    _metrics.documents = docs.size();
+
+    // Стоп-слова попадают только в дополнительный позиционный индекс,
+    // остальные слова упорядочиваются и получают постоянные номера
+    std::vector<uint32_t> order;
+    order.reserve(build_terms.size());
+    for (uint32_t id = 0; id < build_terms.size(); ++id)
+    {
+        if (IsStopword(build_terms[id]))
+        {
+            stopword_dictionary[build_terms[id]] = std::move(build_postings[id]);
+            if (_has_positions)
+            {
+                stopword_positions[build_terms[id]] = std::move(build_positions[id]);
+            }
+        }
+        else
+        {
+            order.push_back(id);
+        }
+    }
+    std::sort(order.begin(), order.end(), [&](uint32_t left, uint32_t right)
+    {
+        return build_terms[left] < build_terms[right];
+    });
+
+    std::vector<std::string> sorted_terms;
+    sorted_terms.reserve(order.size());
+    _postings.reserve(order.size());
+    if (_has_positions)
+    {
+        _positions.reserve(order.size());
+    }
+    if (_stemmer != StemmerType::None)
+    {
+        _surface_forms.reserve(order.size());
+    }
+    for (uint32_t id : order)
+    {
+        if (_stemmer != StemmerType::None)
+        {
+            // Самое частое написание, при равенстве - первое по алфавиту
+            const auto& counts = build_surfaces[id];
+            auto best = counts.begin();
+            for (auto it = counts.begin(); it != counts.end(); ++it)
+            {
+                if (it->second > best->second || (it->second == best->second && it->first < best->first))
+                {
+                    best = it;
+                }
+            }
+            _surface_forms.push_back(best->first);
+        }
+        sorted_terms.push_back(std::move(build_terms[id]));
+        _postings.push_back(std::move(build_postings[id]));
+        if (_has_positions)
+        {
+            _positions.push_back(std::move(build_positions[id]));
+        }
+    }
+    _terms.Build(sorted_terms);
+    if (_has_suggestions)
+    {
+        _spelling.Build(sorted_terms, SPELLING_MAX_DISTANCE);
+    }
+
+    // Разбиваем списки вхождений на блоки и запоминаем для каждого блока
+    // последний документ и максимальное количество вхождений
+    for (auto& postings : _postings)
+    {
+        postings.blocks.reserve((postings.entries.size() + POSTING_BLOCK_SIZE - 1) / POSTING_BLOCK_SIZE);
+        for (size_t begin = 0; begin < postings.entries.size(); begin += POSTING_BLOCK_SIZE)
+        {
+            const size_t end = std::min(begin + POSTING_BLOCK_SIZE, postings.entries.size());
+            PostingBlock block{ postings.entries[end - 1].doc_id, 0 };
+            for (size_t i = begin; i < end; ++i)
+            {
+                block.max_count = std::max(block.max_count, postings.entries[i].count);
             }
+            postings.blocks.push_back(block);
         }
-        // Добавляем результат в частотный словарь
-        for (const auto& [word, count] : word_counts)
+    }
+    progress.Lap(_metrics.finalize_seconds);
+    const IndexStats stats = GetIndexStats();
+    _metrics.posting_bytes = stats.posting_bytes + stats.position_bytes;
+    progress.Finish();
+}
+
+// Применяет настройки перед построением индекса: позиции, стеммер, стоп-слова
+void InvertedIndex::ApplyOptions()
+{
+    _has_positions = _options.positions;
+    _stemmer = _options.stemmer;
+    _stopword_positions = _options.positions && _options.stopwords_in_positions;
+    _has_substrings = _options.substrings;
+    _has_suggestions = _options.suggestions;
+    _stopwords.clear();
+    for (const auto& stopword : _options.stopwords)
+    {
+        // Стоп-слова нормализуются так же, как слова документов (в том числе стеммером)
+        std::string normalized = normalizeWord(stopword);
+        if (!normalized.empty())
         {
-            freq_dictionary[word].emplace_back(Entry{doc_id, count});
+            _stopwords.insert(std::move(normalized));
         }
     }
 }
+
 // Получает частоту слов для конкретного документа по его номеру в базе
 std::vector<Entry> InvertedIndex::GetWordCount(const std::string& word) const
 {
@@ -54,23 +308,197 @@ std::vector<Entry> InvertedIndex::GetWordCount(const std::string& word) const
     {
         return {}; // Возвращаем пустой вектор
     }
-    // Ищем слово в частотном словаре
-    if (auto it = freq_dictionary.find(normalized_word); it != freq_dictionary.end())
+    return FindPostings(normalized_word).entries; // Копируем найденный список вхождений
+}
+
+// Возвращает ссылку на список вхождений нормализованного слова без копирования
+const PostingList& InvertedIndex::FindPostings(const std::string& normalized_word) const
+{
+    static const PostingList empty_postings; // Общий пустой список для отсутствующих слов
+
+    // Ищем номер слова в словаре, список вхождений лежит в массиве по этому номеру
+    const uint32_t id = _terms.Find(normalized_word);
+    return id == NO_TERM ? empty_postings : _postings[id];
+}
+
+// Статистика слова: частоты собраны при построении списка вхождений
+TermStats InvertedIndex::GetTermStats(const std::string& normalized_word) const
+{
+    TermStats stats;
+    const uint32_t id = _terms.Find(normalized_word);
+    if (id == NO_TERM)
+    {
+        return stats;
+    }
+    const PostingList& postings = _postings[id];
+    stats.doc_freq = postings.entries.size();
+    stats.collection_freq = postings.total_count;
+    stats.posting_bytes = postings.entries.capacity() * sizeof(Entry) +
+                          postings.blocks.capacity() * sizeof(PostingBlock);
+    if (_has_positions)
     {
-        return it->second; // Возвращаем вектор с результатами
+        stats.posting_bytes += _positions[id].offsets.capacity() * sizeof(uint32_t) + _positions[id].data.capacity();
     }
-    return {}; // Возвращаем пустой вектор, если слово не найдено
+    return stats;
 }
 
-std::string InvertedIndex::normalizeWord(const std::string& word) const {
-    std::string result;
-    result.reserve(word.size()); // резервируем память для строки по размеру слова
+// Статистика индекса целиком
+IndexStats InvertedIndex::GetIndexStats() const
+{
+    IndexStats stats;
+    stats.documents = docs.size();
+    stats.vocabulary = _terms.Size();
+    stats.tokens = _total_tokens;
+    stats.average_length = GetAverageDocumentLength();
+    stats.dictionary_bytes = _terms.MemoryBytes();
+    for (const auto& postings : _postings)
+    {
+        stats.posting_bytes += postings.entries.capacity() * sizeof(Entry) +
+                               postings.blocks.capacity() * sizeof(PostingBlock);
+    }
+    for (const auto& positions : _positions)
+    {
+        stats.position_bytes += positions.offsets.capacity() * sizeof(uint32_t) + positions.data.capacity();
+    }
+    for (const auto& [trigram, doc_ids] : _trigrams)
+    {
+        stats.substring_bytes += sizeof(trigram) + doc_ids.capacity() * sizeof(uint32_t);
+    }
+    stats.spelling_bytes = _spelling.MemoryBytes();
+    return stats;
+}
+
+// Список вхождений для проверки позиций слов: стоп-слова берутся из дополнительного индекса
+const PostingList& InvertedIndex::FindPositionalPostings(const std::string& normalized_word) const
+{
+    if (auto it = stopword_dictionary.find(normalized_word); it != stopword_dictionary.end())
+    {
+        return it->second;
+    }
+    return FindPostings(normalized_word);
+}
+
+// Возвращает позиции нормализованного слова, параллельные его списку вхождений
+const PositionList* InvertedIndex::FindPositions(const std::string& normalized_word) const
+{
+    if (!_has_positions)
+    {
+        return nullptr;
+    }
+    if (const uint32_t id = _terms.Find(normalized_word); id != NO_TERM)
+    {
+        return &_positions[id];
+    }
+    if (auto it = stopword_positions.find(normalized_word); it != stopword_positions.end())
+    {
+        return &it->second;
+    }
+    return nullptr;
+}
+
+// Документы-кандидаты для подстроки: пересечение списков документов ее триграмм
+std::vector<uint32_t> InvertedIndex::SubstringCandidates(const std::string& normalized_substring) const
+{
+    std::vector<uint32_t> trigrams;
+    AppendTrigrams(normalized_substring, trigrams);
+    std::sort(trigrams.begin(), trigrams.end());
+    trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+    std::vector<const std::vector<uint32_t>*> lists;
+    for (const uint32_t trigram : trigrams)
+    {
+        auto it = _trigrams.find(trigram);
+        if (it == _trigrams.end())
+        {
+            return {}; // Триграммы нет ни в одном документе
+        }
+        lists.push_back(&it->second);
+    }
+    // Начинаем с самого короткого списка, остальные проверяем для его документов
+    std::sort(lists.begin(), lists.end(), [](const auto* a, const auto* b) { return a->size() < b->size(); });
+    std::vector<uint32_t> candidates = *lists.front();
+    for (size_t i = 1; i < lists.size() && !candidates.empty(); ++i)
+    {
+        auto it = lists[i]->begin();
+        size_t out = 0;
+        for (const uint32_t doc_id : candidates)
+        {
+            it = std::lower_bound(it, lists[i]->end(), doc_id);
+            if (it != lists[i]->end() && *it == doc_id)
+            {
+                candidates[out++] = doc_id;
+            }
+        }
+        candidates.resize(out);
+    }
+    return candidates;
+}
 
-    for (char c: word) {
-        if (std::isalnum(c)) // если символ является буквой или цифрой
+// Документы со словами, содержащими подстроку, с проверкой по тексту документа
+std::vector<Entry> InvertedIndex::FindSubstring(const std::string& normalized_substring) const
+{
+    std::vector<Entry> result;
+    if (normalized_substring.empty())
+    {
+        return result;
+    }
+    const auto verify = [&](size_t doc_id)
+    {
+        // Все триграммы могут встретиться в разных словах документа - проверяем текст
+        if (const size_t count = CountSubstringWords(docs[doc_id], normalized_substring); count > 0)
         {
-            result += std::tolower(c); // приводим к нижнему регистру
+            result.push_back(Entry{ doc_id, count });
         }
+    };
+    if (_has_substrings && normalized_substring.size() >= TRIGRAM_LENGTH)
+    {
+        for (const uint32_t doc_id : SubstringCandidates(normalized_substring))
+        {
+            verify(doc_id);
+        }
+        return result;
+    }
+    for (size_t doc_id = 0; doc_id < docs.size(); ++doc_id)
+    {
+        verify(doc_id);
+    }
+    return result;
+}
+
+// Верхняя оценка количества документов с подстрокой - длина самого короткого списка триграммы
+size_t InvertedIndex::EstimateSubstring(const std::string& normalized_substring) const
+{
+    if (!_has_substrings || normalized_substring.size() < TRIGRAM_LENGTH)
+    {
+        return docs.size();
+    }
+    std::vector<uint32_t> trigrams;
+    AppendTrigrams(normalized_substring, trigrams);
+    size_t estimate = docs.size();
+    for (const uint32_t trigram : trigrams)
+    {
+        auto it = _trigrams.find(trigram);
+        estimate = std::min(estimate, it == _trigrams.end() ? 0 : it->second.size());
+    }
+    return estimate;
+}
+
+// Самое частое написание слова в документах до стемминга
+const std::string& InvertedIndex::GetSurfaceForm(const std::string& normalized_word) const
+{
+    if (_surface_forms.empty())
+    {
+        return normalized_word;
+    }
+    const uint32_t id = _terms.Find(normalized_word);
+    return id == NO_TERM ? normalized_word : _surface_forms[id];
+}
+
+std::string InvertedIndex::normalizeWord(const std::string& word) const {
+    // Буквы и цифры любого поддерживаемого алфавита в нижнем регистре (UTF-8)
+    std::string normalized = NormalizeWord(word);
+    if (_stemmer != StemmerType::None && !normalized.empty())
+    {
+        return StemWord(_stemmer, normalized); // основа слова, если включен стемминг
     }
-    return result; // возвращаем нормализованное слово
+    return normalized;
 }
\ No newline at end of file
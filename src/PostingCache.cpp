@@ -0,0 +1,128 @@
+#include "PostingCache.h"
+#include "PostingIterator.h"
+
+PostingCache::PostingCache(size_t budget_bytes, size_t min_length) : _budget(budget_bytes), _min_length(min_length) {}
+
+// Меняет бюджет памяти, содержимое сбрасывается
+void PostingCache::SetBudget(size_t budget_bytes)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _budget = budget_bytes;
+    _items.clear();
+    _positions.clear();
+    _stats.bytes = 0;
+}
+
+// Объем памяти, который учитывается за пересечение: вхождения обоих списков и ключ
+size_t PostingCache::Footprint(const std::string& key, const PairPostings& postings)
+{
+    return sizeof(Item) + 2 * key.size() +
+           (postings.first.entries.size() + postings.second.entries.size()) * sizeof(Entry);
+}
+
+// Пересекает списки вхождений: первый список (более короткий) ведет, второй догоняет его галопированием
+PairPostings PostingCache::Compute(const PostingList& first, const PostingList& second)
+{
+    PairPostings result;
+    EntryPostingIterator it(second);
+    for (const Entry& entry : first.entries)
+    {
+        it.Advance(entry.doc_id);
+        if (it.AtEnd())
+        {
+            break;
+        }
+        if (it.Doc() == entry.doc_id)
+        {
+            result.first.entries.push_back(entry);
+            result.second.entries.push_back({ entry.doc_id, it.Count() });
+            result.first.max_count = std::max(result.first.max_count, entry.count);
+            result.second.max_count = std::max(result.second.max_count, it.Count());
+            result.first.total_count += entry.count;
+            result.second.total_count += it.Count();
+        }
+    }
+    return result;
+}
+
+std::shared_ptr<const PairPostings> PostingCache::Intersect(const InvertedIndex& index,
+                                                            const std::string& first, const std::string& second)
+{
+    const PostingList& first_list = index.FindPostings(first);
+    const PostingList& second_list = index.FindPostings(second);
+    if (_budget == 0 || first_list.entries.size() < _min_length || second_list.entries.size() < _min_length)
+    {
+        return nullptr;
+    }
+    const std::string key = first + ' ' + second;
+    const uint64_t version = index.GetVersion();
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_version != version)
+        {
+            // Индекс перестроен - пересечения устарели
+            _items.clear();
+            _positions.clear();
+            _stats.bytes = 0;
+            _version = version;
+        }
+        if (auto it = _positions.find(key); it != _positions.end())
+        {
+            ++_stats.hits;
+            _items.splice(_items.begin(), _items, it->second);
+            return it->second->postings;
+        }
+        ++_stats.misses;
+    }
+
+    // Вычисление без блокировки: другие потоки в это время могут пользоваться кэшем
+    auto postings = std::make_shared<const PairPostings>(Compute(first_list, second_list));
+    const size_t bytes = Footprint(key, *postings);
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (bytes > _budget)
+    {
+        ++_stats.rejected;
+        return postings;
+    }
+    if (_version != version || _positions.count(key))
+    {
+        // Индекс успел измениться или пересечение уже добавлено параллельным запросом
+        return postings;
+    }
+    _items.push_front(Item{ key, postings, bytes });
+    _positions.emplace(key, _items.begin());
+    _stats.bytes += bytes;
+    ++_stats.insertions;
+    Shrink();
+    return postings;
+}
+
+// Вытесняет давно не использованные пересечения, пока объем больше бюджета
+void PostingCache::Shrink()
+{
+    while (_stats.bytes > _budget && !_items.empty())
+    {
+        _stats.bytes -= _items.back().bytes;
+        _positions.erase(_items.back().key);
+        _items.pop_back();
+        ++_stats.evictions;
+    }
+}
+
+// Удаляет все пересечения, статистика сохраняется
+void PostingCache::Clear()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _items.clear();
+    _positions.clear();
+    _stats.bytes = 0;
+}
+
+PostingCacheStats PostingCache::GetStats() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    PostingCacheStats stats = _stats;
+    stats.entries = _items.size();
+    return stats;
+}
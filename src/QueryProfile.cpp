@@ -0,0 +1,303 @@
+#include "QueryProfile.h"
+#include <bit>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+namespace
+{
+    // Прибавление к счетчику, который меняет только один поток: без атомарного
+    // чтения-изменения-записи, атомарность нужна лишь для чтения из других потоков
+    void Increase(std::atomic<uint64_t>& counter, uint64_t value)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+    using PhaseHistograms = std::array<LatencyHistogram, QUERY_PHASE_COUNT>;
+
+    // Гистограммы работающих потоков и сумма гистограмм завершившихся
+    struct ProfileRegistry
+    {
+        std::mutex mutex;
+
+        std::vector<PhaseHistograms*> threads;
+
+        PhaseHistograms finished;
+    };
+
+    ProfileRegistry& Registry()
+    {
+        static ProfileRegistry registry;
+        return registry;
+    }
+
+    // Гистограммы потока: регистрируются при первой записи, при завершении потока
+    // переносятся в сумму завершившихся
+    class ThreadProfile
+    {
+    public:
+        ThreadProfile()
+            : _histograms(std::make_unique<PhaseHistograms>())
+        {
+            ProfileRegistry& registry = Registry();
+            const std::lock_guard lock(registry.mutex);
+            registry.threads.push_back(_histograms.get());
+        }
+
+        ~ThreadProfile()
+        {
+            ProfileRegistry& registry = Registry();
+            const std::lock_guard lock(registry.mutex);
+            for (size_t phase = 0; phase < QUERY_PHASE_COUNT; ++phase)
+            {
+                registry.finished[phase].Add((*_histograms)[phase]);
+            }
+            std::erase(registry.threads, _histograms.get());
+        }
+
+        LatencyHistogram& operator[](QueryPhase phase) { return (*_histograms)[static_cast<size_t>(phase)]; }
+
+    private:
+        std::unique_ptr<PhaseHistograms> _histograms;
+    };
+
+    std::string& ProfilePath()
+    {
+        static std::string path;
+        return path;
+    }
+
+    void WriteProfile()
+    {
+        std::ofstream file(ProfilePath());
+        if (!file.is_open())
+        {
+            std::cerr << "Warning: Could not write query profile to " << ProfilePath() << std::endl;
+            return;
+        }
+        file << DumpQueryProfile().dump(4);
+    }
+}
+
+const char* QueryPhaseName(QueryPhase phase)
+{
+    switch (phase)
+    {
+    case QueryPhase::Parse:
+        return "parse";
+    case QueryPhase::Lookup:
+        return "lookup";
+    case QueryPhase::Evaluate:
+        return "evaluate";
+    case QueryPhase::Rank:
+        return "rank";
+    case QueryPhase::Output:
+        return "output";
+    case QueryPhase::Query:
+        return "query";
+    default:
+        return "unknown";
+    }
+}
+
+LatencyHistogram& LatencyHistogram::operator=(const LatencyHistogram& other)
+{
+    if (this != &other)
+    {
+        Clear();
+        Add(other);
+    }
+    return *this;
+}
+
+// Значения меньше 2 * SUB_BUCKETS - сами себе корзины; у больших значений отбрасываются младшие
+// биты так, чтобы осталось SUB_BUCKET_BITS + 1 значащих
+size_t LatencyHistogram::BucketIndex(uint64_t value)
+{
+    if (value > MAX_VALUE)
+    {
+        return BUCKETS - 1;
+    }
+    const int shift = std::max(0, static_cast<int>(std::bit_width(value)) - (SUB_BUCKET_BITS + 1));
+    return SUB_BUCKETS * static_cast<size_t>(shift) + static_cast<size_t>(value >> shift);
+}
+
+uint64_t LatencyHistogram::BucketValue(size_t index)
+{
+    const size_t shift = index < 2 * SUB_BUCKETS ? 0 : index / SUB_BUCKETS - 1;
+    const uint64_t lowest = static_cast<uint64_t>(index - SUB_BUCKETS * shift) << shift;
+    return lowest + (uint64_t{ 1 } << shift) - 1;
+}
+
+void LatencyHistogram::Record(uint64_t value)
+{
+    Increase(_counts[BucketIndex(value)], 1);
+    Increase(_count, 1);
+    Increase(_sum, value);
+    if (value < _min.load(std::memory_order_relaxed))
+    {
+        _min.store(value, std::memory_order_relaxed);
+    }
+    if (value > _max.load(std::memory_order_relaxed))
+    {
+        _max.store(value, std::memory_order_relaxed);
+    }
+}
+
+void LatencyHistogram::Add(const LatencyHistogram& other)
+{
+    for (size_t i = 0; i < BUCKETS; ++i)
+    {
+        const uint64_t count = other._counts[i].load(std::memory_order_relaxed);
+        if (count != 0)
+        {
+            Increase(_counts[i], count);
+        }
+    }
+    Increase(_count, other._count.load(std::memory_order_relaxed));
+    Increase(_sum, other._sum.load(std::memory_order_relaxed));
+    _min.store(std::min(_min.load(std::memory_order_relaxed), other._min.load(std::memory_order_relaxed)),
+               std::memory_order_relaxed);
+    _max.store(std::max(_max.load(std::memory_order_relaxed), other._max.load(std::memory_order_relaxed)),
+               std::memory_order_relaxed);
+}
+
+void LatencyHistogram::Clear()
+{
+    for (auto& count : _counts)
+    {
+        count.store(0, std::memory_order_relaxed);
+    }
+    _count.store(0, std::memory_order_relaxed);
+    _sum.store(0, std::memory_order_relaxed);
+    _min.store(UINT64_MAX, std::memory_order_relaxed);
+    _max.store(0, std::memory_order_relaxed);
+}
+
+double LatencyHistogram::Mean() const
+{
+    const uint64_t count = Count();
+    return count == 0 ? 0.0 : static_cast<double>(_sum.load(std::memory_order_relaxed)) / static_cast<double>(count);
+}
+
+uint64_t LatencyHistogram::Percentile(double q) const
+{
+    const uint64_t count = Count();
+    if (count == 0)
+    {
+        return 0;
+    }
+    // Номер значения (с единицы) в упорядоченной последовательности
+    const double clamped = std::clamp(q, 0.0, 1.0);
+    const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(clamped * static_cast<double>(count))));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKETS; ++i)
+    {
+        seen += _counts[i].load(std::memory_order_relaxed);
+        if (seen >= rank)
+        {
+            return std::min(BucketValue(i), Max());
+        }
+    }
+    return Max();
+}
+
+nlohmann::ordered_json LatencyHistogram::ToJson() const
+{
+    nlohmann::ordered_json buckets = nlohmann::ordered_json::array();
+    for (size_t i = 0; i < BUCKETS; ++i)
+    {
+        const uint64_t count = _counts[i].load(std::memory_order_relaxed);
+        if (count != 0)
+        {
+            buckets.push_back({ BucketValue(i), count });
+        }
+    }
+    return {
+        { "count", Count() },
+        { "mean_ns", Mean() },
+        { "min_ns", Min() },
+        { "p50_ns", Percentile(0.5) },
+        { "p90_ns", Percentile(0.9) },
+        { "p99_ns", Percentile(0.99) },
+        { "p999_ns", Percentile(0.999) },
+        { "max_ns", Max() },
+        { "buckets", std::move(buckets) }
+    };
+}
+
+void RecordQueryPhase(QueryPhase phase, uint64_t nanoseconds)
+{
+    thread_local ThreadProfile profile;
+    profile[phase].Record(nanoseconds);
+    if (QueryTrace* trace = ActiveQueryTrace())
+    {
+        trace->phase_ns[static_cast<size_t>(phase)] += nanoseconds;
+    }
+}
+
+LatencyHistogram GetQueryPhaseHistogram(QueryPhase phase)
+{
+    const size_t index = static_cast<size_t>(phase);
+    ProfileRegistry& registry = Registry();
+    const std::lock_guard lock(registry.mutex);
+    LatencyHistogram histogram = registry.finished[index];
+    for (const PhaseHistograms* thread : registry.threads)
+    {
+        histogram.Add((*thread)[index]);
+    }
+    return histogram;
+}
+
+nlohmann::ordered_json DumpQueryProfile()
+{
+    nlohmann::ordered_json phases = nlohmann::ordered_json::object();
+    for (size_t phase = 0; phase < QUERY_PHASE_COUNT; ++phase)
+    {
+        phases[QueryPhaseName(static_cast<QueryPhase>(phase))] = GetQueryPhaseHistogram(static_cast<QueryPhase>(phase)).ToJson();
+    }
+    size_t threads = 0;
+    {
+        ProfileRegistry& registry = Registry();
+        const std::lock_guard lock(registry.mutex);
+        threads = registry.threads.size();
+    }
+    return {
+        { "profiling", QUERY_PROFILING_ENABLED },
+        { "threads", threads },
+        { "phases", std::move(phases) }
+    };
+}
+
+void ResetQueryProfile()
+{
+    ProfileRegistry& registry = Registry();
+    const std::lock_guard lock(registry.mutex);
+    for (auto& histogram : registry.finished)
+    {
+        histogram.Clear();
+    }
+    // Запись в гистограммы потоков может идти одновременно: значения, записанные во время
+    // сброса, могут частично сохраниться
+    for (PhaseHistograms* thread : registry.threads)
+    {
+        for (auto& histogram : *thread)
+        {
+            histogram.Clear();
+        }
+    }
+}
+
+void WriteQueryProfileAtExit(const std::string& path)
+{
+    static std::once_flag registered;
+    ProfilePath() = path;
+    // Реестр создается до регистрации обработчика, чтобы уничтожаться после его вызова
+    Registry();
+    std::call_once(registered, [] { std::atexit(WriteProfile); });
+}
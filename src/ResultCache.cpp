@@ -0,0 +1,161 @@
+#include "ResultCache.h"
+#include <algorithm>
+#include <functional>
+
+namespace
+{
+    // Наибольшее количество сегментов кэша
+    constexpr size_t MAX_SHARDS = 16;
+
+    // Доля защищенной части сегмента (в процентах от его емкости)
+    constexpr size_t PROTECTED_PERCENT = 80;
+}
+
+ResultCache::ResultCache(size_t capacity)
+{
+    SetCapacity(capacity);
+}
+
+// Меняет емкость кэша, содержимое сбрасывается
+void ResultCache::SetCapacity(size_t capacity)
+{
+    _capacity = capacity;
+    _shards.clear();
+    // Каждому сегменту нужно хотя бы несколько мест, иначе SLRU вырождается
+    const size_t shard_count = std::clamp<size_t>(capacity / 8, 1, MAX_SHARDS);
+    for (size_t i = 0; i < shard_count; ++i)
+    {
+        auto shard = std::make_unique<Shard>();
+        const size_t shard_capacity = capacity / shard_count + (i < capacity % shard_count ? 1 : 0);
+        shard->protected_capacity = shard_capacity * PROTECTED_PERCENT / 100;
+        shard->probation_capacity = shard_capacity - shard->protected_capacity;
+        _shards.push_back(std::move(shard));
+    }
+}
+
+ResultCache::Shard& ResultCache::ShardFor(const std::string& key) const
+{
+    return *_shards[std::hash<std::string>{}(key) % _shards.size()];
+}
+
+// Очищает сегмент, если его ответы вычислены по другой версии индекса
+void ResultCache::CheckVersion(Shard& shard, uint64_t version)
+{
+    if (shard.version == version)
+    {
+        return;
+    }
+    if (!shard.positions.empty())
+    {
+        shard.positions.clear();
+        shard.probation_items.clear();
+        shard.protected_items.clear();
+        _invalidations.fetch_add(1, std::memory_order_relaxed);
+    }
+    shard.version = version;
+}
+
+// Вытесняет самые старые ответы испытательной части сверх ее емкости
+void ResultCache::TrimProbation(Shard& shard)
+{
+    while (shard.probation_items.size() > shard.probation_capacity)
+    {
+        shard.positions.erase(shard.probation_items.back().key);
+        shard.probation_items.pop_back();
+        _evictions.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+bool ResultCache::Get(const std::string& key, uint64_t version, std::vector<RelativeIndex>& result)
+{
+    if (_capacity == 0)
+    {
+        return false;
+    }
+    Shard& shard = ShardFor(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    CheckVersion(shard, version);
+
+    auto it = shard.positions.find(key);
+    if (it == shard.positions.end())
+    {
+        _misses.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    _hits.fetch_add(1, std::memory_order_relaxed);
+    Position& position = it->second;
+    if (position.is_protected)
+    {
+        shard.protected_items.splice(shard.protected_items.begin(), shard.protected_items, position.item);
+    }
+    else if (shard.protected_capacity == 0)
+    {
+        shard.probation_items.splice(shard.probation_items.begin(), shard.probation_items, position.item);
+    }
+    else
+    {
+        // Повторное обращение - ответ переходит в защищенную часть,
+        // самый старый защищенный ответ возвращается в испытательную
+        shard.protected_items.splice(shard.protected_items.begin(), shard.probation_items, position.item);
+        position.is_protected = true;
+        if (shard.protected_items.size() > shard.protected_capacity)
+        {
+            auto demoted = std::prev(shard.protected_items.end());
+            shard.probation_items.splice(shard.probation_items.begin(), shard.protected_items, demoted);
+            shard.positions[demoted->key].is_protected = false;
+            TrimProbation(shard);
+        }
+    }
+    result = position.item->result;
+    return true;
+}
+
+void ResultCache::Put(const std::string& key, uint64_t version, std::vector<RelativeIndex> result)
+{
+    if (_capacity == 0)
+    {
+        return;
+    }
+    Shard& shard = ShardFor(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    CheckVersion(shard, version);
+
+    if (auto it = shard.positions.find(key); it != shard.positions.end())
+    {
+        // Ответ уже добавлен параллельным запросом
+        it->second.item->result = std::move(result);
+        return;
+    }
+    shard.probation_items.push_front(Item{ key, std::move(result) });
+    shard.positions.emplace(key, Position{ shard.probation_items.begin(), false });
+    _insertions.fetch_add(1, std::memory_order_relaxed);
+    TrimProbation(shard);
+}
+
+// Удаляет все ответы, статистика сохраняется
+void ResultCache::Clear()
+{
+    for (auto& shard : _shards)
+    {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        shard->positions.clear();
+        shard->probation_items.clear();
+        shard->protected_items.clear();
+    }
+}
+
+ResultCacheStats ResultCache::GetStats() const
+{
+    ResultCacheStats stats;
+    stats.hits = _hits.load(std::memory_order_relaxed);
+    stats.misses = _misses.load(std::memory_order_relaxed);
+    stats.insertions = _insertions.load(std::memory_order_relaxed);
+    stats.evictions = _evictions.load(std::memory_order_relaxed);
+    stats.invalidations = _invalidations.load(std::memory_order_relaxed);
+    for (const auto& shard : _shards)
+    {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        stats.size += shard->positions.size();
+    }
+    return stats;
+}
@@ -1,82 +1,340 @@
 #include "SearchServer.h"
 #include "ConverterJSON.h"
-#include <sstream>
-#include <unordered_set>
+#include "FuzzyTerm.h"
+#include "Wildcard.h"
+#include "PostingIterator.h"
+#include "Scorers.h"
+#include <chrono>
+#include <unordered_map>
+#include <utility>
 #include <algorithm>
+#include <sstream>
 
-std::vector<std::vector<RelativeIndex>> SearchServer::search(const std::vector<std::string>& queries_input)
+// Выполнение запроса, инстанцированное для конкретной функции ранжирования.
+// Для запросов из отдельных слов физический оператор выбирается один раз на запрос
+// по настройкам, остальные запросы выполняются по дереву
+template <typename Scorer>
+std::vector<RelativeIndex> SearchServer::evaluate(const QueryNode& root, size_t limit) const
 {
-    ConverterJSON converter; // Объект для работы с JSON
-    // Получаем максимальное количество документов в ответе
-    const int response_limit = converter.GetResponsesLimit();
+    const size_t total_docs = _index.GetTotalDocuments();
+    const auto terms_of = [](const std::vector<std::shared_ptr<const QueryNode>>& clauses)
+    {
+        std::vector<std::string> terms;
+        terms.reserve(clauses.size());
+        for (const auto& clause : clauses)
+        {
+            terms.push_back(clause->terms.front());
+        }
+        return terms;
+    };
 
-    // Отсортированный список релевантных ответов на запросы
-    std::vector<std::vector<RelativeIndex>> result;
-    for (const auto& query : queries_input)
+    if (root.type == QueryNode::Type::Boolean && root.should.empty() && root.must_not.empty() &&
+        !root.must.empty() && QueryNode::AllTerms(root.must))
+    {
+        // Все слова обязательны - списки пересекаются, отсечение по верхним границам не нужно
+        TraceStrategy("conjunctive");
+        // conjunction держит пересечение из кэша, пока итераторы читают его
+        auto conjunction = conjunctionIterators(terms_of(root.must));
+        return EvaluateConjunctive(conjunction.iterators, Scorer{}, total_docs, limit);
+    }
+    if (root.type != QueryNode::Type::Boolean || !root.must.empty() ||
+        !QueryNode::AllTerms(root.should) || !QueryNode::AllTerms(root.must_not))
     {
-        std::vector<RelativeIndex> result_inner; // Список релевантных документов
+        TraceStrategy("tree");
+        return EvaluateQueryTree<Scorer>(root, _index, limit);
+    }
 
-        // Контейнер для хранения релевантных значений
-        std::vector<size_t> absolute_relevance(_index.GetTotalDocuments(), 0);
-        // список уникальных слов в запросе
-        std::unordered_set<std::string> words_set;
+    const auto terms = terms_of(root.should);
+    if (!root.must_not.empty())
+    {
+        // Объединение с исключениями - отсечение MaxScore с пропуском исключенных документов
+        TraceStrategy("maxscore_not");
+        auto iterators = MakeIterators<EntryPostingIterator>(_index, terms);
+        auto excluded = MakeIterators<EntryPostingIterator>(_index, terms_of(root.must_not));
+        return EvaluateMaxScore(iterators, Scorer{}, total_docs, limit, &excluded);
+    }
+    switch (_options.strategy)
+    {
+    case EvaluationStrategy::Exhaustive:
+    {
+        TraceStrategy("exhaustive");
+        auto iterators = MakeIterators<EntryPostingIterator>(_index, terms);
+        return EvaluateExhaustive(iterators, Scorer{}, total_docs, limit);
+    }
+    case EvaluationStrategy::BlockMaxWand:
+    {
+        TraceStrategy("blockmax");
+        auto iterators = MakeIterators<BlockPostingIterator>(_index, terms);
+        return EvaluateBlockMaxWand(iterators, Scorer{}, total_docs, limit);
+    }
+    case EvaluationStrategy::MaxScore:
+    default:
+    {
+        TraceStrategy("maxscore");
+        auto iterators = MakeIterators<EntryPostingIterator>(_index, terms);
+        return EvaluateMaxScore(iterators, Scorer{}, total_docs, limit);
+    }
+    }
+}
 
-        std::string word;
-        std::stringstream buffer_stream(query); // Разбираем на слова
+// Задает настройки обработки запросов
+void SearchServer::SetOptions(const SearchOptions& options)
+{
+    _options = options;
+    if (_cache.GetCapacity() != options.cache_capacity)
+    {
+        _cache.SetCapacity(options.cache_capacity);
+    }
+    if (_posting_cache.GetBudget() != options.posting_cache_bytes)
+    {
+        _posting_cache.SetBudget(options.posting_cache_bytes);
+    }
+    _slow_log.SetThreshold(static_cast<uint64_t>(std::max(options.slow_query_ms, 0.0) * 1e6));
+    if (_slow_log.GetFile() != options.slow_query_log)
+    {
+        _slow_log.SetFile(options.slow_query_log);
+    }
+}
 
-        // разбитие запроса на отдельные слова и формирование списка уникальных
-        while (buffer_stream >> word)
+// Итераторы для пересечения списков вхождений слов с использованием кэша пересечений
+SearchServer::ConjunctionIterators SearchServer::conjunctionIterators(std::vector<std::string> terms) const
+{
+    // Пересечение пары списков при промахе кэша тоже относится к поиску списков
+    QUERY_PHASE(Lookup);
+    if (terms.size() < 2 || _posting_cache.GetBudget() == 0)
+    {
+        return { MakeIterators<EntryPostingIterator>(_index, terms), nullptr };
+    }
+    std::sort(terms.begin(), terms.end(), [&](const std::string& a, const std::string& b)
+    {
+        const size_t a_size = _index.FindPostings(a).entries.size();
+        const size_t b_size = _index.FindPostings(b).entries.size();
+        return a_size != b_size ? a_size < b_size : a < b;
+    });
+    ConjunctionIterators conjunction;
+    conjunction.pair = _posting_cache.Intersect(_index, terms[0], terms[1]);
+    if (!conjunction.pair)
+    {
+        conjunction.iterators = MakeIterators<EntryPostingIterator>(_index, terms);
+        return conjunction;
+    }
+    // Пересечение двух самых коротких списков заменяет сами списки: результат тот же,
+    // а веса слов считаются по их документной частоте во всем индексе
+    auto& iterators = conjunction.iterators;
+    iterators.reserve(terms.size());
+    iterators.emplace_back(conjunction.pair->first, _index.FindPostings(terms[0]).entries.size());
+    iterators.emplace_back(conjunction.pair->second, _index.FindPostings(terms[1]).entries.size());
+    for (size_t i = 2; i < terms.size(); ++i)
+    {
+        iterators.emplace_back(_index.FindPostings(terms[i]));
+    }
+    return conjunction;
+}
+
+// Разбирает запрос с учетом текущих настроек
+CompiledQuery SearchServer::Compile(const std::string& query) const
+{
+    QUERY_PHASE(Parse);
+    return CompileQuery(query, _index, _options.syntax, _options.mode, _options.wildcard_limit,
+                        _options.fuzzy_limit);
+}
+
+// Выполняет разобранный запрос, возвращает не более limit наиболее релевантных документов
+std::vector<RelativeIndex> SearchServer::search(const CompiledQuery& query, size_t limit) const
+{
+    QUERY_PHASE(Query);
+    if (query.version != _index.GetVersion())
+    {
+        // Раскрытия шаблонов и нечетких слов (и ключ кэша) сделаны по словарю прежней базы
+        return search(Compile(query.text), limit);
+    }
+    if (!query.root)
+    {
+        return {};
+    }
+    const uint64_t threshold = _slow_log.GetThreshold();
+    if (threshold == 0)
+    {
+        return execute(query, limit);
+    }
+    // Сведения о запросе собираются всегда, а записываются только для медленных запросов
+    QueryTrace trace;
+    QueryTrace* const outer = std::exchange(ActiveQueryTrace(), &trace);
+    const auto start = std::chrono::steady_clock::now();
+    auto result = execute(query, limit);
+    const auto latency = std::chrono::steady_clock::now() - start;
+    ActiveQueryTrace() = outer;
+    const uint64_t latency_ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(latency).count());
+    if (latency_ns >= threshold)
+    {
+        SlowQueryRecord record = makeSlowQueryRecord(query, limit);
+        record.latency_ns = latency_ns;
+        record.results = result.size();
+        record.docs_scored = trace.docs_scored;
+        record.strategy = trace.strategy;
+        record.phase_ns = trace.phase_ns;
+        _slow_log.Write(std::move(record));
+    }
+    return result;
+}
+
+// Выполнение запроса с обращением к кэшу
+std::vector<RelativeIndex> SearchServer::execute(const CompiledQuery& query, size_t limit) const
+{
+    if (_cache.GetCapacity() == 0)
+    {
+        return evaluate(query, limit);
+    }
+    // Способ обхода списков в ключ не входит - ответ от него не зависит
+    const std::string key = std::to_string(static_cast<int>(_options.scorer)) + ":" +
+                            std::to_string(limit) + ":" + query.key;
+    const uint64_t version = _index.GetVersion();
+    std::vector<RelativeIndex> result;
+    if (!_cache.Get(key, version, result))
+    {
+        result = evaluate(query, limit);
+        _cache.Put(key, version, result);
+    }
+    else
+    {
+        TraceStrategy("cache");
+    }
+    return result;
+}
+
+// Слова собираются обходом дерева запроса: длины списков вхождений берутся из индекса
+// только для записываемых запросов
+SlowQueryRecord SearchServer::makeSlowQueryRecord(const CompiledQuery& query, size_t limit) const
+{
+    SlowQueryRecord record;
+    record.query = query.key;
+    record.limit = limit;
+    const auto add = [&](const std::string& term, size_t postings)
+    {
+        if (record.terms.size() < SLOW_QUERY_MAX_TERMS)
         {
-            if (!word.empty())
-            {
-                words_set.insert(word);
-            }
+            record.terms.emplace_back(term, postings);
         }
-
-        // по doc_id добавляем количество встреч слова
-        for (const auto& word : words_set)
+    };
+    const auto visit = [&](const auto& self, const QueryNode& node) -> void
+    {
+        if (node.type == QueryNode::Type::Substring)
+        {
+            add("sub:" + node.pattern, _index.EstimateSubstring(node.pattern));
+        }
+        for (const auto& term : node.terms)
+        {
+            add(term, _index.FindPostings(term).entries.size());
+        }
+        for (const auto* group : { &node.must, &node.should, &node.must_not })
         {
-            for (const auto& entry : _index.GetWordCount(word))
+            for (const auto& clause : *group)
             {
-                absolute_relevance[entry.doc_id] += entry.count; // Увеличиваем количество вхождений
+                self(self, *clause);
             }
         }
-        // Самый релевантный докуммент
-        const auto max_it = std::max_element(absolute_relevance.begin(), absolute_relevance.end());
+    };
+    visit(visit, *query.root);
+    return record;
+}
 
-        // рассчитываем относительную релевантность
-        if (max_it != absolute_relevance.end() && *max_it != 0)
+// Подсказка для запроса без результатов: исправляются слова, которых нет в индексе
+std::string SearchServer::Suggest(const std::string& query) const
+{
+    const size_t max_distance = std::min(_options.suggestion_distance, MAX_FUZZY_DISTANCE);
+    if (max_distance == 0)
+    {
+        return {};
+    }
+    std::string suggestion;
+    bool corrected = false;
+    std::istringstream stream(query);
+    std::string word;
+    while (stream >> word)
+    {
+        // Скобки, кавычки и +/- вокруг слова сохраняются, заменяется само слово
+        const size_t begin = word.find_first_not_of("+-(\"");
+        const size_t end = word.find_last_not_of(")\"");
+        const bool is_operator = _options.syntax == QuerySyntax::Boolean &&
+                                 (word == "AND" || word == "OR" || word == "NOT" || word.rfind("NEAR", 0) == 0);
+        if (begin != std::string::npos && end != std::string::npos && begin <= end && !is_operator)
         {
-            // Сохраняем для нормализации
-            const float max_relatnce = static_cast<float>(*max_it);
-
-            for (size_t doc_id = 0; doc_id < absolute_relevance.size(); ++doc_id)
+            const std::string core = word.substr(begin, end - begin + 1);
+            std::string base;
+            size_t fuzzy_distance = 0;
+            // Шаблоны, нечеткие слова и подстроки не исправляются
+            const bool special = core.rfind("sub:", 0) == 0 || IsWildcardPattern(core) ||
+                                 ParseFuzzyTerm(core, base, fuzzy_distance);
+            const std::string normalized = special ? std::string() : _index.normalizeWord(core);
+            if (!normalized.empty() && !_index.IsStopword(normalized) && _index.FindTermId(normalized) == NO_TERM)
             {
-                if (absolute_relevance[doc_id] > 0)
+                // У коротких слов слишком много соседей: до 4 символов допускается одна правка, до 2 - ни одной
+                const size_t length = DecodeUtf8(normalized).size();
+                const size_t distance = std::min(max_distance, (length - 1) / 2);
+                const auto matches = distance == 0 ? std::vector<FuzzyMatch>()
+                                                   : SuggestTerms(_index, normalized, distance, 1);
+                if (!matches.empty())
                 {
-                    result_inner.emplace_back(RelativeIndex{ doc_id, static_cast<float>(absolute_relevance[doc_id]) / max_relatnce });
+                    // Со стеммером в словаре основы - подставляется написание слова из документов
+                    word = word.substr(0, begin) + _index.GetSurfaceForm(matches.front().term) + word.substr(end + 1);
+                    corrected = true;
                 }
             }
-            std::sort(result_inner.begin(), result_inner.end(), [](RelativeIndex& a, RelativeIndex& b)
-            {
-                const float EPS = 1e-6; // Погрешность = 0.000001
-                if (std::abs(a.rank - b.rank) > EPS)
-                {
-                    return a.rank > b.rank; // Сначала более релевантные
-                }
-                return a.doc_id < b.doc_id; // При равенстве - по возрастанию doc_id
-            });
         }
-        if (result_inner.size() > response_limit) // Ограничени количества ответов
+        if (!suggestion.empty())
         {
-            result_inner.resize(response_limit);
+            suggestion += ' ';
         }
-        result.emplace_back(std::move(result_inner)); // Перемещаем результат
+        suggestion += word;
     }
+    return corrected ? suggestion : std::string();
+}
 
+// Выполнение запроса без обращения к кэшу
+std::vector<RelativeIndex> SearchServer::evaluate(const CompiledQuery& query, size_t limit) const
+{
+    QUERY_PHASE(Evaluate);
+    // Выбор функции ранжирования выполняется один раз на запрос,
+    // дальше работает цикл, специализированный под нее на этапе компиляции
+    switch (_options.scorer)
+    {
+    case ScorerType::TfIdf:
+        return evaluate<TfIdfScorer>(*query.root, limit);
+    case ScorerType::TermCount:
+    default:
+        return evaluate<TermCountScorer>(*query.root, limit);
+    }
+}
+
+std::vector<std::vector<RelativeIndex>> SearchServer::search(const std::vector<std::string>& queries_input)
+{
+    ConverterJSON converter; // Объект для работы с JSON
+    // Получаем максимальное количество документов в ответе
+    const int response_limit = converter.GetResponsesLimit();
+
+    // Отсортированный список релевантных ответов на запросы
+    std::vector<std::vector<RelativeIndex>> result;
+    std::unordered_map<std::string, CompiledQuery> compiled; // Разобранные запросы пакета
+    for (const auto& query : queries_input)
+    {
+        auto it = compiled.find(query);
+        if (it == compiled.end())
+        {
+            it = compiled.emplace(query, Compile(query)).first;
+        }
+        result.emplace_back(search(it->second, static_cast<size_t>(std::max(response_limit, 0))));
+    }
+
+    QUERY_PHASE(Output);
     std::vector<std::vector<std::pair<int, float>>> result_pairs; // Пары {doc_id, rank} для одного запроса
-    for (const auto& vec : result)
+    std::vector<std::string> suggestions(result.size()); // Подсказки для запросов без результатов
+    for (size_t i = 0; i < result.size(); ++i)
     {
+        const auto& vec = result[i];
+        if (vec.empty())
+        {
+            suggestions[i] = Suggest(queries_input[i]);
+        }
         std::vector<std::pair<int, float>> pairs; // Пары {doc_id, rank} для текущего запроса
         for (const auto& rel_index : vec)
         {
@@ -85,7 +343,7 @@ std::vector<std::vector<RelativeIndex>> SearchServer::search(const std::vector<s
         }
         result_pairs.emplace_back(std::move(pairs));
     }
-    converter.putAnswers(result_pairs);
+    converter.putAnswers(result_pairs, suggestions);
 
     return result;
 }
\ No newline at end of file
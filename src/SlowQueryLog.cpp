@@ -0,0 +1,74 @@
+#include "SlowQueryLog.h"
+#include <iostream>
+#include <nlohmann/json.hpp>
+
+nlohmann::ordered_json SlowQueryRecordToJson(const SlowQueryRecord& record)
+{
+    nlohmann::ordered_json terms = nlohmann::ordered_json::array();
+    for (const auto& [term, postings] : record.terms)
+    {
+        terms.push_back({ term, postings });
+    }
+    nlohmann::ordered_json phases = nlohmann::ordered_json::object();
+    for (size_t phase = 0; phase < QUERY_PHASE_COUNT; ++phase)
+    {
+        // Время запроса целиком - в latency_ns
+        if (static_cast<QueryPhase>(phase) != QueryPhase::Query)
+        {
+            phases[QueryPhaseName(static_cast<QueryPhase>(phase))] = record.phase_ns[phase];
+        }
+    }
+    return {
+        { "query", record.query },
+        { "limit", record.limit },
+        { "latency_ns", record.latency_ns },
+        { "results", record.results },
+        { "docs_scored", record.docs_scored },
+        { "strategy", record.strategy },
+        { "terms", std::move(terms) },
+        { "phases_ns", std::move(phases) }
+    };
+}
+
+void SlowQueryLog::SetFile(const std::string& path)
+{
+    const std::lock_guard lock(_mutex);
+    _path = path;
+    _file.close();
+    if (!path.empty())
+    {
+        _file.open(path, std::ios::app);
+        if (!_file.is_open())
+        {
+            std::cerr << "Warning: Could not open slow query log " << path << ", using stderr" << std::endl;
+        }
+    }
+}
+
+void SlowQueryLog::Write(SlowQueryRecord record)
+{
+    // Строка готовится до блокировки, чтобы медленные запросы разных потоков не ждали друг друга
+    const std::string line = SlowQueryRecordToJson(record).dump();
+    const std::lock_guard lock(_mutex);
+    std::ostream& out = _file.is_open() ? static_cast<std::ostream&>(_file) : std::cerr;
+    out << line << '\n';
+    out.flush(); // запись не должна пропасть, если процесс аварийно завершится
+    ++_count;
+    _recent.push_back(std::move(record));
+    if (_recent.size() > MAX_RECENT)
+    {
+        _recent.pop_front();
+    }
+}
+
+std::vector<SlowQueryRecord> SlowQueryLog::GetRecent() const
+{
+    const std::lock_guard lock(_mutex);
+    return { _recent.begin(), _recent.end() };
+}
+
+uint64_t SlowQueryLog::GetCount() const
+{
+    const std::lock_guard lock(_mutex);
+    return _count;
+}
@@ -0,0 +1,129 @@
+#include "SpellingIndex.h"
+#include <algorithm>
+#include <bit>
+#include <cstdlib>
+#include "FuzzyTerm.h"
+
+namespace
+{
+    // FNV-1a по символам строки
+    uint32_t HashCodePoints(const std::vector<uint32_t>& code_points)
+    {
+        uint32_t hash = 2166136261u;
+        for (const uint32_t c : code_points)
+        {
+            hash = (hash ^ c) * 16777619u;
+        }
+        return hash;
+    }
+
+    // Хэши строк, получающихся из word удалением не больше left символов начиная с позиции from.
+    // Каждый набор позиций удаляется один раз, одинаковые строки из повторяющихся букв
+    // остаются - их убирает вызывающий
+    void AppendDeletes(std::vector<uint32_t>& word, size_t from, size_t left, std::vector<uint32_t>& out)
+    {
+        out.push_back(HashCodePoints(word));
+        if (left == 0)
+        {
+            return;
+        }
+        for (size_t i = from; i < word.size(); ++i)
+        {
+            const uint32_t removed = word[i];
+            word.erase(word.begin() + static_cast<std::ptrdiff_t>(i));
+            AppendDeletes(word, i, left - 1, out);
+            word.insert(word.begin() + static_cast<std::ptrdiff_t>(i), removed);
+        }
+    }
+
+    // Длина слова в символах, ограниченная 255
+    uint8_t CodePointLength(const std::vector<uint32_t>& code_points)
+    {
+        return static_cast<uint8_t>(std::min<size_t>(code_points.size(), 255));
+    }
+
+    // Хэши удалений из префикса слова без повторов
+    std::vector<uint32_t> PrefixDeletes(std::vector<uint32_t> prefix, size_t distance)
+    {
+        prefix.resize(std::min(prefix.size(), SPELLING_PREFIX_LENGTH));
+        std::vector<uint32_t> hashes;
+        AppendDeletes(prefix, 0, distance, hashes);
+        std::sort(hashes.begin(), hashes.end());
+        hashes.erase(std::unique(hashes.begin(), hashes.end()), hashes.end());
+        return hashes;
+    }
+}
+
+void SpellingIndex::Build(const std::vector<std::string>& terms, size_t max_distance)
+{
+    Clear();
+    _max_distance = max_distance;
+    _lengths.reserve(terms.size());
+    for (uint32_t id = 0; id < terms.size(); ++id)
+    {
+        std::vector<uint32_t> code_points = DecodeUtf8(terms[id]);
+        _lengths.push_back(CodePointLength(code_points));
+        for (const uint32_t hash : PrefixDeletes(std::move(code_points), max_distance))
+        {
+            _entries.push_back(static_cast<uint64_t>(hash) << 32 | id);
+        }
+    }
+    std::sort(_entries.begin(), _entries.end());
+    _entries.shrink_to_fit();
+
+    // Корзины по старшим битам хэша: в среднем одно-два удаления на корзину
+    const unsigned bits = std::max(1, static_cast<int>(std::bit_width(_entries.size())) - 1);
+    _shift = 32 - std::min(bits, 31u);
+    _buckets.assign((size_t{ 1 } << (32 - _shift)) + 1, 0);
+    for (const uint64_t entry : _entries)
+    {
+        ++_buckets[(static_cast<uint32_t>(entry >> 32) >> _shift) + 1];
+    }
+    for (size_t i = 1; i < _buckets.size(); ++i)
+    {
+        _buckets[i] += _buckets[i - 1];
+    }
+}
+
+void SpellingIndex::Clear()
+{
+    _entries.clear();
+    _entries.shrink_to_fit();
+    _buckets.clear();
+    _buckets.shrink_to_fit();
+    _lengths.clear();
+    _lengths.shrink_to_fit();
+    _shift = 32;
+    _max_distance = 0;
+}
+
+// Слова, у которых есть удаление, совпадающее с удалением из слова запроса
+std::vector<uint32_t> SpellingIndex::Candidates(std::string_view word, size_t distance) const
+{
+    std::vector<uint32_t> ids;
+    if (_entries.empty())
+    {
+        return ids;
+    }
+    std::vector<uint32_t> code_points = DecodeUtf8(word);
+    const int length = CodePointLength(code_points);
+    const int max_difference = static_cast<int>(distance);
+    for (const uint32_t hash : PrefixDeletes(std::move(code_points), std::min(distance, _max_distance)))
+    {
+        const size_t bucket = hash >> _shift;
+        const auto begin = _entries.begin() + _buckets[bucket];
+        const auto end = _entries.begin() + _buckets[bucket + 1];
+        for (auto it = std::lower_bound(begin, end, static_cast<uint64_t>(hash) << 32);
+             it != end && static_cast<uint32_t>(*it >> 32) == hash; ++it)
+        {
+            const auto id = static_cast<uint32_t>(*it);
+            if (std::abs(_lengths[id] - length) <= max_difference)
+            {
+                ids.push_back(id);
+            }
+        }
+    }
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+    return ids;
+}
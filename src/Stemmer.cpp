@@ -0,0 +1,553 @@
+#include "Stemmer.h"
+#include <algorithm>
+#include <array>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+    // ---------------- Русский стеммер (Snowball) ----------------
+
+    // Окончание и признак первой группы: такие окончания отделяются только после "а" или "я"
+    struct Ending
+    {
+        std::u32string text;
+
+        bool after_a_ya = false;
+    };
+
+    using Endings = std::vector<Ending>;
+
+    // Список окончаний, упорядоченный от длинных к коротким (ищется самое длинное совпадение).
+    // after_a_ya - окончания первой группы, other - остальные
+    Endings MakeEndings(std::initializer_list<const char32_t*> after_a_ya, std::initializer_list<const char32_t*> other)
+    {
+        Endings endings;
+        for (const char32_t* text : after_a_ya)
+        {
+            endings.push_back({ text, true });
+        }
+        for (const char32_t* text : other)
+        {
+            endings.push_back({ text, false });
+        }
+        std::stable_sort(endings.begin(), endings.end(), [](const Ending& a, const Ending& b)
+        {
+            return a.text.size() > b.text.size();
+        });
+        return endings;
+    }
+
+    const Endings PERFECTIVE_GERUND = MakeEndings(
+        { U"в", U"вши", U"вшись" },
+        { U"ив", U"ивши", U"ившись", U"ыв", U"ывши", U"ывшись" });
+
+    const Endings ADJECTIVE = MakeEndings({},
+        { U"ее", U"ие", U"ые", U"ое", U"ими", U"ыми", U"ей", U"ий", U"ый", U"ой", U"ем", U"им", U"ым",
+          U"ом", U"его", U"ого", U"ему", U"ому", U"их", U"ых", U"ую", U"юю", U"ая", U"яя", U"ою", U"ею" });
+
+    const Endings PARTICIPLE = MakeEndings(
+        { U"ем", U"нн", U"вш", U"ющ", U"щ" },
+        { U"ивш", U"ывш", U"ующ" });
+
+    const Endings REFLEXIVE = MakeEndings({}, { U"ся", U"сь" });
+
+    const Endings VERB = MakeEndings(
+        { U"ла", U"на", U"ете", U"йте", U"ли", U"й", U"л", U"ем", U"н", U"ло", U"но", U"ет", U"ют", U"ны",
+          U"ть", U"ешь", U"нно" },
+        { U"ила", U"ыла", U"ена", U"ейте", U"уйте", U"ите", U"или", U"ыли", U"ей", U"уй", U"ил", U"ыл",
+          U"им", U"ым", U"ен", U"ило", U"ыло", U"ено", U"ят", U"ует", U"уют", U"ит", U"ыт", U"ены", U"ить",
+          U"ыть", U"ишь", U"ую", U"ю" });
+
+    const Endings NOUN = MakeEndings({},
+        { U"а", U"ев", U"ов", U"ие", U"ье", U"е", U"иями", U"ями", U"ами", U"еи", U"ии", U"и", U"ией",
+          U"ей", U"ой", U"ий", U"й", U"иям", U"ям", U"ием", U"ем", U"ам", U"ом", U"о", U"у", U"ах", U"иях",
+          U"ях", U"ы", U"ь", U"ию", U"ью", U"ю", U"ия", U"ья", U"я" });
+
+    const Endings DERIVATIONAL = MakeEndings({}, { U"ост", U"ость" });
+
+    const Endings TIDY_UP = MakeEndings({}, { U"ейше", U"ейш", U"н", U"ь" });
+
+    bool IsRussianVowel(char32_t c)
+    {
+        return c == U'а' || c == U'е' || c == U'и' || c == U'о' || c == U'у' || c == U'ы' || c == U'э' ||
+               c == U'ю' || c == U'я';
+    }
+
+    bool EndsWith(const std::u32string& word, const std::u32string& ending, size_t region)
+    {
+        return word.size() >= region + ending.size() &&
+               word.compare(word.size() - ending.size(), ending.size(), ending) == 0;
+    }
+
+    // Самое длинное из окончаний endings, целиком лежащее в области region.
+    // Как в Snowball: если у найденного окончания не выполнено условие "после а/я",
+    // более короткие окончания не рассматриваются
+    const Ending* FindEnding(const std::u32string& word, size_t region, const Endings& endings)
+    {
+        for (const Ending& ending : endings)
+        {
+            if (!EndsWith(word, ending.text, region))
+            {
+                continue;
+            }
+            if (ending.after_a_ya)
+            {
+                const size_t before = word.size() - ending.text.size();
+                if (before == region || (word[before - 1] != U'а' && word[before - 1] != U'я'))
+                {
+                    return nullptr;
+                }
+            }
+            return &ending;
+        }
+        return nullptr;
+    }
+
+    // Удаляет окончание из endings, если оно есть. Возвращает true, если удалено
+    bool RemoveEnding(std::u32string& word, size_t region, const Endings& endings)
+    {
+        const Ending* ending = FindEnding(word, region, endings);
+        if (!ending)
+        {
+            return false;
+        }
+        word.resize(word.size() - ending->text.size());
+        return true;
+    }
+
+    // Начало области после первого сочетания "гласная, согласная", начиная с from
+    size_t RegionAfterVowelConsonant(const std::u32string& word, size_t from)
+    {
+        for (size_t i = from + 1; i < word.size(); ++i)
+        {
+            if (!IsRussianVowel(word[i]) && IsRussianVowel(word[i - 1]))
+            {
+                return i + 1;
+            }
+        }
+        return word.size();
+    }
+
+    // Слово из строчных русских букв в виде кодовых точек; false - в слове есть другие символы
+    bool DecodeRussian(const std::string& word, std::u32string& out)
+    {
+        if (word.size() % 2 != 0)
+        {
+            return false;
+        }
+        out.clear();
+        for (size_t i = 0; i < word.size(); i += 2)
+        {
+            const auto lead = static_cast<unsigned char>(word[i]);
+            const auto next = static_cast<unsigned char>(word[i + 1]);
+            const char32_t c = ((lead & 0x1F) << 6) | (next & 0x3F);
+            if ((lead & 0xE0) != 0xC0 || c < U'а' || c > U'я')
+            {
+                return false;
+            }
+            out.push_back(c);
+        }
+        return true;
+    }
+
+    std::string EncodeRussian(const std::u32string& word)
+    {
+        std::string out;
+        out.reserve(word.size() * 2);
+        for (char32_t c : word)
+        {
+            out += static_cast<char>(0xC0 | (c >> 6));
+            out += static_cast<char>(0x80 | (c & 0x3F));
+        }
+        return out;
+    }
+
+    // ---------------- Английский стеммер (Портер) ----------------
+
+    // Состояние алгоритма Портера: слово и конец рассматриваемой основы j
+    class PorterWord
+    {
+    public:
+        explicit PorterWord(std::string word) : _b(std::move(word)) {}
+
+        std::string Stem()
+        {
+            Step1ab();
+            if (_b.size() > 1)
+            {
+                Step1c();
+                Step2();
+                Step3();
+                Step4();
+                Step5();
+            }
+            return _b;
+        }
+
+    private:
+        bool IsConsonant(int i) const
+        {
+            switch (_b[i])
+            {
+            case 'a': case 'e': case 'i': case 'o': case 'u':
+                return false;
+            case 'y':
+                return i == 0 || !IsConsonant(i - 1);
+            default:
+                return true;
+            }
+        }
+
+        // Мера m основы _b[0.._j]: количество сочетаний "гласные, согласные"
+        int Measure() const
+        {
+            int n = 0;
+            int i = 0;
+            while (i <= _j && IsConsonant(i))
+            {
+                ++i;
+            }
+            while (i <= _j)
+            {
+                while (i <= _j && !IsConsonant(i))
+                {
+                    ++i;
+                }
+                if (i > _j)
+                {
+                    break;
+                }
+                ++n;
+                while (i <= _j && IsConsonant(i))
+                {
+                    ++i;
+                }
+            }
+            return n;
+        }
+
+        bool VowelInStem() const
+        {
+            for (int i = 0; i <= _j; ++i)
+            {
+                if (!IsConsonant(i))
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        bool DoubleConsonant(int i) const
+        {
+            return i >= 1 && _b[i] == _b[i - 1] && IsConsonant(i);
+        }
+
+        // Согласная-гласная-согласная в конце на позиции i, последняя не w, x, y
+        bool Cvc(int i) const
+        {
+            if (i < 2 || !IsConsonant(i) || IsConsonant(i - 1) || !IsConsonant(i - 2))
+            {
+                return false;
+            }
+            return _b[i] != 'w' && _b[i] != 'x' && _b[i] != 'y';
+        }
+
+        int Last() const { return static_cast<int>(_b.size()) - 1; }
+
+        bool Ends(const std::string& suffix)
+        {
+            if (suffix.size() > _b.size() || _b.compare(_b.size() - suffix.size(), suffix.size(), suffix) != 0)
+            {
+                return false;
+            }
+            _j = static_cast<int>(_b.size() - suffix.size()) - 1;
+            return true;
+        }
+
+        void SetTo(const std::string& replacement)
+        {
+            _b.resize(_j + 1);
+            _b += replacement;
+        }
+
+        // Заменяет первое найденное окончание из rules, если мера основы больше min_measure
+        void ReplaceFirst(std::initializer_list<std::pair<const char*, const char*>> rules, int min_measure)
+        {
+            for (const auto& [suffix, replacement] : rules)
+            {
+                if (Ends(suffix))
+                {
+                    if (Measure() > min_measure)
+                    {
+                        SetTo(replacement);
+                    }
+                    return;
+                }
+            }
+        }
+
+        void Step1ab()
+        {
+            if (_b.back() == 's')
+            {
+                if (Ends("sses"))
+                {
+                    _b.resize(_b.size() - 2);
+                }
+                else if (Ends("ies"))
+                {
+                    SetTo("i");
+                }
+                else if (_b[_b.size() - 2] != 's')
+                {
+                    _b.pop_back();
+                }
+            }
+            if (Ends("eed"))
+            {
+                if (Measure() > 0)
+                {
+                    _b.pop_back();
+                }
+            }
+            else if ((Ends("ed") || Ends("ing")) && VowelInStem())
+            {
+                _b.resize(_j + 1);
+                if (Ends("at"))
+                {
+                    SetTo("ate");
+                }
+                else if (Ends("bl"))
+                {
+                    SetTo("ble");
+                }
+                else if (Ends("iz"))
+                {
+                    SetTo("ize");
+                }
+                else if (DoubleConsonant(Last()))
+                {
+                    const char c = _b[Last()];
+                    if (c != 'l' && c != 's' && c != 'z')
+                    {
+                        _b.pop_back();
+                    }
+                }
+                else
+                {
+                    _j = Last();
+                    if (Measure() == 1 && Cvc(Last()))
+                    {
+                        SetTo("e");
+                    }
+                }
+            }
+        }
+
+        void Step1c()
+        {
+            if (Ends("y") && VowelInStem())
+            {
+                _b.back() = 'i';
+            }
+        }
+
+        void Step2()
+        {
+            ReplaceFirst({ { "ational", "ate" }, { "tional", "tion" }, { "enci", "ence" }, { "anci", "ance" },
+                           { "izer", "ize" }, { "bli", "ble" }, { "alli", "al" }, { "entli", "ent" },
+                           { "eli", "e" }, { "ousli", "ous" }, { "ization", "ize" }, { "ation", "ate" },
+                           { "ator", "ate" }, { "alism", "al" }, { "iveness", "ive" }, { "fulness", "ful" },
+                           { "ousness", "ous" }, { "aliti", "al" }, { "iviti", "ive" }, { "biliti", "ble" },
+                           { "logi", "log" } }, 0);
+        }
+
+        void Step3()
+        {
+            ReplaceFirst({ { "icate", "ic" }, { "ative", "" }, { "alize", "al" }, { "iciti", "ic" },
+                           { "ical", "ic" }, { "ful", "" }, { "ness", "" } }, 0);
+        }
+
+        void Step4()
+        {
+            static const char* const suffixes[] =
+                { "al", "ance", "ence", "er", "ic", "able", "ible", "ant", "ement", "ment", "ent",
+                  "ion", "ou", "ism", "ate", "iti", "ous", "ive", "ize" };
+            for (const char* suffix : suffixes)
+            {
+                if (!Ends(suffix))
+                {
+                    continue;
+                }
+                if (suffix == std::string("ion") && (_j < 0 || (_b[_j] != 's' && _b[_j] != 't')))
+                {
+                    continue;
+                }
+                if (Measure() > 1)
+                {
+                    _b.resize(_j + 1);
+                }
+                return;
+            }
+        }
+
+        void Step5()
+        {
+            _j = Last();
+            if (_b.back() == 'e')
+            {
+                const int m = Measure();
+                if (m > 1 || (m == 1 && !Cvc(Last() - 1)))
+                {
+                    _b.pop_back();
+                }
+            }
+            _j = Last();
+            if (_b.back() == 'l' && DoubleConsonant(Last()) && Measure() > 1)
+            {
+                _b.pop_back();
+            }
+        }
+
+        std::string _b;
+
+        int _j = 0;
+    };
+
+    bool IsAsciiWord(const std::string& word)
+    {
+        return std::all_of(word.begin(), word.end(), [](char c) { return c >= 'a' && c <= 'z'; });
+    }
+
+    // Наибольшее количество запомненных основ в одном потоке для одного стеммера
+    constexpr size_t STEM_CACHE_LIMIT = 1 << 16;
+}
+
+std::string RussianStemmer::Stem(const std::string& word) const
+{
+    std::u32string w;
+    if (!DecodeRussian(word, w))
+    {
+        return word;
+    }
+    // RV - после первой гласной, R2 - после второго сочетания "гласная, согласная"
+    const auto first_vowel = std::find_if(w.begin(), w.end(), IsRussianVowel);
+    if (first_vowel == w.end())
+    {
+        return word;
+    }
+    const size_t rv = static_cast<size_t>(first_vowel - w.begin()) + 1;
+    const size_t r1 = RegionAfterVowelConsonant(w, 0);
+    const size_t r2 = RegionAfterVowelConsonant(w, r1);
+
+    // Шаг 1: деепричастие, иначе возвратная частица и прилагательное/глагол/существительное
+    if (!RemoveEnding(w, rv, PERFECTIVE_GERUND))
+    {
+        RemoveEnding(w, rv, REFLEXIVE);
+        if (RemoveEnding(w, rv, ADJECTIVE))
+        {
+            RemoveEnding(w, rv, PARTICIPLE);
+        }
+        else if (!RemoveEnding(w, rv, VERB))
+        {
+            RemoveEnding(w, rv, NOUN);
+        }
+    }
+    // Шаг 2: конечная "и"
+    if (EndsWith(w, U"и", rv))
+    {
+        w.pop_back();
+    }
+    // Шаг 3: словообразовательный суффикс в R2
+    RemoveEnding(w, std::max(rv, r2), DERIVATIONAL);
+    // Шаг 4: превосходная степень, удвоенная "н", мягкий знак
+    if (const Ending* ending = FindEnding(w, rv, TIDY_UP))
+    {
+        if (ending->text == U"ь")
+        {
+            w.pop_back();
+        }
+        else if (ending->text == U"н")
+        {
+            if (EndsWith(w, U"нн", rv))
+            {
+                w.pop_back();
+            }
+        }
+        else
+        {
+            w.resize(w.size() - ending->text.size());
+            if (EndsWith(w, U"нн", rv))
+            {
+                w.pop_back();
+            }
+        }
+    }
+    return EncodeRussian(w);
+}
+
+std::string PorterStemmer::Stem(const std::string& word) const
+{
+    if (word.size() <= 2 || !IsAsciiWord(word))
+    {
+        return word;
+    }
+    return PorterWord(word).Stem();
+}
+
+std::string AutoStemmer::Stem(const std::string& word) const
+{
+    if (word.empty())
+    {
+        return word;
+    }
+    const auto lead = static_cast<unsigned char>(word[0]);
+    if (lead == 0xD0 || lead == 0xD1)
+    {
+        return RussianStemmer().Stem(word);
+    }
+    return PorterStemmer().Stem(word);
+}
+
+// Возвращает стеммер заданного вида, nullptr для StemmerType::None
+const Stemmer* GetStemmer(StemmerType type)
+{
+    static const RussianStemmer russian;
+    static const PorterStemmer english;
+    static const AutoStemmer automatic;
+    switch (type)
+    {
+    case StemmerType::Russian:
+        return &russian;
+    case StemmerType::English:
+        return &english;
+    case StemmerType::Auto:
+        return &automatic;
+    case StemmerType::None:
+    default:
+        return nullptr;
+    }
+}
+
+// Основа слова с запоминанием в словаре текущего потока
+std::string StemWord(StemmerType type, const std::string& word)
+{
+    const Stemmer* stemmer = GetStemmer(type);
+    if (!stemmer)
+    {
+        return word;
+    }
+    thread_local std::array<std::unordered_map<std::string, std::string>, 4> caches;
+    auto& cache = caches[static_cast<size_t>(type)];
+    if (auto it = cache.find(word); it != cache.end())
+    {
+        return it->second;
+    }
+    if (cache.size() >= STEM_CACHE_LIMIT)
+    {
+        cache.clear();
+    }
+    return cache.emplace(word, stemmer->Stem(word)).first->second;
+}
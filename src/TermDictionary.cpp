@@ -0,0 +1,632 @@
+#include "TermDictionary.h"
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace
+{
+    void PutVarint(std::vector<uint8_t>& out, size_t value)
+    {
+        while (value >= 0x80)
+        {
+            out.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<uint8_t>(value));
+    }
+
+    size_t GetVarint(const uint8_t*& data)
+    {
+        size_t value = 0;
+        int shift = 0;
+        while (*data & 0x80)
+        {
+            value |= static_cast<size_t>(*data++ & 0x7F) << shift;
+            shift += 7;
+        }
+        value |= static_cast<size_t>(*data++) << shift;
+        return value;
+    }
+
+    // Заголовок буфера: сигнатура, количество слов, адрес начального состояния
+    constexpr char MAGIC[4] = { 'T', 'F', 'S', 'T' };
+    constexpr size_t HEADER_SIZE = 12;
+
+    // Переход автомата. Состояние записано как varint(количество переходов * 2 + конечность),
+    // за ним переходы по возрастанию меток: метка, varint(выход), varint(расстояние до цели)
+    struct Arc
+    {
+        uint8_t label;   // Байт слова
+        uint32_t output; // Количество слов, меньших слов этого перехода, среди слов состояния
+        uint32_t target; // Адрес состояния, в которое ведет переход
+    };
+
+    // Читает заголовок состояния, возвращает указатель на первый переход
+    const uint8_t* ReadState(const uint8_t* bytes, uint32_t state, bool& final, size_t& arcs)
+    {
+        const uint8_t* data = bytes + state;
+        const size_t header = GetVarint(data);
+        final = (header & 1) != 0;
+        arcs = header >> 1;
+        return data;
+    }
+
+    void ReadArc(const uint8_t*& data, uint32_t state, Arc& arc)
+    {
+        arc.label = *data++;
+        arc.output = static_cast<uint32_t>(GetVarint(data));
+        arc.target = state - static_cast<uint32_t>(GetVarint(data));
+    }
+
+    // GetVarint для непроверенного буфера: не читает за end и не допускает значений больше uint32_t
+    bool GetVarintChecked(const uint8_t*& data, const uint8_t* end, size_t& value)
+    {
+        value = 0;
+        for (int shift = 0; shift < 35; shift += 7)
+        {
+            if (data >= end)
+            {
+                return false;
+            }
+            const uint8_t byte = *data++;
+            value |= static_cast<size_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0)
+            {
+                return value <= std::numeric_limits<uint32_t>::max();
+            }
+        }
+        return false;
+    }
+
+    // Проверяет автомат подключаемого буфера. Каждое достижимое состояние разбирается один раз:
+    // заголовок и переходы лежат внутри буфера, метки возрастают, цель перехода лежит между
+    // заголовком буфера и самим состоянием (цели записываются раньше, поэтому циклов нет).
+    // Затем по возрастанию адресов считаются слова состояний: выход каждого перехода равен
+    // количеству слов предыдущих, а у корня слов столько, сколько записано в заголовке
+    bool CheckAutomaton(const uint8_t* bytes, size_t size, uint32_t root, uint32_t count)
+    {
+        const uint8_t* end = bytes + size;
+        std::vector<uint32_t> states;
+        std::unordered_set<uint32_t> seen{ root };
+        std::vector<uint32_t> pending{ root };
+        while (!pending.empty())
+        {
+            const uint32_t state = pending.back();
+            pending.pop_back();
+            states.push_back(state);
+            const uint8_t* data = bytes + state;
+            size_t header = 0;
+            if (!GetVarintChecked(data, end, header) || (header >> 1) > 256)
+            {
+                return false;
+            }
+            int previous_label = -1;
+            for (size_t arcs = header >> 1; arcs > 0; --arcs)
+            {
+                size_t output = 0;
+                size_t distance = 0;
+                if (data >= end || *data <= previous_label)
+                {
+                    return false;
+                }
+                previous_label = *data++;
+                if (!GetVarintChecked(data, end, output) || !GetVarintChecked(data, end, distance) ||
+                    distance == 0 || distance > state - HEADER_SIZE)
+                {
+                    return false;
+                }
+                const auto target = static_cast<uint32_t>(state - distance);
+                if (seen.insert(target).second)
+                {
+                    pending.push_back(target);
+                }
+            }
+        }
+        // Цели лежат по меньшим адресам, поэтому их слова посчитаны раньше
+        std::sort(states.begin(), states.end());
+        std::unordered_map<uint32_t, uint32_t> counts;
+        counts.reserve(states.size());
+        for (const uint32_t state : states)
+        {
+            bool final = false;
+            size_t arcs = 0;
+            const uint8_t* data = ReadState(bytes, state, final, arcs);
+            uint64_t words = final ? 1 : 0;
+            for (; arcs > 0; --arcs)
+            {
+                Arc arc{};
+                ReadArc(data, state, arc);
+                const uint32_t target_words = counts[arc.target];
+                if (arc.output != words || target_words == 0)
+                {
+                    return false;
+                }
+                words += target_words;
+            }
+            if (words > std::numeric_limits<uint32_t>::max())
+            {
+                return false;
+            }
+            counts[state] = static_cast<uint32_t>(words);
+        }
+        return counts[root] == count;
+    }
+
+    // Обход в глубину для Intersect. Возвращает false, если перебор прерван
+    bool IntersectState(const uint8_t* bytes, uint32_t state, uint32_t id, int automaton_state,
+                        TermAutomaton& automaton, std::string& term,
+                        const std::function<bool(const std::string&, uint32_t)>& visit)
+    {
+        bool final = false;
+        size_t arcs = 0;
+        const uint8_t* data = ReadState(bytes, state, final, arcs);
+        if (final && automaton.IsMatch(automaton_state) && !visit(term, id))
+        {
+            return false;
+        }
+        for (; arcs > 0; --arcs)
+        {
+            Arc arc{};
+            ReadArc(data, state, arc);
+            const int next = automaton.Step(automaton_state, arc.label);
+            if (next < 0)
+            {
+                continue;
+            }
+            term += static_cast<char>(arc.label);
+            const bool proceed = IntersectState(bytes, arc.target, id + arc.output, next, automaton, term, visit);
+            term.pop_back();
+            if (!proceed)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Построение минимального автомата из упорядоченных слов (алгоритм Дацюка):
+    // состояния вдоль последнего добавленного слова еще изменяемы, остальные записаны
+    // в буфер. Перед записью состояние ищется среди уже записанных эквивалентных
+    class FstBuilder
+    {
+    public:
+        explicit FstBuilder(std::vector<uint8_t>& out) : _out(out) {}
+
+        // Переход изменяемого состояния: цель и количество ее слов известны после записи цели
+        struct PendingArc
+        {
+            uint8_t label;
+            uint32_t target;
+            uint32_t count;
+        };
+
+        struct PendingState
+        {
+            bool final = false;
+            std::vector<PendingArc> arcs;
+        };
+
+        // Записывает состояние (или находит эквивалентное), возвращает адрес и количество его слов
+        std::pair<uint32_t, uint32_t> Compile(const PendingState& state)
+        {
+            _key.clear();
+            _key += static_cast<char>(state.final);
+            for (const auto& arc : state.arcs)
+            {
+                _key += static_cast<char>(arc.label);
+                _key.append(reinterpret_cast<const char*>(&arc.target), sizeof(arc.target));
+            }
+            if (auto it = _registry.find(_key); it != _registry.end())
+            {
+                return it->second;
+            }
+            const auto address = static_cast<uint32_t>(_out.size());
+            PutVarint(_out, (state.arcs.size() << 1) | (state.final ? 1 : 0));
+            uint32_t output = state.final ? 1 : 0;
+            for (const auto& arc : state.arcs)
+            {
+                _out.push_back(arc.label);
+                PutVarint(_out, output);
+                PutVarint(_out, address - arc.target);
+                output += arc.count;
+            }
+            _registry.emplace(_key, std::make_pair(address, output));
+            return { address, output };
+        }
+
+    private:
+        std::vector<uint8_t>& _out;
+
+        std::unordered_map<std::string, std::pair<uint32_t, uint32_t>> _registry; // Записанные состояния
+
+        std::string _key;
+    };
+}
+
+// Строит словарь из упорядоченных неповторяющихся слов
+void TermDictionary::Build(const std::vector<std::string>& sorted_terms)
+{
+    Clear();
+    _buffer.resize(HEADER_SIZE);
+    FstBuilder builder(_buffer);
+    std::vector<FstBuilder::PendingState> frontier(1);
+    std::string_view previous;
+    for (const std::string& term : sorted_terms)
+    {
+        size_t prefix = 0;
+        while (prefix < previous.size() && prefix < term.size() && previous[prefix] == term[prefix])
+        {
+            ++prefix;
+        }
+        // Окончание предыдущего слова больше не изменится - записываем его
+        for (size_t i = previous.size(); i > prefix; --i)
+        {
+            const auto [address, count] = builder.Compile(frontier[i]);
+            frontier[i - 1].arcs.back().target = address;
+            frontier[i - 1].arcs.back().count = count;
+        }
+        if (frontier.size() < term.size() + 1)
+        {
+            frontier.resize(term.size() + 1);
+        }
+        for (size_t i = prefix; i < term.size(); ++i)
+        {
+            frontier[i].arcs.push_back({ static_cast<uint8_t>(term[i]), 0, 0 });
+            frontier[i + 1].final = false;
+            frontier[i + 1].arcs.clear();
+        }
+        frontier[term.size()].final = true;
+        previous = term;
+    }
+    for (size_t i = previous.size(); i > 0; --i)
+    {
+        const auto [address, count] = builder.Compile(frontier[i]);
+        frontier[i - 1].arcs.back().target = address;
+        frontier[i - 1].arcs.back().count = count;
+    }
+    _root = builder.Compile(frontier[0]).first;
+    _size = sorted_terms.size();
+
+    const auto size = static_cast<uint32_t>(_size);
+    std::memcpy(_buffer.data(), MAGIC, sizeof(MAGIC));
+    std::memcpy(_buffer.data() + 4, &size, sizeof(size));
+    std::memcpy(_buffer.data() + 8, &_root, sizeof(_root));
+    _buffer.shrink_to_fit();
+    _bytes_size = _buffer.size();
+}
+
+// Подключает ранее построенный буфер без копирования, проверив автомат целиком: после этого
+// Find, Term и перебор не выходят за границы буфера
+bool TermDictionary::Attach(const uint8_t* data, size_t size)
+{
+    Clear();
+    uint32_t count = 0;
+    uint32_t root = 0;
+    if (data == nullptr || size < HEADER_SIZE || std::memcmp(data, MAGIC, sizeof(MAGIC)) != 0)
+    {
+        return false;
+    }
+    std::memcpy(&count, data + 4, sizeof(count));
+    std::memcpy(&root, data + 8, sizeof(root));
+    if (root < HEADER_SIZE || root >= size || !CheckAutomaton(data, size, root, count))
+    {
+        return false;
+    }
+    _external = data;
+    _bytes_size = size;
+    _root = root;
+    _size = count;
+    return true;
+}
+
+// Количество слов, проходящих через состояние: выход последнего перехода плюс слова его цели
+uint32_t TermDictionary::StateCount(uint32_t state) const
+{
+    const uint8_t* bytes = Bytes();
+    uint32_t count = 0;
+    while (true)
+    {
+        bool final = false;
+        size_t arcs = 0;
+        const uint8_t* data = ReadState(bytes, state, final, arcs);
+        if (arcs == 0)
+        {
+            return count + (final ? 1 : 0);
+        }
+        Arc arc{};
+        for (; arcs > 0; --arcs)
+        {
+            ReadArc(data, state, arc);
+        }
+        count += arc.output;
+        state = arc.target;
+    }
+}
+
+// Номер слова или NO_TERM
+uint32_t TermDictionary::Find(std::string_view term) const
+{
+    if (_size == 0)
+    {
+        return NO_TERM;
+    }
+    const uint8_t* bytes = Bytes();
+    uint32_t state = _root;
+    uint32_t id = 0;
+    bool final = false;
+    size_t arcs = 0;
+    for (const char ch : term)
+    {
+        const auto label = static_cast<uint8_t>(ch);
+        const uint8_t* data = ReadState(bytes, state, final, arcs);
+        bool found = false;
+        for (; arcs > 0; --arcs)
+        {
+            Arc arc{};
+            ReadArc(data, state, arc);
+            if (arc.label == label)
+            {
+                id += arc.output;
+                state = arc.target;
+                found = true;
+                break;
+            }
+            if (arc.label > label)
+            {
+                break; // Переходы упорядочены по меткам
+            }
+        }
+        if (!found)
+        {
+            return NO_TERM;
+        }
+    }
+    ReadState(bytes, state, final, arcs);
+    return final ? id : NO_TERM;
+}
+
+// Количество слов, меньших term
+uint32_t TermDictionary::LowerBound(std::string_view term) const
+{
+    if (_size == 0)
+    {
+        return 0;
+    }
+    const uint8_t* bytes = Bytes();
+    uint32_t state = _root;
+    uint32_t id = 0;
+    for (const char ch : term)
+    {
+        const auto label = static_cast<uint8_t>(ch);
+        bool final = false;
+        size_t arcs = 0;
+        const uint8_t* data = ReadState(bytes, state, final, arcs);
+        bool found = false;
+        for (; arcs > 0; --arcs)
+        {
+            Arc arc{};
+            ReadArc(data, state, arc);
+            if (arc.label == label)
+            {
+                id += arc.output;
+                state = arc.target;
+                found = true;
+                break;
+            }
+            if (arc.label > label)
+            {
+                return id + arc.output; // Меньше term только слова предыдущих переходов
+            }
+        }
+        if (!found)
+        {
+            return id + StateCount(state); // Все слова состояния меньше term
+        }
+    }
+    return id;
+}
+
+// Номера слов с заданным префиксом
+std::pair<uint32_t, uint32_t> TermDictionary::PrefixRange(std::string_view prefix) const
+{
+    const uint32_t first = LowerBound(prefix);
+    if (_size == 0)
+    {
+        return { first, first };
+    }
+    // Состояние, в которое ведет префикс: все его слова имеют этот префикс
+    const uint8_t* bytes = Bytes();
+    uint32_t state = _root;
+    for (const char ch : prefix)
+    {
+        const auto label = static_cast<uint8_t>(ch);
+        bool final = false;
+        size_t arcs = 0;
+        const uint8_t* data = ReadState(bytes, state, final, arcs);
+        bool found = false;
+        for (; arcs > 0 && !found; --arcs)
+        {
+            Arc arc{};
+            ReadArc(data, state, arc);
+            if (arc.label > label)
+            {
+                break;
+            }
+            if (arc.label == label)
+            {
+                state = arc.target;
+                found = true;
+            }
+        }
+        if (!found)
+        {
+            return { first, first };
+        }
+    }
+    return { first, first + StateCount(state) };
+}
+
+// Слово по номеру: на каждом шаге выбирается последний переход с выходом не больше остатка номера
+std::string TermDictionary::Term(uint32_t id) const
+{
+    std::string term;
+    if (id >= _size)
+    {
+        return term;
+    }
+    const uint8_t* bytes = Bytes();
+    uint32_t state = _root;
+    while (true)
+    {
+        bool final = false;
+        size_t arcs = 0;
+        const uint8_t* data = ReadState(bytes, state, final, arcs);
+        if (final && id == 0)
+        {
+            return term;
+        }
+        Arc chosen{};
+        for (; arcs > 0; --arcs)
+        {
+            Arc arc{};
+            ReadArc(data, state, arc);
+            if (arc.output > id)
+            {
+                break;
+            }
+            chosen = arc;
+        }
+        term += static_cast<char>(chosen.label);
+        id -= chosen.output;
+        state = chosen.target;
+    }
+}
+
+// Перебирает слова, допускаемые автоматом
+void TermDictionary::Intersect(TermAutomaton& automaton, const std::function<bool(const std::string&, uint32_t)>& visit) const
+{
+    if (_size == 0)
+    {
+        return;
+    }
+    const int start = automaton.Start();
+    if (start < 0)
+    {
+        return;
+    }
+    std::string term;
+    IntersectState(Bytes(), _root, 0, start, automaton, term, visit);
+}
+
+void TermDictionary::Clear()
+{
+    _buffer.clear();
+    _external = nullptr;
+    _bytes_size = 0;
+    _root = 0;
+    _size = 0;
+}
+
+TermDictionary::Iterator::Iterator(const TermDictionary& dictionary) : _dictionary(dictionary)
+{
+    Seek({});
+}
+
+bool TermDictionary::Iterator::Push(uint32_t state, uint32_t id)
+{
+    const uint8_t* bytes = _dictionary.Bytes();
+    bool final = false;
+    size_t arcs = 0;
+    const uint8_t* data = ReadState(bytes, state, final, arcs);
+    _stack.push_back({ state, static_cast<size_t>(data - bytes), arcs, id });
+    return final;
+}
+
+// Переходит к первому слову, не меньшему target
+void TermDictionary::Iterator::Seek(std::string_view target)
+{
+    _stack.clear();
+    _term.clear();
+    _at_end = _dictionary._size == 0;
+    if (_at_end)
+    {
+        return;
+    }
+    const uint8_t* bytes = _dictionary.Bytes();
+    bool final = Push(_dictionary._root, 0);
+    for (const char ch : target)
+    {
+        const auto label = static_cast<uint8_t>(ch);
+        bool matched = false;
+        Frame& top = _stack.back();
+        while (top.arcs_left > 0)
+        {
+            const uint8_t* data = bytes + top.cursor;
+            Arc arc{};
+            ReadArc(data, top.state, arc);
+            if (arc.label > label)
+            {
+                break; // Этот и следующие переходы ведут к словам больше target
+            }
+            top.cursor = static_cast<size_t>(data - bytes);
+            --top.arcs_left;
+            if (arc.label == label)
+            {
+                const uint32_t id = top.id + arc.output;
+                _term += ch;
+                final = Push(arc.target, id);
+                matched = true;
+                break;
+            }
+        }
+        if (!matched)
+        {
+            FindNext();
+            return;
+        }
+    }
+    if (final)
+    {
+        _id = _stack.back().id; // Слово совпало с target
+        return;
+    }
+    FindNext();
+}
+
+void TermDictionary::Iterator::Next()
+{
+    FindNext();
+}
+
+// Обход в глубину: первый непросмотренный переход вершины стека, при их отсутствии - возврат
+void TermDictionary::Iterator::FindNext()
+{
+    const uint8_t* bytes = _dictionary.Bytes();
+    while (!_stack.empty())
+    {
+        Frame& top = _stack.back();
+        if (top.arcs_left == 0)
+        {
+            _stack.pop_back();
+            if (!_stack.empty())
+            {
+                _term.pop_back();
+            }
+            continue;
+        }
+        const uint8_t* data = bytes + top.cursor;
+        Arc arc{};
+        ReadArc(data, top.state, arc);
+        top.cursor = static_cast<size_t>(data - bytes);
+        --top.arcs_left;
+        const uint32_t id = top.id + arc.output;
+        _term += static_cast<char>(arc.label);
+        if (Push(arc.target, id))
+        {
+            _id = id;
+            return;
+        }
+    }
+    _at_end = true;
+}
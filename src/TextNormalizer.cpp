@@ -0,0 +1,288 @@
+#include "TextNormalizer.h"
+#include <array>
+#include <cstring>
+
+namespace
+{
+    // Кодовые точки, кодируемые одним или двумя байтами UTF-8, обрабатываются по таблице
+    constexpr uint32_t TABLE_SIZE = 0x800;
+
+    // Таблица приведения к нижнему регистру: 0 - символ не буква и не цифра
+    using FoldTable = std::array<uint16_t, TABLE_SIZE>;
+
+    FoldTable BuildFoldTable()
+    {
+        FoldTable table{};
+        // Буквы без пары в другом регистре
+        const auto letters = [&](uint32_t from, uint32_t to)
+        {
+            for (uint32_t c = from; c <= to; ++c)
+            {
+                table[c] = static_cast<uint16_t>(c);
+            }
+        };
+        // Заглавные буквы, строчные для которых находятся на фиксированном расстоянии
+        const auto shift = [&](uint32_t from, uint32_t to, uint32_t delta)
+        {
+            for (uint32_t c = from; c <= to; ++c)
+            {
+                table[c] = static_cast<uint16_t>(c + delta);
+            }
+        };
+        // Чередующиеся пары "заглавная, строчная", начиная с from
+        const auto pairs = [&](uint32_t from, uint32_t to)
+        {
+            for (uint32_t c = from; c + 1 <= to; c += 2)
+            {
+                table[c] = static_cast<uint16_t>(c + 1);
+                table[c + 1] = static_cast<uint16_t>(c + 1);
+            }
+        };
+
+        // ASCII
+        letters('0', '9');
+        letters('a', 'z');
+        shift('A', 'Z', 0x20);
+
+        // Латиница-1 и расширенная латиница A
+        table[0xAA] = 0xAA;
+        table[0xB5] = 0x3BC; // Знак "микро" - греческая мю
+        table[0xBA] = 0xBA;
+        shift(0xC0, 0xDE, 0x20);
+        letters(0xDF, 0xFF);
+        table[0xD7] = 0; // Знаки умножения и деления
+        table[0xF7] = 0;
+        pairs(0x100, 0x12F);
+        table[0x130] = 'i';
+        table[0x131] = 0x131;
+        pairs(0x132, 0x137);
+        table[0x138] = 0x138;
+        pairs(0x139, 0x148);
+        table[0x149] = 0x149;
+        pairs(0x14A, 0x177);
+        table[0x178] = 0xFF;
+        pairs(0x179, 0x17E);
+        table[0x17F] = 's';
+        letters(0x180, 0x2AF); // Расширенная латиница B и IPA без приведения регистра
+
+        // Греческий алфавит
+        table[0x386] = 0x3AC;
+        shift(0x388, 0x38A, 0x25);
+        table[0x38C] = 0x3CC;
+        shift(0x38E, 0x38F, 0x3F);
+        table[0x390] = 0x390;
+        shift(0x391, 0x3A9, 0x20);
+        table[0x3A2] = 0;
+        letters(0x3AC, 0x3CE);
+        table[0x3C2] = 0x3C3; // Конечная сигма
+
+        // Кириллица
+        shift(0x400, 0x40F, 0x50);
+        shift(0x410, 0x42F, 0x20);
+        letters(0x430, 0x45F);
+        table[0x401] = 0x435; // Ё и ё не различаются с Е и е
+        table[0x451] = 0x435;
+        pairs(0x460, 0x481);
+        pairs(0x48A, 0x4BF);
+        table[0x4C0] = 0x4CF;
+        pairs(0x4C1, 0x4CE);
+        table[0x4CF] = 0x4CF;
+        pairs(0x4D0, 0x52F);
+
+        // Армянский, иврит, арабский
+        shift(0x531, 0x556, 0x30);
+        letters(0x561, 0x587);
+        letters(0x5D0, 0x5EA);
+        letters(0x620, 0x64A);
+        letters(0x660, 0x669);
+        letters(0x671, 0x6D3);
+        letters(0x6F0, 0x6F9);
+        return table;
+    }
+
+    const FoldTable& GetFoldTable()
+    {
+        static const FoldTable table = BuildFoldTable();
+        return table;
+    }
+
+    // Символы за пределами таблицы: пропускаются знаки препинания и символы
+    bool KeepWideCodePoint(uint32_t c)
+    {
+        return !(c >= 0x2000 && c <= 0x2BFF) && !(c >= 0x3000 && c <= 0x303F) &&
+               !(c >= 0xD800 && c <= 0xDFFF) && !(c >= 0xFE30 && c <= 0xFE4F) &&
+               !(c >= 0xFF01 && c <= 0xFF0F) && c < 0x10000;
+    }
+
+    void AppendCodePoint(uint32_t c, std::string& out)
+    {
+        if (c < 0x80)
+        {
+            out += static_cast<char>(c);
+        }
+        else if (c < 0x800)
+        {
+            out += static_cast<char>(0xC0 | (c >> 6));
+            out += static_cast<char>(0x80 | (c & 0x3F));
+        }
+        else
+        {
+            out += static_cast<char>(0xE0 | (c >> 12));
+            out += static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (c & 0x3F));
+        }
+    }
+
+    // Декодирует символ UTF-8, начинающийся с data[0]. Возвращает длину последовательности
+    // или 0, если она некорректна (обрывается, избыточна или кодирует суррогат)
+    size_t DecodeCodePoint(const unsigned char* data, size_t size, uint32_t& c)
+    {
+        const unsigned char lead = data[0];
+        size_t length;
+        uint32_t min;
+        if ((lead & 0xE0) == 0xC0)
+        {
+            length = 2;
+            min = 0x80;
+            c = lead & 0x1F;
+        }
+        else if ((lead & 0xF0) == 0xE0)
+        {
+            length = 3;
+            min = 0x800;
+            c = lead & 0x0F;
+        }
+        else if ((lead & 0xF8) == 0xF0)
+        {
+            length = 4;
+            min = 0x10000;
+            c = lead & 0x07;
+        }
+        else
+        {
+            return 0;
+        }
+        if (size < length)
+        {
+            return 0;
+        }
+        for (size_t i = 1; i < length; ++i)
+        {
+            if ((data[i] & 0xC0) != 0x80)
+            {
+                return 0;
+            }
+            c = (c << 6) | (data[i] & 0x3F);
+        }
+        if (c < min || c > 0x10FFFF || (c >= 0xD800 && c <= 0xDFFF))
+        {
+            return 0;
+        }
+        return length;
+    }
+
+    constexpr uint64_t ONES = 0x0101010101010101ULL;
+    constexpr uint64_t HIGH = 0x8080808080808080ULL;
+
+    // Старший бит каждого байта (все байты < 0x80) выставлен, если байт в диапазоне [lo, hi]
+    constexpr uint64_t BytesInRange(uint64_t chunk, uint8_t lo, uint8_t hi)
+    {
+        const uint64_t at_least_lo = chunk + ONES * (0x80 - lo);
+        const uint64_t above_hi = chunk + ONES * (0x7F - hi);
+        return at_least_lo & ~above_hi & HIGH;
+    }
+
+    // Все 8 байт - строчные латинские буквы или цифры и не требуют изменений
+    bool AllLowerAlnum(uint64_t chunk)
+    {
+        return (BytesInRange(chunk, 'a', 'z') | BytesInRange(chunk, '0', '9')) == HIGH;
+    }
+}
+
+// Приводит кодовую точку к нижнему регистру, 0 - не буква и не цифра
+uint32_t FoldCodePoint(uint32_t code_point)
+{
+    if (code_point < TABLE_SIZE)
+    {
+        return GetFoldTable()[code_point];
+    }
+    return KeepWideCodePoint(code_point) ? code_point : 0;
+}
+
+// Дописывает нормализованное слово в конец out
+void AppendNormalizedWord(std::string_view word, std::string& out)
+{
+    const FoldTable& table = GetFoldTable();
+    const auto* data = reinterpret_cast<const unsigned char*>(word.data());
+    const size_t size = word.size();
+    const size_t start = out.size();
+    size_t i = 0;
+    while (i < size)
+    {
+        // Быстрый путь: 8 байт ASCII за раз
+        if (i + 8 <= size)
+        {
+            uint64_t chunk;
+            std::memcpy(&chunk, data + i, sizeof(chunk));
+            if ((chunk & HIGH) == 0)
+            {
+                if (AllLowerAlnum(chunk))
+                {
+                    out.append(word.data() + i, 8);
+                }
+                else
+                {
+                    for (size_t j = i; j < i + 8; ++j)
+                    {
+                        if (const uint16_t folded = table[data[j]])
+                        {
+                            out += static_cast<char>(folded);
+                        }
+                    }
+                }
+                i += 8;
+                continue;
+            }
+        }
+        if (data[i] < 0x80)
+        {
+            if (const uint16_t folded = table[data[i]])
+            {
+                out += static_cast<char>(folded);
+            }
+            ++i;
+            continue;
+        }
+
+        uint32_t c = 0;
+        const size_t length = DecodeCodePoint(data + i, size - i, c);
+        if (length == 0)
+        {
+            ++i; // Некорректный байт пропускаем
+            continue;
+        }
+        i += length;
+        if (c >= 0x300 && c <= 0x36F)
+        {
+            // Комбинируемый знак: "и" + кратка - это "й", "е" + диерезис - "е" (как и "ё")
+            if (c == 0x306 && out.size() >= start + 2 && out.compare(out.size() - 2, 2, "\xD0\xB8") == 0)
+            {
+                out.back() = static_cast<char>(0xB9);
+            }
+            continue;
+        }
+        if (const uint32_t folded = FoldCodePoint(c))
+        {
+            AppendCodePoint(folded, out);
+        }
+    }
+}
+
+// Возвращает нормализованное слово
+std::string NormalizeWord(std::string_view word)
+{
+    std::string result;
+    result.reserve(word.size());
+    AppendNormalizedWord(word, result);
+    return result;
+}
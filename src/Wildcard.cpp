@@ -0,0 +1,196 @@
+#include "Wildcard.h"
+#include <algorithm>
+#include "TextNormalizer.h"
+
+// Есть ли в слове символы шаблона
+bool IsWildcardPattern(std::string_view word)
+{
+    return word.find_first_of("*?") != std::string_view::npos;
+}
+
+// Нормализует шаблон, сохраняя "*" и "?"
+std::string NormalizeWildcard(std::string_view pattern)
+{
+    std::string result;
+    size_t start = 0;
+    for (size_t i = 0; i <= pattern.size(); ++i)
+    {
+        if (i < pattern.size() && pattern[i] != '*' && pattern[i] != '?')
+        {
+            continue;
+        }
+        AppendNormalizedWord(pattern.substr(start, i - start), result);
+        if (i < pattern.size() && !(pattern[i] == '*' && !result.empty() && result.back() == '*'))
+        {
+            result += pattern[i];
+        }
+        start = i + 1;
+    }
+    return result;
+}
+
+WildcardAutomaton::WildcardAutomaton(std::string_view pattern)
+{
+    for (const char c : pattern)
+    {
+        if (c == '*')
+        {
+            _elements.push_back({ Element::Kind::AnyString });
+        }
+        else if (c == '?')
+        {
+            _elements.push_back({ Element::Kind::AnyChar });
+        }
+        else
+        {
+            _elements.push_back({ Element::Kind::Byte, static_cast<uint8_t>(c) });
+        }
+    }
+    std::vector<uint32_t> start;
+    AddClosure(start, 0, 0);
+    _start = Intern(std::move(start));
+}
+
+// Состояние недетерминированного автомата - позиция в шаблоне и количество байтов текущего
+// символа UTF-8, которые осталось прочитать для "?". "*" может совпасть с пустой строкой,
+// поэтому вместе с ним добавляется и следующая позиция
+void WildcardAutomaton::AddClosure(std::vector<uint32_t>& states, size_t element, uint32_t pending) const
+{
+    states.push_back(static_cast<uint32_t>(element * 4 + pending));
+    if (pending == 0 && element < _elements.size() && _elements[element].kind == Element::Kind::AnyString)
+    {
+        AddClosure(states, element + 1, 0);
+    }
+}
+
+int WildcardAutomaton::Intern(std::vector<uint32_t> states)
+{
+    if (states.empty())
+    {
+        return -1;
+    }
+    std::sort(states.begin(), states.end());
+    states.erase(std::unique(states.begin(), states.end()), states.end());
+    if (auto it = _ids.find(states); it != _ids.end())
+    {
+        return it->second;
+    }
+    const int id = static_cast<int>(_states.size());
+    const auto match = static_cast<uint32_t>(_elements.size() * 4);
+    _matches.push_back(std::binary_search(states.begin(), states.end(), match));
+    _ids.emplace(states, id);
+    _states.push_back(std::move(states));
+    _transitions.emplace_back();
+    _transitions.back().fill(-2);
+    return id;
+}
+
+int WildcardAutomaton::Step(int state, uint8_t byte)
+{
+    if (const int cached = _transitions[state][byte]; cached != -2)
+    {
+        return cached;
+    }
+    const bool continuation = (byte & 0xC0) == 0x80;
+    std::vector<uint32_t> next;
+    for (const uint32_t code : _states[state])
+    {
+        const size_t element = code / 4;
+        const uint32_t pending = code % 4;
+        if (element == _elements.size())
+        {
+            continue; // Шаблон уже прочитан целиком
+        }
+        if (pending > 0)
+        {
+            // Продолжение символа, с которым совпал "?"
+            if (continuation)
+            {
+                AddClosure(next, pending == 1 ? element + 1 : element, pending - 1);
+            }
+            continue;
+        }
+        const Element& current = _elements[element];
+        switch (current.kind)
+        {
+        case Element::Kind::Byte:
+            if (byte == current.byte)
+            {
+                AddClosure(next, element + 1, 0);
+            }
+            break;
+        case Element::Kind::AnyString:
+            AddClosure(next, element, 0);
+            break;
+        case Element::Kind::AnyChar:
+            // Первый байт символа определяет длину его последовательности
+            if (byte < 0x80)
+            {
+                AddClosure(next, element + 1, 0);
+            }
+            else if ((byte & 0xE0) == 0xC0)
+            {
+                AddClosure(next, element, 1);
+            }
+            else if ((byte & 0xF0) == 0xE0)
+            {
+                AddClosure(next, element, 2);
+            }
+            else if ((byte & 0xF8) == 0xF0)
+            {
+                AddClosure(next, element, 3);
+            }
+            break;
+        }
+    }
+    const int id = Intern(std::move(next));
+    _transitions[state][byte] = id;
+    return id;
+}
+
+// Раскрывает шаблон в слова словаря
+std::vector<std::string> ExpandWildcard(const InvertedIndex& index, const std::string& pattern, size_t limit)
+{
+    const TermDictionary& dictionary = index.GetTermDictionary();
+    std::vector<uint32_t> ids;
+    const size_t first_wildcard = pattern.find_first_of("*?");
+    if (first_wildcard + 1 == pattern.size() && pattern.back() == '*')
+    {
+        // "префикс*" - слова с подряд идущими номерами, автомат не нужен
+        const auto [first, last] = dictionary.PrefixRange(std::string_view(pattern).substr(0, first_wildcard));
+        ids.reserve(last - first);
+        for (uint32_t id = first; id < last; ++id)
+        {
+            ids.push_back(id);
+        }
+    }
+    else
+    {
+        WildcardAutomaton automaton(pattern);
+        dictionary.Intersect(automaton, [&ids](const std::string&, uint32_t id)
+        {
+            ids.push_back(id);
+            return true;
+        });
+    }
+    if (ids.size() > limit)
+    {
+        // Оставляем самые частые слова, при равной частоте - меньшие по порядку
+        std::nth_element(ids.begin(), ids.begin() + static_cast<std::ptrdiff_t>(limit), ids.end(),
+                         [&index](uint32_t a, uint32_t b)
+        {
+            const size_t a_size = index.GetPostings(a).entries.size();
+            const size_t b_size = index.GetPostings(b).entries.size();
+            return a_size != b_size ? a_size > b_size : a < b;
+        });
+        ids.resize(limit);
+        std::sort(ids.begin(), ids.end());
+    }
+    std::vector<std::string> terms;
+    terms.reserve(ids.size());
+    for (const uint32_t id : ids)
+    {
+        terms.push_back(dictionary.Term(id));
+    }
+    return terms;
+}
@@ -1,30 +1,9 @@
 #include <iostream>
 #include <vector>
-#include <utility> // для std::pair
 #include "ConverterJSON.h"
 #include "SearchServer.h"
 #include "InvertedIndex.h"
-
-// Вспомогательная функция для преоброзования рузультатов поиска
-static std::vector<std::vector<std::pair<int, float>>>
-ConvertResults(const std::vector<std::vector<RelativeIndex>>& searchResults)
-{
-    std::vector<std::vector<std::pair<int, float>>> converted;
-    converted.reserve(searchResults.size());
-
-    for (const auto& result : searchResults)
-    {
-        std::vector<std::pair<int, float>> convertedResult;
-        convertedResult.reserve(result.size());
-
-        for (const auto& index : result)
-        {
-            convertedResult.emplace_back(index.doc_id, index.rank);
-        }
-        converted.push_back(std::move(convertedResult));
-    }
-    return converted;
-}
+#include "QueryProfile.h"
 
 int main()
 {
@@ -39,6 +18,17 @@ int main()
             std::cerr << "Config files are missing or invalid. Please check config.json and requests.json" << std::endl;
             return 1;
         }
+        // Отчеты о ходе чтения документов и построения индекса
+        const IndexOptions indexOptions = converter.GetIndexOptions();
+        if (indexOptions.progress_interval > 0)
+        {
+            converter.SetProgressObserver([](const IndexingMetrics& metrics)
+            {
+                std::cout << (metrics.finished ? "Documents read: " : "Reading documents: ")
+                          << FormatIndexingMetrics(metrics) << std::endl;
+            }, indexOptions.progress_interval);
+        }
+
         // Получаем список документов из config.json
         std::vector<std::string> documents = converter.GetTextDocuments();
 
@@ -50,10 +40,25 @@ int main()
 
         // Создаем и запролняем инвертированный индекс
         InvertedIndex index;
+        index.SetOptions(indexOptions);
+        if (indexOptions.progress_interval > 0)
+        {
+            index.SetProgressObserver([](const IndexingMetrics& metrics)
+            {
+                std::cout << (metrics.finished ? "Index built: " : "Indexing: ")
+                          << FormatIndexingMetrics(metrics) << std::endl;
+            }, indexOptions.progress_interval);
+        }
         index.UpdateDocumentBase(documents);
 
         // Инициализация поискового сервера
         SearchServer searchServer(index);
+        const SearchOptions searchOptions = converter.GetSearchOptions();
+        searchServer.SetOptions(searchOptions);
+        if (!searchOptions.profile_file.empty())
+        {
+            WriteQueryProfileAtExit(searchOptions.profile_file);
+        }
 
         // Получаем список запросов из requests.json
         std::vector<std::string> requests = converter.GetRequests();
@@ -62,13 +67,9 @@ int main()
             std::cerr << "No requests found in requests.json" << std::endl;
         }
 
-        // Обработка поисковых запросов
-        std::vector<std::vector<RelativeIndex>> results = searchServer.search(requests);
-
-        auto convertedResults = ConvertResults(results);
-
-        // Сохранение результатов
-        converter.putAnswers(convertedResults);
+        // Обработка поисковых запросов: search сам записывает в answers.json ответы
+        // и подсказки для запросов без результатов
+        searchServer.search(requests);
 
         std::cout << "Search completed successfully. Results saved to answers.json" << std::endl;
 
@@ -0,0 +1,84 @@
+#include <algorithm>
+#include <random>
+#include <vector>
+#include <string>
+#include <gtest/gtest.h>
+#include "Autocomplete.h"
+#include "InvertedIndex.h"
+
+TEST(TestCaseAutocomplete, TestIndexCompletions)
+{
+const std::vector<std::string> docs =
+    {
+        "moscow is the capital of russia",
+        "moscow street, moscow region",
+        "most people live in cities",
+        "mostly sunny in moscow and mosul"
+    };
+InvertedIndex idx;
+idx.UpdateDocumentBase(docs);
+Autocompleter completer;
+completer.Build(idx);
+ASSERT_EQ(completer.Size(), idx.GetTermDictionary().Size());
+// Вес - количество документов, при равном весе варианты идут по алфавиту
+ASSERT_EQ(completer.Complete("Mos", 3),
+          (std::vector<Completion>{ { "moscow", 3 }, { "most", 1 }, { "mostly", 1 } }));
+ASSERT_EQ(completer.Complete("mos", 10).size(), 4);
+ASSERT_EQ(completer.Complete("in", 1), (std::vector<Completion>{ { "in", 2 } }));
+ASSERT_TRUE(completer.Complete("xyz", 5).empty());
+ASSERT_TRUE(completer.Complete("mos", 0).empty());
+}
+
+TEST(TestCaseAutocomplete, TestQueryLogCompletions)
+{
+Autocompleter completer;
+completer.Build({ { "New York", 5 }, { "new  york", 2 }, { "newton", 4 }, { "new jersey", 6 }, { "news", 1 }, { "!!!", 9 } });
+ASSERT_EQ(completer.Size(), 4);
+// Одинаковые после нормализации запросы складываются
+ASSERT_EQ(completer.Complete("new", 2), (std::vector<Completion>{ { "new york", 7 }, { "new jersey", 6 } }));
+// После пробела дополняется следующее слово
+ASSERT_EQ(completer.Complete("NEW ", 5), (std::vector<Completion>{ { "new york", 7 }, { "new jersey", 6 } }));
+ASSERT_EQ(completer.Complete("new y", 5), (std::vector<Completion>{ { "new york", 7 } }));
+ASSERT_EQ(NormalizeCompletion("  Hello,   World! "), "hello world ");
+
+// K лучших совпадают с сортировкой всех вариантов префикса
+std::mt19937 rng(3);
+std::vector<std::pair<std::string, uint64_t>> queries;
+for (size_t i = 0; i < 5000; ++i)
+{
+    std::string query;
+    const size_t length = 1 + rng() % 6;
+    for (size_t j = 0; j < length; ++j)
+    {
+        query += static_cast<char>('a' + rng() % 4);
+    }
+    queries.emplace_back(query, rng() % 50);
+}
+completer.Build(queries);
+for (const std::string prefix : { "", "a", "bc", "dda", "abcd" })
+{
+    std::vector<Completion> expected;
+    for (const auto& [query, weight] : queries)
+    {
+        if (query.compare(0, prefix.size(), prefix) != 0)
+        {
+            continue;
+        }
+        auto it = std::find_if(expected.begin(), expected.end(), [&](const Completion& c) { return c.text == query; });
+        if (it == expected.end())
+        {
+            expected.push_back({ query, weight });
+        }
+        else
+        {
+            it->weight += weight;
+        }
+    }
+    std::sort(expected.begin(), expected.end(), [](const Completion& a, const Completion& b)
+    {
+        return a.weight != b.weight ? a.weight > b.weight : a.text < b.text;
+    });
+    expected.resize(std::min<size_t>(expected.size(), 10));
+    ASSERT_EQ(completer.Complete(prefix, 10), expected) << prefix;
+}
+}
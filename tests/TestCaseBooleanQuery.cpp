@@ -0,0 +1,191 @@
+#include <vector>
+#include <string>
+#include <gtest/gtest.h>
+#include "BooleanQuery.h"
+#include "InvertedIndex.h"
+#include "SearchServer.h"
+
+// Выполняет запросы в логическом синтаксисе и возвращает найденные doc_id без учета ранга
+static std::vector<std::vector<size_t>> SearchBoolean(const std::vector<std::string>& docs,
+                                                      const std::vector<std::string>& queries,
+                                                      bool positions = false)
+{
+    InvertedIndex idx;
+    IndexOptions index_options;
+    index_options.positions = positions;
+    idx.SetOptions(index_options);
+    idx.UpdateDocumentBase(docs);
+    SearchServer srv(idx);
+    SearchOptions options;
+    options.syntax = QuerySyntax::Boolean;
+    srv.SetOptions(options);
+
+    std::vector<std::vector<size_t>> result;
+    for (const auto& query : queries)
+    {
+        std::vector<size_t> doc_ids;
+        for (const auto& index : srv.search(srv.Compile(query), docs.size()))
+        {
+            doc_ids.push_back(index.doc_id);
+        }
+        std::sort(doc_ids.begin(), doc_ids.end());
+        result.push_back(doc_ids);
+    }
+    return result;
+}
+
+TEST(TestCaseBooleanQuery, TestParseTree)
+{
+InvertedIndex idx;
+idx.UpdateDocumentBase({ "a" });
+const CompiledQuery query = CompileQuery("Moscow AND (capital OR city) -Kiev \"third rome\"",
+                                         idx, QuerySyntax::Boolean, QueryMode::Any);
+ASSERT_NE(query.root, nullptr);
+const QueryNode& root = *query.root;
+ASSERT_EQ(root.type, QueryNode::Type::Boolean);
+ASSERT_EQ(root.must.size(), 2);
+ASSERT_EQ(root.must[0]->terms, std::vector<std::string>{ "moscow" });
+ASSERT_EQ(root.must[1]->type, QueryNode::Type::Boolean);
+// Второй операнд AND - последовательность: группа OR раскрывается в ней, -kiev становится исключением
+ASSERT_EQ(root.must[1]->should.size(), 3);
+ASSERT_EQ(root.must[1]->must_not.size(), 1);
+ASSERT_EQ(root.must[1]->must_not[0]->terms, std::vector<std::string>{ "kiev" });
+ASSERT_EQ(root.must[1]->should[2]->type, QueryNode::Type::Phrase);
+ASSERT_EQ(root.must[1]->should[2]->terms, (std::vector<std::string>{ "third", "rome" }));
+}
+
+TEST(TestCaseBooleanQuery, TestOperators)
+{
+const std::vector<std::string> docs =
+    {
+        "london is the capital of great britain",
+        "moscow is the capital of russia",
+        "welcome to moscow the capital of russia the third rome",
+        "rome is the capital of italy",
+        "kiev is the capital of ukraine"
+    };
+const std::vector<std::string> queries =
+    {
+        "moscow AND rome",
+        "moscow OR rome",
+        "capital -russia -italy",
+        "+capital russia",
+        "capital AND NOT (moscow OR london)",
+        "(rome OR london) AND NOT italy",
+        "NOT capital",
+        "\"third rome\"",
+        "moscow OR NOT rome",
+        "capital AND (rome OR NOT italy)"
+    };
+const std::vector<std::vector<size_t>> expected =
+    {
+        { 2 },
+        { 1, 2, 3 },
+        { 0, 4 },
+        { 0, 1, 2, 3, 4 },
+        { 3, 4 },
+        { 0, 2 },
+        { },
+        { 2 },
+        { 1, 2 },
+        { 2, 3 }
+    };
+ASSERT_EQ(SearchBoolean(docs, queries), expected);
+}
+
+TEST(TestCaseBooleanQuery, TestPhraseAndNear)
+{
+InvertedIndex idx;
+idx.UpdateDocumentBase({ "a" });
+const CompiledQuery query = CompileQuery("rome NEAR/3 third", idx, QuerySyntax::Boolean, QueryMode::Any);
+ASSERT_NE(query.root, nullptr);
+ASSERT_EQ(query.root->should.size(), 1);
+ASSERT_EQ(query.root->should[0]->type, QueryNode::Type::Near);
+ASSERT_EQ(query.root->should[0]->distance, 3);
+ASSERT_EQ(query.root->should[0]->terms, (std::vector<std::string>{ "rome", "third" }));
+// Расстояние, не помещающееся в size_t, ограничивается, а не обрывает разбор
+const CompiledQuery far = CompileQuery("rome NEAR/99999999999999999999999 third", idx, QuerySyntax::Boolean, QueryMode::Any);
+ASSERT_NE(far.root, nullptr);
+ASSERT_EQ(far.root->should[0]->type, QueryNode::Type::Near);
+ASSERT_EQ(far.root->should[0]->distance, UINT32_MAX);
+
+const std::vector<std::string> docs =
+    {
+        "welcome to moscow the capital of russia the third rome",
+        "rome is the third city",
+        "the third way to rome",
+        "rome rome rome"
+    };
+const std::vector<std::string> queries =
+    {
+        "\"third rome\"",
+        "rome NEAR/1 third",
+        "rome NEAR/3 third",
+        "rome NEAR/2 third",
+        "rome NEAR rome",
+        "\"the third\" AND NOT welcome",
+        "moscow NEAR/1 capital NEAR/2 russia",
+        "rome NEAR/99999999999999999999999 third"
+    };
+const std::vector<std::vector<size_t>> expected =
+    {
+        { 0 },
+        { 0 },
+        { 0, 1, 2 },
+        { 0 },
+        { 3 },
+        { 1, 2 },
+        { },
+        { 0, 1, 2 }
+    };
+ASSERT_EQ(SearchBoolean(docs, queries, true), expected);
+// Без позиций фраза находит документы, содержащие все ее слова
+ASSERT_EQ(SearchBoolean(docs, { "\"third rome\"" }), (std::vector<std::vector<size_t>>{ { 0, 1, 2 } }));
+}
+
+TEST(TestCaseBooleanQuery, TestStopwords)
+{
+const std::vector<std::string> docs =
+    {
+        "moscow is the capital of russia",
+        "capital is moscow",
+        "the capital of great britain"
+    };
+for (bool side_index : { false, true })
+{
+    InvertedIndex idx;
+    IndexOptions index_options;
+    index_options.positions = true;
+    index_options.stopwords = GetBuiltinStopwords("english");
+    index_options.stopwords_in_positions = side_index;
+    idx.SetOptions(index_options);
+    idx.UpdateDocumentBase(docs);
+    ASSERT_TRUE(idx.GetWordCount("the").empty());
+    ASSERT_TRUE(idx.FindPostings("is").entries.empty());
+
+    SearchServer srv(idx);
+    SearchOptions options;
+    options.syntax = QuerySyntax::Boolean;
+    options.mode = QueryMode::All;
+    srv.SetOptions(options);
+    const auto found = [&](const std::string& query)
+    {
+        std::vector<size_t> doc_ids;
+        for (const auto& index : srv.search(srv.Compile(query), docs.size()))
+        {
+            doc_ids.push_back(index.doc_id);
+        }
+        std::sort(doc_ids.begin(), doc_ids.end());
+        return doc_ids;
+    };
+    // Стоп-слова вне фраз не ищутся и не мешают режиму "все слова"
+    ASSERT_EQ(found("capital of russia"), std::vector<size_t>{ 0 });
+    ASSERT_EQ(found("the"), std::vector<size_t>{});
+    // Во фразах место стоп-слова учитывается в любом случае
+    ASSERT_EQ(found("\"capital of russia\""), std::vector<size_t>{ 0 });
+    ASSERT_EQ(found("\"capital russia\""), std::vector<size_t>{});
+    // С дополнительным позиционным индексом проверяются и сами стоп-слова
+    ASSERT_EQ(found("\"capital is moscow\""), std::vector<size_t>{ 1 });
+    ASSERT_EQ(found("\"capital the moscow\""), side_index ? std::vector<size_t>{} : std::vector<size_t>{ 1 });
+}
+}
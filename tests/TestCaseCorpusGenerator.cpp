@@ -0,0 +1,131 @@
+#include <algorithm>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include "CorpusGenerator.h"
+#include "InvertedIndex.h"
+
+namespace
+{
+    std::vector<std::string> SplitWords(const std::string& text)
+    {
+        std::vector<std::string> words;
+        std::istringstream stream(text);
+        std::string word;
+        while (stream >> word)
+        {
+            words.push_back(word);
+        }
+        return words;
+    }
+}
+
+TEST(TestCaseCorpusGenerator, TestPseudoWords)
+{
+ASSERT_EQ(MakePseudoWord(0), "da");
+ASSERT_EQ(MakePseudoWord(63), "yo");
+ASSERT_EQ(MakePseudoWord(64), "dada");
+// Разные номера - разные слова, и нормализатор их не меняет
+std::set<std::string> words;
+for (size_t number = 0; number < 10000; ++number)
+{
+    words.insert(MakePseudoWord(number));
+}
+ASSERT_EQ(words.size(), 10000);
+InvertedIndex idx;
+idx.UpdateDocumentBase({ MakePseudoWord(5000) });
+ASSERT_EQ(idx.GetWordCount(MakePseudoWord(5000)).size(), 1);
+}
+
+TEST(TestCaseCorpusGenerator, TestDeterministicCorpus)
+{
+CorpusOptions options;
+options.documents = 50;
+options.vocabulary = 1000;
+options.mean_length = 40;
+const auto docs = CorpusGenerator(options).Documents();
+ASSERT_EQ(docs.size(), 50);
+// То же зерно - тот же корпус, документ не зависит от остальных
+ASSERT_EQ(CorpusGenerator(options).Documents(), docs);
+ASSERT_EQ(CorpusGenerator(options).Document(17), docs[17]);
+options.seed = 7;
+ASSERT_NE(CorpusGenerator(options).Documents(), docs);
+}
+
+TEST(TestCaseCorpusGenerator, TestZipfAndLengths)
+{
+CorpusOptions options;
+options.documents = 200;
+options.vocabulary = 5000;
+options.mean_length = 100;
+const CorpusGenerator generator(options);
+const auto docs = generator.Documents();
+InvertedIndex idx;
+idx.UpdateDocumentBase(docs);
+// Средняя длина документа близка к заданной, длины различаются
+const IndexStats stats = idx.GetIndexStats();
+ASSERT_NEAR(stats.average_length, 100.0, 15.0);
+ASSERT_NE(idx.GetDocumentLength(0), idx.GetDocumentLength(1));
+// По закону Ципфа с s = 1 слово ранга 0 встречается примерно вдвое чаще слова ранга 1
+// и в 10 раз чаще слова ранга 9
+const double first = static_cast<double>(idx.GetTermStats(generator.Term(0)).collection_freq);
+const double second = static_cast<double>(idx.GetTermStats(generator.Term(1)).collection_freq);
+const double tenth = static_cast<double>(idx.GetTermStats(generator.Term(9)).collection_freq);
+ASSERT_NEAR(first / second, 2.0, 0.3);
+ASSERT_NEAR(first / tenth, 10.0, 2.0);
+
+options.length_distribution = LengthDistribution::Fixed;
+for (const auto& doc : CorpusGenerator(options).Documents())
+{
+    ASSERT_EQ(SplitWords(doc).size(), 100);
+}
+}
+
+TEST(TestCaseCorpusGenerator, TestQueryClasses)
+{
+CorpusOptions options;
+options.vocabulary = 20000;
+const CorpusGenerator generator(options);
+std::set<std::string> tail;
+for (size_t rank = 10000; rank < 20000; ++rank)
+{
+    tail.insert(generator.Term(rank));
+}
+WorkloadOptions workload;
+workload.queries = 300;
+workload.min_terms = 2;
+workload.max_terms = 3;
+const auto queries = generator.Queries(workload);
+ASSERT_EQ(queries.size(), 300);
+ASSERT_EQ(generator.Queries(workload), queries);
+for (const auto& query : queries)
+{
+    const auto words = SplitWords(query);
+    ASSERT_GE(words.size(), 2);
+    ASSERT_LE(words.size(), 3);
+}
+
+// Только редкие слова
+workload.head_share = 0;
+workload.torso_share = 0;
+workload.tail_share = 1;
+for (const auto& query : generator.Queries(workload))
+{
+    for (const auto& word : SplitWords(query))
+    {
+        ASSERT_TRUE(tail.count(word)) << word;
+    }
+}
+
+// Один класс на запрос: слова запроса либо все частые, либо все редкие
+workload.head_share = 1;
+workload.mixed = false;
+for (const auto& query : generator.Queries(workload))
+{
+    const auto words = SplitWords(query);
+    const size_t tail_words = std::count_if(words.begin(), words.end(), [&](const std::string& w) { return tail.count(w) > 0; });
+    ASSERT_TRUE(tail_words == 0 || tail_words == words.size()) << query;
+}
+}
@@ -0,0 +1,131 @@
+#include <algorithm>
+#include <random>
+#include <set>
+#include <vector>
+#include <string>
+#include <gtest/gtest.h>
+#include "FuzzyTerm.h"
+#include "InvertedIndex.h"
+#include "SearchServer.h"
+
+TEST(TestCaseFuzzyTerm, TestEditDistance)
+{
+ASSERT_EQ(EditDistance("moscow", "moscow"), 0);
+ASSERT_EQ(EditDistance("moscow", "moskow"), 1);
+ASSERT_EQ(EditDistance("moscow", "mocsow"), 1); // Перестановка соседних символов
+ASSERT_EQ(EditDistance("moscow", "mosc"), 2);
+ASSERT_EQ(EditDistance("", "ab"), 2);
+// Расстояние считается в символах, а не в байтах
+ASSERT_EQ(EditDistance("москва", "масква"), 1);
+ASSERT_EQ(EditDistance("москва", "мсоква"), 1);
+
+std::string base;
+size_t distance = 0;
+ASSERT_TRUE(ParseFuzzyTerm("moscow~1", base, distance));
+ASSERT_EQ(base, "moscow");
+ASSERT_EQ(distance, 1);
+ASSERT_TRUE(ParseFuzzyTerm("moscow~", base, distance));
+ASSERT_EQ(distance, 2);
+ASSERT_TRUE(ParseFuzzyTerm("moscow~7", base, distance));
+ASSERT_EQ(distance, MAX_FUZZY_DISTANCE);
+// Число, не помещающееся в size_t, ограничивается так же
+ASSERT_TRUE(ParseFuzzyTerm("moscow~99999999999999999999999", base, distance));
+ASSERT_EQ(base, "moscow");
+ASSERT_EQ(distance, MAX_FUZZY_DISTANCE);
+ASSERT_FALSE(ParseFuzzyTerm("moscow", base, distance));
+ASSERT_FALSE(ParseFuzzyTerm("~1", base, distance));
+ASSERT_FALSE(ParseFuzzyTerm("a~b", base, distance));
+}
+
+TEST(TestCaseFuzzyTerm, TestLevenshteinAutomaton)
+{
+// Пересечение словаря с автоматом должно совпадать с перебором всех слов
+const std::vector<std::string> alphabet = { "a", "b", "c", "д", "е" };
+std::mt19937 rng(7);
+std::set<std::string> unique;
+while (unique.size() < 2000)
+{
+    std::string word;
+    const size_t length = 1 + rng() % 6;
+    for (size_t i = 0; i < length; ++i)
+    {
+        word += alphabet[rng() % alphabet.size()];
+    }
+    unique.insert(word);
+}
+const std::vector<std::string> terms(unique.begin(), unique.end());
+TermDictionary dictionary;
+dictionary.Build(terms);
+for (const std::string query : { "abc", "дед", "a", "cabдe", "ebbac" })
+{
+    for (size_t distance = 0; distance <= MAX_FUZZY_DISTANCE; ++distance)
+    {
+        std::vector<std::string> expected;
+        for (const auto& term : terms)
+        {
+            if (EditDistance(query, term) <= distance)
+            {
+                expected.push_back(term);
+            }
+        }
+        std::vector<std::string> found;
+        LevenshteinAutomaton automaton(query, distance);
+        dictionary.Intersect(automaton, [&](const std::string& term, uint32_t id)
+        {
+            EXPECT_EQ(dictionary.Term(id), term);
+            found.push_back(term);
+            return true;
+        });
+        ASSERT_EQ(found, expected) << query << "~" << distance;
+    }
+}
+}
+
+TEST(TestCaseFuzzyTerm, TestFuzzySearch)
+{
+const std::vector<std::string> docs =
+    {
+        "moscow is the capital of russia",
+        "moskow street",
+        "mascow",
+        "rome is a city"
+    };
+InvertedIndex idx;
+idx.UpdateDocumentBase(docs);
+SearchServer srv(idx);
+SearchOptions options;
+options.scorer = ScorerType::TfIdf;
+srv.SetOptions(options);
+// Опечатка находит правильное слово
+auto result = srv.search(srv.Compile("moscoww~1"), docs.size());
+ASSERT_EQ(result.size(), 1);
+ASSERT_EQ(result[0].doc_id, 0);
+// Все три написания на расстоянии 1, точное совпадение ранжируется выше
+result = srv.search(srv.Compile("moscow~1"), docs.size());
+ASSERT_EQ(result.size(), 3);
+ASSERT_EQ(result[0].doc_id, 0);
+ASSERT_FLOAT_EQ(result[0].rank, 1.0f);
+ASSERT_FLOAT_EQ(result[1].rank, 0.5f);
+ASSERT_EQ(srv.search(srv.Compile("moscow~"), docs.size()).size(), 3);
+ASSERT_EQ(srv.search(srv.Compile("roma~1 street"), docs.size()).size(), 2);
+ASSERT_EQ(srv.search(srv.Compile("moscow~99999999999999999999999"), docs.size()).size(), 3);
+// Нечеткие слова подсказка не исправляет
+ASSERT_EQ(srv.Suggest("moscoww~99999999999999999999999"), "");
+
+// Множитель правок учитывается и функцией ранжирования по умолчанию (количество вхождений):
+// точное совпадение выше опечатки
+options.scorer = ScorerType::TermCount;
+srv.SetOptions(options);
+result = srv.search(srv.Compile("moscow~1"), docs.size());
+ASSERT_EQ(result.size(), 3);
+ASSERT_EQ(result[0].doc_id, 0);
+ASSERT_FLOAT_EQ(result[0].rank, 1.0f);
+ASSERT_FLOAT_EQ(result[1].rank, 0.5f);
+ASSERT_FLOAT_EQ(result[2].rank, 0.5f);
+
+// Без нечеткого поиска "~" отбрасывается как знак препинания
+options.fuzzy_limit = 0;
+srv.SetOptions(options);
+result = srv.search(srv.Compile("moscow~1"), docs.size());
+ASSERT_TRUE(result.empty());
+}
@@ -87,3 +87,83 @@ const std::vector<std::vector<Entry>> expected =
 TestInvertedIndexFunctionality(docs, requests, expected);
 }
 
+
+TEST(TestCaseInvertedIndex, TestStatistics)
+{
+const std::vector<std::string> docs =
+    {
+        "milk milk sugar",
+        "Milk water of the sea",
+        "",
+        "water water water water"
+    };
+InvertedIndex idx;
+IndexOptions options;
+options.positions = true;
+options.stopwords = { "of", "the" };
+idx.SetOptions(options);
+idx.UpdateDocumentBase(docs);
+
+const TermStats milk = idx.GetTermStats("milk");
+ASSERT_EQ(milk.doc_freq, 2);
+ASSERT_EQ(milk.collection_freq, 3);
+ASSERT_GT(milk.posting_bytes, 0);
+ASSERT_EQ(idx.GetTermStats("water").collection_freq, 5);
+ASSERT_EQ(idx.GetTermStats("of").doc_freq, 0);
+ASSERT_EQ(idx.GetTermStats("bread").posting_bytes, 0);
+
+// Стоп-слова входят в длину документа
+ASSERT_EQ(idx.GetDocumentLength(0), 3);
+ASSERT_EQ(idx.GetDocumentLength(1), 5);
+ASSERT_EQ(idx.GetDocumentLength(2), 0);
+ASSERT_DOUBLE_EQ(idx.GetAverageDocumentLength(), 3.0);
+ASSERT_EQ(idx.GetVocabularySize(), 4);
+
+const IndexStats stats = idx.GetIndexStats();
+ASSERT_EQ(stats.documents, 4);
+ASSERT_EQ(stats.vocabulary, 4);
+ASSERT_EQ(stats.tokens, 12);
+ASSERT_GT(stats.dictionary_bytes, 0);
+ASSERT_GE(stats.posting_bytes, 6 * sizeof(Entry));
+ASSERT_GT(stats.position_bytes, 0);
+ASSERT_EQ(stats.substring_bytes, 0);
+}
+
+TEST(TestCaseInvertedIndex, TestIndexingMetrics)
+{
+const std::vector<std::string> docs =
+    {
+        "milk milk sugar",
+        "Milk water of the sea",
+        "",
+        "water water water water"
+    };
+InvertedIndex idx;
+std::vector<IndexingMetrics> reports;
+// Нулевой интервал - отчет после каждого непустого документа и итоговый
+idx.SetProgressObserver([&](const IndexingMetrics& metrics) { reports.push_back(metrics); }, 0);
+idx.UpdateDocumentBase(docs);
+
+ASSERT_EQ(reports.size(), 4);
+ASSERT_EQ(reports.front().documents, 1);
+ASSERT_EQ(reports.front().tokens, 3);
+ASSERT_FALSE(reports.front().finished);
+const IndexingMetrics& metrics = idx.GetIndexingMetrics();
+ASSERT_TRUE(metrics.finished);
+ASSERT_TRUE(reports.back().finished);
+ASSERT_EQ(metrics.documents, 4);
+ASSERT_EQ(metrics.bytes, 15 + 21 + 23);
+ASSERT_EQ(metrics.tokens, 12);
+ASSERT_EQ(metrics.unique_terms, 6);
+const IndexStats stats = idx.GetIndexStats();
+ASSERT_EQ(metrics.posting_bytes, stats.posting_bytes + stats.position_bytes);
+ASSERT_GE(metrics.seconds, metrics.tokenize_seconds + metrics.dictionary_seconds + metrics.postings_seconds);
+ASSERT_FALSE(FormatIndexingMetrics(metrics).empty());
+
+// Без наблюдателя показатели тоже собираются
+idx.SetProgressObserver(nullptr);
+idx.UpdateDocumentBase({ "one two" });
+ASSERT_EQ(reports.size(), 4);
+ASSERT_EQ(idx.GetIndexingMetrics().tokens, 2);
+ASSERT_EQ(idx.GetIndexingMetrics().documents, 1);
+}
@@ -0,0 +1,141 @@
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include "InvertedIndex.h"
+#include "PostingIterator.h"
+#include "QueryEvaluator.h"
+#include "Scorers.h"
+#include "SearchOptions.h"
+
+// Случайный корпус из слов "w0".."w<vocabulary-1>", частые слова встречаются чаще
+static std::vector<std::string> MakeRandomDocs(size_t num_docs, size_t vocabulary, uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::vector<std::string> docs(num_docs);
+    for (auto& doc : docs)
+    {
+        const size_t length = 1 + rng() % 40;
+        for (size_t i = 0; i < length; ++i)
+        {
+            doc += "w" + std::to_string(rng() % (1 + rng() % vocabulary)) + " ";
+        }
+    }
+    return docs;
+}
+
+template <typename Scorer>
+static std::vector<RelativeIndex> EvaluateTerms(const InvertedIndex& idx, const std::vector<std::string>& terms,
+                                                size_t limit, EvaluationStrategy strategy)
+{
+    if (strategy == EvaluationStrategy::BlockMaxWand)
+    {
+        auto iterators = MakeIterators<BlockPostingIterator>(idx, terms);
+        return EvaluateBlockMaxWand(iterators, Scorer{}, idx.GetTotalDocuments(), limit);
+    }
+    auto iterators = MakeIterators<EntryPostingIterator>(idx, terms);
+    if (strategy == EvaluationStrategy::MaxScore)
+    {
+        return EvaluateMaxScore(iterators, Scorer{}, idx.GetTotalDocuments(), limit);
+    }
+    return EvaluateExhaustive(iterators, Scorer{}, idx.GetTotalDocuments(), limit);
+}
+
+TEST(TestCaseQueryEvaluator, TestAdvance)
+{
+InvertedIndex idx;
+idx.UpdateDocumentBase({ "a", "b", "a", "a", "b", "b", "a" });
+EntryPostingIterator it(idx.FindPostings("a"));
+it.Advance(1);
+ASSERT_EQ(it.Doc(), 2);
+it.Advance(2);
+ASSERT_EQ(it.Doc(), 2);
+it.Advance(4);
+ASSERT_EQ(it.Doc(), 6);
+it.Advance(7);
+ASSERT_TRUE(it.AtEnd());
+ASSERT_EQ(it.Doc(), END_DOC);
+}
+
+TEST(TestCaseQueryEvaluator, TestBlockAdvance)
+{
+std::vector<std::string> docs(1000, "b");
+for (size_t doc_id = 0; doc_id < docs.size(); doc_id += 3)
+{
+    docs[doc_id] = "a";
+}
+InvertedIndex idx;
+idx.UpdateDocumentBase(docs);
+BlockPostingIterator it(idx.FindPostings("a"));
+it.ShallowAdvance(500);
+ASSERT_EQ(it.Doc(), 0); // Поверхностный переход не меняет текущий документ
+ASSERT_EQ(it.BlockLastDoc(), 3 * (3 * POSTING_BLOCK_SIZE - 1)); // 500 лежит в третьем блоке
+it.Advance(500);
+ASSERT_EQ(it.Doc(), 501);
+ASSERT_EQ(it.Decoded(), 2);
+}
+
+TEST(TestCaseQueryEvaluator, TestPruningMatchesExhaustive)
+{
+InvertedIndex idx;
+idx.UpdateDocumentBase(MakeRandomDocs(2000, 30, 1));
+std::mt19937 rng(2);
+for (size_t query = 0; query < 200; ++query)
+{
+    std::vector<std::string> terms;
+    const size_t length = 1 + rng() % 8;
+    for (size_t i = 0; i < length; ++i)
+    {
+        terms.push_back("w" + std::to_string(rng() % 30));
+    }
+    std::sort(terms.begin(), terms.end());
+    terms.erase(std::unique(terms.begin(), terms.end()), terms.end());
+    const size_t limit = 1 + rng() % 10;
+
+    const auto exhaustive = EvaluateTerms<TermCountScorer>(idx, terms, limit, EvaluationStrategy::Exhaustive);
+    ASSERT_EQ(exhaustive, EvaluateTerms<TermCountScorer>(idx, terms, limit, EvaluationStrategy::MaxScore));
+    ASSERT_EQ(exhaustive, EvaluateTerms<TermCountScorer>(idx, terms, limit, EvaluationStrategy::BlockMaxWand));
+}
+}
+
+TEST(TestCaseQueryEvaluator, TestConjunctiveMatchesBruteForce)
+{
+InvertedIndex idx;
+idx.UpdateDocumentBase(MakeRandomDocs(2000, 30, 3));
+std::mt19937 rng(4);
+for (size_t query = 0; query < 200; ++query)
+{
+    std::vector<std::string> terms;
+    const size_t length = 1 + rng() % 4;
+    for (size_t i = 0; i < length; ++i)
+    {
+        terms.push_back("w" + std::to_string(rng() % 30));
+    }
+    std::sort(terms.begin(), terms.end());
+    terms.erase(std::unique(terms.begin(), terms.end()), terms.end());
+    const size_t limit = 1 + rng() % 10;
+
+    // Эталон: сумма вхождений только для документов, в которых есть все слова
+    std::vector<size_t> relevance(idx.GetTotalDocuments(), 0);
+    std::vector<size_t> matched(idx.GetTotalDocuments(), 0);
+    for (const auto& term : terms)
+    {
+        for (const auto& entry : idx.FindPostings(term).entries)
+        {
+            relevance[entry.doc_id] += entry.count;
+            ++matched[entry.doc_id];
+        }
+    }
+    for (size_t doc_id = 0; doc_id < relevance.size(); ++doc_id)
+    {
+        if (matched[doc_id] != terms.size())
+        {
+            relevance[doc_id] = 0;
+        }
+    }
+    auto iterators = MakeIterators<EntryPostingIterator>(idx, terms);
+    ASSERT_EQ(RankDocuments(relevance, limit),
+              EvaluateConjunctive(iterators, TermCountScorer{}, idx.GetTotalDocuments(), limit));
+}
+}
@@ -0,0 +1,92 @@
+#include <thread>
+#include <vector>
+#include <string>
+#include <gtest/gtest.h>
+#include <nlohmann/json.hpp>
+#include "InvertedIndex.h"
+#include "QueryProfile.h"
+#include "SearchServer.h"
+
+TEST(TestCaseQueryProfile, TestHistogramBuckets)
+{
+// Малые значения хранятся точно, у больших корзина не шире 1/64 значения
+for (uint64_t value : { 0ull, 1ull, 127ull })
+{
+    ASSERT_EQ(LatencyHistogram::BucketValue(LatencyHistogram::BucketIndex(value)), value);
+}
+for (uint64_t value = 128; value < (1ull << 36); value = value * 3 / 2 + 1)
+{
+    const uint64_t upper = LatencyHistogram::BucketValue(LatencyHistogram::BucketIndex(value));
+    ASSERT_GE(upper, value);
+    ASSERT_LE(upper - value, value / 64);
+}
+ASSERT_EQ(LatencyHistogram::BucketIndex(LatencyHistogram::MAX_VALUE), LatencyHistogram::BUCKETS - 1);
+ASSERT_EQ(LatencyHistogram::BucketIndex(UINT64_MAX), LatencyHistogram::BUCKETS - 1);
+}
+
+TEST(TestCaseQueryProfile, TestHistogramPercentiles)
+{
+LatencyHistogram histogram;
+ASSERT_EQ(histogram.Percentile(0.5), 0);
+for (uint64_t value = 1; value <= 10000; ++value)
+{
+    histogram.Record(value * 1000);
+}
+ASSERT_EQ(histogram.Count(), 10000);
+ASSERT_EQ(histogram.Min(), 1000);
+ASSERT_EQ(histogram.Max(), 10000000);
+ASSERT_DOUBLE_EQ(histogram.Mean(), 5000500.0);
+ASSERT_NEAR(static_cast<double>(histogram.Percentile(0.5)), 5000000.0, 5000000.0 / 64);
+ASSERT_NEAR(static_cast<double>(histogram.Percentile(0.99)), 9900000.0, 9900000.0 / 64);
+ASSERT_EQ(histogram.Percentile(1.0), 10000000);
+
+LatencyHistogram other;
+other.Record(20000000);
+histogram.Add(other);
+ASSERT_EQ(histogram.Count(), 10001);
+ASSERT_EQ(histogram.Max(), 20000000);
+const auto json = histogram.ToJson();
+ASSERT_EQ(json["count"], 10001);
+ASSERT_EQ(json["max_ns"], 20000000);
+histogram.Clear();
+ASSERT_EQ(histogram.Count(), 0);
+ASSERT_EQ(histogram.Min(), 0);
+}
+
+TEST(TestCaseQueryProfile, TestSearchPhases)
+{
+if (!QUERY_PROFILING_ENABLED)
+{
+    GTEST_SKIP() << "built without SEARCH_ENGINE_PROFILING";
+}
+InvertedIndex idx;
+idx.UpdateDocumentBase({ "milk water", "milk sugar", "water" });
+SearchServer srv(idx);
+SearchOptions options;
+options.cache_capacity = 0;
+srv.SetOptions(options);
+ResetQueryProfile();
+for (int i = 0; i < 10; ++i)
+{
+    srv.search(srv.Compile("milk water"), 5);
+}
+ASSERT_EQ(GetQueryPhaseHistogram(QueryPhase::Parse).Count(), 10);
+ASSERT_EQ(GetQueryPhaseHistogram(QueryPhase::Lookup).Count(), 10);
+ASSERT_EQ(GetQueryPhaseHistogram(QueryPhase::Evaluate).Count(), 10);
+ASSERT_EQ(GetQueryPhaseHistogram(QueryPhase::Rank).Count(), 10);
+ASSERT_EQ(GetQueryPhaseHistogram(QueryPhase::Query).Count(), 10);
+ASSERT_EQ(GetQueryPhaseHistogram(QueryPhase::Output).Count(), 0);
+// Время запроса целиком не меньше суммы его этапов
+ASSERT_GE(GetQueryPhaseHistogram(QueryPhase::Query).Mean(),
+          GetQueryPhaseHistogram(QueryPhase::Evaluate).Mean() + GetQueryPhaseHistogram(QueryPhase::Rank).Mean());
+
+// Гистограммы завершившихся потоков сохраняются
+std::thread worker([&] { srv.search(srv.Compile("sugar"), 5); });
+worker.join();
+ASSERT_EQ(GetQueryPhaseHistogram(QueryPhase::Query).Count(), 11);
+const auto profile = DumpQueryProfile();
+ASSERT_TRUE(profile["profiling"].get<bool>());
+ASSERT_EQ(profile["phases"]["query"]["count"], 11);
+ResetQueryProfile();
+ASSERT_EQ(GetQueryPhaseHistogram(QueryPhase::Query).Count(), 0);
+}
@@ -0,0 +1,105 @@
+#include <atomic>
+#include <chrono>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include <nlohmann/json.hpp>
+#include "InvertedIndex.h"
+#include "QueryReplay.h"
+#include "SearchServer.h"
+
+namespace
+{
+    // Получатель, который считает запросы и отвечает ошибкой на "fail"
+    class CountingTarget : public ReplayTarget
+    {
+    public:
+        size_t Search(const std::string& query, size_t limit) override
+        {
+            calls.fetch_add(1);
+            if (query == "fail")
+            {
+                throw std::runtime_error("failed");
+            }
+            return limit;
+        }
+
+        std::atomic<size_t> calls{ 0 };
+    };
+}
+
+TEST(TestCaseQueryReplay, TestReadQueryLog)
+{
+std::istringstream log(
+    "{\"ts\": 1700000002.5, \"query\": \"milk water\"}\n"
+    "\n"
+    "not json\n"
+    "{\"ts\": 1700000001, \"query\": \"sugar\"}\n"
+    "{\"timestamp\": 1700000004, \"query\": \"salt\"}\n"
+    "{\"ts\": 1700000005}\n"
+    "{\"query\": \"bread\"}\n");
+size_t skipped = 0;
+const auto queries = ReadQueryLog(log, &skipped);
+ASSERT_EQ(skipped, 2);
+ASSERT_EQ(queries.size(), 4);
+// Упорядочены по времени, время - от первого запроса; без времени - время предыдущего
+ASSERT_EQ(queries[0].query, "sugar");
+ASSERT_DOUBLE_EQ(queries[0].time, 0.0);
+ASSERT_EQ(queries[1].query, "milk water");
+ASSERT_DOUBLE_EQ(queries[1].time, 1.5);
+ASSERT_EQ(queries[2].query, "salt");
+ASSERT_DOUBLE_EQ(queries[2].time, 3.0);
+ASSERT_EQ(queries[3].query, "bread");
+ASSERT_DOUBLE_EQ(queries[3].time, 3.0);
+}
+
+TEST(TestCaseQueryReplay, TestReplayPacing)
+{
+std::vector<LoggedQuery> queries;
+for (size_t i = 0; i < 20; ++i)
+{
+    queries.push_back({ static_cast<double>(i) * 0.01, i == 7 ? "fail" : "query" });
+}
+CountingTarget target;
+ReplayOptions options;
+options.clients = 4;
+options.limit = 3;
+const ReplayReport max = ReplayQueries(queries, target, options);
+ASSERT_EQ(max.queries, 20);
+ASSERT_EQ(max.errors, 1);
+ASSERT_EQ(max.results, 19 * 3);
+ASSERT_EQ(max.latency.Count(), 20);
+ASSERT_EQ(max.service.Count(), 20);
+ASSERT_GT(max.qps, 0.0);
+
+// Журнал длиной 0.19 с, ускоренный вдвое, занимает не меньше 0.095 с
+options.pacing = ReplayPacing::Accelerated;
+options.speed = 2.0;
+const ReplayReport accelerated = ReplayQueries(queries, target, options);
+ASSERT_EQ(accelerated.queries, 20);
+ASSERT_GE(accelerated.seconds, 0.095);
+ASSERT_EQ(target.calls.load(), 40);
+
+const auto json = ReplayReportToJson(accelerated);
+ASSERT_EQ(json["queries"], 20);
+ASSERT_EQ(json["errors"], 1);
+ASSERT_EQ(json["latency"]["count"], 20);
+ASSERT_FALSE(json["latency"].contains("buckets"));
+}
+
+TEST(TestCaseQueryReplay, TestSearchServerTarget)
+{
+InvertedIndex idx;
+idx.UpdateDocumentBase({ "milk water sugar", "milk bread", "salt" });
+SearchServer srv(idx);
+SearchServerTarget target(srv);
+ASSERT_EQ(target.Search("milk", 5), 2);
+ASSERT_EQ(target.Search("milk", 1), 1);
+ASSERT_EQ(target.Search("pepper", 5), 0);
+const ReplayReport report = ReplayQueries({ { 0.0, "milk" }, { 0.0, "salt" }, { 0.0, "pepper" } }, target, {});
+ASSERT_EQ(report.queries, 3);
+ASSERT_EQ(report.errors, 0);
+ASSERT_EQ(report.results, 3);
+}
@@ -0,0 +1,155 @@
+#include <vector>
+#include <string>
+#include <gtest/gtest.h>
+#include "InvertedIndex.h"
+#include "PostingCache.h"
+#include "ResultCache.h"
+#include "SearchServer.h"
+
+TEST(TestCaseResultCache, TestScanResistance)
+{
+ResultCache cache(10);
+const std::vector<RelativeIndex> hot = { { 1, 1 } };
+cache.Put("hot", 1, hot);
+std::vector<RelativeIndex> result;
+ASSERT_TRUE(cache.Get("hot", 1, result));
+// Поток разовых запросов не вытесняет запрос, к которому обращались повторно
+for (int i = 0; i < 100; ++i)
+{
+    cache.Put("once" + std::to_string(i), 1, {});
+}
+ASSERT_TRUE(cache.Get("hot", 1, result));
+ASSERT_EQ(result, hot);
+ASSERT_FALSE(cache.Get("once0", 1, result));
+const ResultCacheStats stats = cache.GetStats();
+ASSERT_EQ(stats.hits, 2);
+ASSERT_EQ(stats.misses, 1);
+ASSERT_EQ(stats.insertions, 101);
+ASSERT_LE(stats.size, 10);
+ASSERT_EQ(stats.evictions, stats.insertions - stats.size);
+}
+
+TEST(TestCaseResultCache, TestVersionInvalidation)
+{
+ResultCache cache(10);
+cache.Put("query", 1, { { 0, 1 } });
+std::vector<RelativeIndex> result;
+ASSERT_TRUE(cache.Get("query", 1, result));
+ASSERT_FALSE(cache.Get("query", 2, result));
+ASSERT_EQ(cache.GetStats().invalidations, 1);
+ASSERT_EQ(cache.GetStats().size, 0);
+}
+
+TEST(TestCaseResultCache, TestSearchServerCache)
+{
+InvertedIndex idx;
+idx.UpdateDocumentBase({ "milk water", "milk milk", "sugar" });
+SearchServer srv(idx);
+ASSERT_EQ(srv.search(srv.Compile("milk water"), 5), (std::vector<RelativeIndex>{ { 0, 1 }, { 1, 1 } }));
+// Запрос с другим порядком и повтором слов - тот же ключ кэша
+ASSERT_EQ(srv.search(srv.Compile("water milk milk"), 5), (std::vector<RelativeIndex>{ { 0, 1 }, { 1, 1 } }));
+ASSERT_EQ(srv.GetCacheStats().hits, 1);
+ASSERT_EQ(srv.GetCacheStats().misses, 1);
+// После обновления базы ответ вычисляется заново
+idx.UpdateDocumentBase({ "sugar", "water" });
+ASSERT_EQ(srv.search(srv.Compile("milk water"), 5), (std::vector<RelativeIndex>{ { 1, 1 } }));
+ASSERT_EQ(srv.GetCacheStats().misses, 2);
+
+SearchOptions options;
+options.cache_capacity = 0;
+srv.SetOptions(options);
+srv.search(srv.Compile("milk water"), 5);
+// Отключенный кэш не обращается к сегментам и не меняет статистику
+ASSERT_EQ(srv.GetCacheStats().hits, 1);
+ASSERT_EQ(srv.GetCacheStats().misses, 2);
+ASSERT_EQ(srv.GetCacheStats().size, 0);
+}
+
+TEST(TestCaseResultCache, TestStaleCompiledQuery)
+{
+InvertedIndex idx;
+idx.UpdateDocumentBase({ "sugar", "water" });
+SearchServer srv(idx);
+// Запрос, разобранный до обновления базы, раскрывает шаблоны и нечеткие слова по новому словарю
+// и не получает из кэша ответ для прежних раскрытий
+const CompiledQuery wildcard = srv.Compile("wat*");
+const CompiledQuery fuzzy = srv.Compile("watr~1");
+ASSERT_EQ(srv.search(wildcard, 5), (std::vector<RelativeIndex>{ { 1, 1 } }));
+ASSERT_EQ(srv.search(fuzzy, 5), (std::vector<RelativeIndex>{ { 1, 1 } }));
+idx.UpdateDocumentBase({ "waters", "water", "wats" });
+ASSERT_EQ(srv.search(srv.Compile("wat*"), 5).size(), 3);
+ASSERT_EQ(srv.search(wildcard, 5).size(), 3);
+ASSERT_EQ(srv.search(fuzzy, 5).size(), 2);
+}
+
+TEST(TestCaseResultCache, TestPostingCache)
+{
+std::vector<std::string> docs;
+for (size_t i = 0; i < 6000; ++i)
+{
+    docs.push_back(std::string(i % 2 ? "odd" : "even") + (i % 3 ? "" : " third") + (i % 5 ? "" : " fifth"));
+}
+InvertedIndex idx;
+idx.UpdateDocumentBase(docs);
+
+PostingCache cache(1 << 20, 100);
+const auto pair = cache.Intersect(idx, "fifth", "third");
+ASSERT_NE(pair, nullptr);
+ASSERT_EQ(pair->first.entries.size(), 400);
+ASSERT_EQ(pair->second.entries.size(), 400);
+ASSERT_EQ(pair->first.entries[1], (Entry{ 15, 1 }));
+ASSERT_EQ(cache.Intersect(idx, "fifth", "third"), pair);
+// Пересечения коротких списков не кэшируются
+ASSERT_EQ(cache.Intersect(idx, "fifth", "missing"), nullptr);
+PostingCacheStats stats = cache.GetStats();
+ASSERT_EQ(stats.hits, 1);
+ASSERT_EQ(stats.misses, 1);
+ASSERT_EQ(stats.entries, 1);
+
+// Бюджет меньше одного пересечения - оно вычисляется, но не сохраняется
+cache.SetBudget(1024);
+ASSERT_NE(cache.Intersect(idx, "odd", "third"), nullptr);
+stats = cache.GetStats();
+ASSERT_EQ(stats.rejected, 1);
+ASSERT_EQ(stats.entries, 0);
+
+// Ответ сервера в режиме "все слова" с кэшем пересечений совпадает с ответом без него
+SearchServer srv(idx);
+SearchOptions options;
+options.mode = QueryMode::All;
+options.cache_capacity = 0;
+options.scorer = ScorerType::TfIdf;
+srv.SetOptions(options);
+const auto cached = srv.search(srv.Compile("odd third fifth"), 5);
+ASSERT_EQ(srv.search(srv.Compile("third odd fifth"), 5), cached);
+ASSERT_EQ(srv.GetPostingCacheStats().hits, 1);
+options.posting_cache_bytes = 0;
+srv.SetOptions(options);
+ASSERT_EQ(srv.search(srv.Compile("odd third fifth"), 5), cached);
+}
+
+TEST(TestCaseResultCache, TestPostingCacheOverBudget)
+{
+std::vector<std::string> docs;
+for (size_t i = 0; i < 3000; ++i)
+{
+    docs.push_back(i % 2 ? "alpha beta" : "alpha beta gamma");
+}
+InvertedIndex idx;
+idx.UpdateDocumentBase(docs);
+SearchServer srv(idx);
+SearchOptions options;
+options.mode = QueryMode::All;
+options.cache_capacity = 0;
+options.posting_cache_bytes = 0;
+srv.SetOptions(options);
+const auto expected = srv.search(srv.Compile("alpha beta gamma"), 10);
+ASSERT_EQ(expected.size(), 10);
+// Пересечение больше бюджета кэш не сохраняет, но итераторы читают его до конца запроса
+options.posting_cache_bytes = 1;
+srv.SetOptions(options);
+ASSERT_EQ(srv.search(srv.Compile("alpha beta gamma"), 10), expected);
+ASSERT_EQ(srv.search(srv.Compile("alpha beta"), 10), srv.search(srv.Compile("beta alpha"), 10));
+ASSERT_EQ(srv.GetPostingCacheStats().rejected, 3);
+ASSERT_EQ(srv.GetPostingCacheStats().entries, 0);
+}
@@ -1,6 +1,9 @@
+#include <filesystem>
+#include <fstream>
 #include <vector>
 #include <string>
 #include <gtest/gtest.h>
+#include <nlohmann/json.hpp>
 #include "InvertedIndex.h"
 #include "SearchServer.h"
 
@@ -75,4 +78,123 @@ idx.UpdateDocumentBase(docs);
 SearchServer srv(idx);
 std::vector<std::vector<RelativeIndex>> result = srv.search(request);
 ASSERT_EQ(result, expected);
-}
\ No newline at end of file
+}
+
+TEST(TestCaseSearchServer, TestTfIdfScorer)
+{
+const std::vector<std::string> docs =
+    {
+        "milk water",
+        "milk milk",
+        "americano cappuccino"
+    };
+const std::vector<std::string> request = { "milk water" };
+InvertedIndex idx;
+idx.UpdateDocumentBase(docs);
+SearchServer srv(idx);
+SearchOptions options;
+options.scorer = ScorerType::TfIdf;
+srv.SetOptions(options);
+std::vector<std::vector<RelativeIndex>> result = srv.search(request);
+// Редкое слово water весит больше, поэтому первый документ обгоняет второй
+ASSERT_EQ(result.size(), 1);
+ASSERT_EQ(result[0].size(), 2);
+ASSERT_EQ(result[0][0].doc_id, 0);
+ASSERT_EQ(result[0][0].rank, 1);
+ASSERT_EQ(result[0][1].doc_id, 1);
+ASSERT_LT(result[0][1].rank, 1);
+}
+
+TEST(TestCaseSearchServer, TestAllWordsMode)
+{
+const std::vector<std::string> docs =
+    {
+        "london is the capital of great britain",
+        "moscow is the capital of russia",
+        "welcome to moscow the capital of russia the third rome"
+    };
+const std::vector<std::string> request = { "moscow is the capital of russia", "capital of britain" };
+const std::vector<std::vector<RelativeIndex>> expected =
+    {
+        {
+            { 1, 1 }
+        },
+        {
+            { 0, 1 }
+        }
+    };
+InvertedIndex idx;
+idx.UpdateDocumentBase(docs);
+SearchServer srv(idx);
+SearchOptions options;
+options.mode = QueryMode::All;
+srv.SetOptions(options);
+std::vector<std::vector<RelativeIndex>> result = srv.search(request);
+ASSERT_EQ(result, expected);
+}
+
+TEST(TestCaseSearchServer, TestSlowQueryLog)
+{
+const std::vector<std::string> docs =
+    {
+        "milk milk milk milk water water water",
+        "milk water water",
+        "milk milk milk milk milk water water water water water",
+        "americano cappuccino"
+    };
+InvertedIndex idx;
+idx.UpdateDocumentBase(docs);
+SearchServer srv(idx);
+const std::string path = (std::filesystem::temp_directory_path() / "search_engine_slow_queries.jsonl").string();
+std::filesystem::remove(path);
+SearchOptions options;
+options.strategy = EvaluationStrategy::Exhaustive;
+srv.SetOptions(options);
+srv.search(srv.Compile("americano"), 5);
+ASSERT_TRUE(srv.GetSlowQueries().empty());
+
+// Порог в 1 нс - в журнал попадает каждый запрос
+options.slow_query_ms = 1e-6;
+options.slow_query_log = path;
+srv.SetOptions(options);
+srv.search(srv.Compile("milk water"), 5);
+srv.search(srv.Compile("water milk"), 5);
+auto records = srv.GetSlowQueries();
+ASSERT_EQ(records.size(), 2);
+ASSERT_EQ(records[0].strategy, "exhaustive");
+ASSERT_EQ(records[0].terms, (std::vector<std::pair<std::string, size_t>>{ { "milk", 3 }, { "water", 3 } }));
+ASSERT_EQ(records[0].docs_scored, 3);
+ASSERT_EQ(records[0].results, 3);
+ASSERT_GT(records[0].latency_ns, 0);
+if (QUERY_PROFILING_ENABLED)
+{
+    ASSERT_LE(records[0].phase_ns[static_cast<size_t>(QueryPhase::Evaluate)], records[0].latency_ns);
+}
+// Тот же запрос в другом порядке слов - ответ из кэша
+ASSERT_EQ(records[1].strategy, "cache");
+ASSERT_EQ(records[1].docs_scored, 0);
+
+options.mode = QueryMode::All;
+options.cache_capacity = 0;
+srv.SetOptions(options);
+srv.search(srv.Compile("milk cappuccino"), 5);
+records = srv.GetSlowQueries();
+ASSERT_EQ(records.back().strategy, "conjunctive");
+ASSERT_EQ(records.back().results, 0);
+
+// Файл журнала - по объекту JSON в строке
+srv.SetOptions(SearchOptions());
+std::ifstream file(path);
+std::string line;
+std::vector<nlohmann::json> lines;
+while (std::getline(file, line))
+{
+    lines.push_back(nlohmann::json::parse(line));
+}
+ASSERT_EQ(lines.size(), 3);
+ASSERT_EQ(lines[0]["query"], "(milk water)");
+ASSERT_EQ(lines[0]["terms"][1][0], "water");
+ASSERT_EQ(lines[2]["strategy"], "conjunctive");
+file.close();
+std::filesystem::remove(path);
+}
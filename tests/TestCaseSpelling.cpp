@@ -0,0 +1,108 @@
+#include <random>
+#include <set>
+#include <vector>
+#include <string>
+#include <gtest/gtest.h>
+#include "FuzzyTerm.h"
+#include "InvertedIndex.h"
+#include "SearchServer.h"
+#include "SpellingIndex.h"
+
+TEST(TestCaseSpelling, TestSpellingIndex)
+{
+// Кандидаты индекса удалений должны содержать все слова на расстоянии не больше distance,
+// в том числе длиннее префикса и с правками за его границей
+const std::vector<std::string> alphabet = { "a", "b", "c", "д", "е" };
+std::mt19937 rng(5);
+std::set<std::string> unique;
+while (unique.size() < 3000)
+{
+    std::string word;
+    const size_t length = 1 + rng() % 10;
+    for (size_t i = 0; i < length; ++i)
+    {
+        word += alphabet[rng() % alphabet.size()];
+    }
+    unique.insert(word);
+}
+const std::vector<std::string> terms(unique.begin(), unique.end());
+SpellingIndex spelling;
+spelling.Build(terms, SPELLING_MAX_DISTANCE);
+ASSERT_FALSE(spelling.Empty());
+for (const std::string query : { "abc", "дед", "a", "cabдeabba", "ebbacccaeb", "abcdefgh" })
+{
+    for (size_t distance = 0; distance <= SPELLING_MAX_DISTANCE; ++distance)
+    {
+        const std::vector<uint32_t> candidates = spelling.Candidates(query, distance);
+        for (uint32_t id = 0; id < terms.size(); ++id)
+        {
+            if (EditDistance(query, terms[id]) <= distance)
+            {
+                ASSERT_TRUE(std::binary_search(candidates.begin(), candidates.end(), id))
+                    << query << "~" << distance << " " << terms[id];
+            }
+        }
+    }
+}
+spelling.Clear();
+ASSERT_TRUE(spelling.Empty());
+ASSERT_TRUE(spelling.Candidates("abc", 1).empty());
+}
+
+TEST(TestCaseSpelling, TestSuggest)
+{
+const std::vector<std::string> docs =
+    {
+        "moscow is the capital of russia",
+        "moscow street",
+        "mascot of the team",
+        "rome is a city"
+    };
+for (const bool suggestions : { true, false })
+{
+    InvertedIndex idx;
+    IndexOptions index_options;
+    index_options.suggestions = suggestions;
+    idx.SetOptions(index_options);
+    idx.UpdateDocumentBase(docs);
+    ASSERT_EQ(idx.GetSpellingIndex().Empty(), !suggestions);
+
+    // При равном расстоянии выше более частое слово
+    const auto matches = SuggestTerms(idx, "moscot", 1, 2);
+    ASSERT_EQ(matches.size(), 2);
+    ASSERT_EQ(matches[0].term, "moscow");
+    ASSERT_EQ(matches[1].term, "mascot");
+    ASSERT_EQ(matches[1].distance, 1);
+
+    SearchServer srv(idx);
+    ASSERT_TRUE(srv.search(srv.Compile("moskow capitl"), docs.size()).empty());
+    ASSERT_EQ(srv.Suggest("Moskow capitl"), "moscow capital");
+    // Известные и слишком короткие слова не меняются
+    ASSERT_EQ(srv.Suggest("rome moskow"), "rome moscow");
+    ASSERT_EQ(srv.Suggest("ro"), "");
+    ASSERT_EQ(srv.Suggest("qwertyuiop"), "");
+
+    SearchOptions options;
+    options.syntax = QuerySyntax::Boolean;
+    srv.SetOptions(options);
+    ASSERT_EQ(srv.Suggest("(moskow OR rme) AND -\"stret\""), "(moscow OR rome) AND -\"street\"");
+    options.suggestion_distance = 0;
+    srv.SetOptions(options);
+    ASSERT_EQ(srv.Suggest("moskow"), "");
+}
+}
+
+TEST(TestCaseSpelling, TestSuggestStemmer)
+{
+// Со стеммером словарь хранит основы, а подсказка - написание слова из документов
+InvertedIndex idx;
+IndexOptions index_options;
+index_options.stemmer = StemmerType::Auto;
+idx.SetOptions(index_options);
+idx.UpdateDocumentBase({ "столица москва", "Столица России", "capitals of europe", "capitals" });
+ASSERT_EQ(idx.GetSurfaceForm(idx.normalizeWord("столица")), "столица");
+ASSERT_EQ(idx.GetSurfaceForm(idx.normalizeWord("capitals")), "capitals");
+SearchServer srv(idx);
+ASSERT_EQ(srv.Suggest("москва столицаа"), "москва столица");
+ASSERT_EQ(srv.Suggest("capitls"), "capitals");
+}
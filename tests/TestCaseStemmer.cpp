@@ -0,0 +1,61 @@
+#include <vector>
+#include <string>
+#include <gtest/gtest.h>
+#include "InvertedIndex.h"
+#include "SearchServer.h"
+#include "Stemmer.h"
+
+TEST(TestCaseStemmer, TestRussianStemmer)
+{
+const RussianStemmer stemmer;
+ASSERT_EQ(stemmer.Stem("столица"), "столиц");
+ASSERT_EQ(stemmer.Stem("столицы"), "столиц");
+ASSERT_EQ(stemmer.Stem("столицей"), "столиц");
+ASSERT_EQ(stemmer.Stem("читать"), "чита");
+ASSERT_EQ(stemmer.Stem("красивая"), "красив");
+ASSERT_EQ(stemmer.Stem("прочитавши"), "прочита");
+ASSERT_EQ(stemmer.Stem("умываться"), "умыва");
+ASSERT_EQ(stemmer.Stem("сильнейший"), "сильн");
+ASSERT_EQ(stemmer.Stem("радость"), "радост");
+// Слова не на кириллице не изменяются
+ASSERT_EQ(stemmer.Stem("capital"), "capital");
+}
+
+TEST(TestCaseStemmer, TestPorterStemmer)
+{
+const PorterStemmer stemmer;
+const std::vector<std::pair<std::string, std::string>> cases =
+    {
+        { "caresses", "caress" }, { "ponies", "poni" }, { "cats", "cat" }, { "agreed", "agre" },
+        { "plastered", "plaster" }, { "motoring", "motor" }, { "hopping", "hop" }, { "falling", "fall" },
+        { "filing", "file" }, { "happy", "happi" }, { "relational", "relat" }, { "generalizations", "gener" },
+        { "capital", "capit" }, { "adjustment", "adjust" }, { "controlling", "control" }, { "is", "is" },
+        { "r2d2", "r2d2" }
+    };
+for (const auto& [word, stem] : cases)
+{
+    ASSERT_EQ(stemmer.Stem(word), stem) << word;
+}
+}
+
+TEST(TestCaseStemmer, TestStemmedSearch)
+{
+const std::vector<std::string> docs =
+    {
+        "Москва - столица России",
+        "столицы европейских государств",
+        "capitals of the world"
+    };
+InvertedIndex idx;
+IndexOptions options;
+options.stemmer = StemmerType::Auto;
+idx.SetOptions(options);
+idx.UpdateDocumentBase(docs);
+SearchServer srv(idx);
+const std::vector<RelativeIndex> expected = { { 0, 1 }, { 1, 1 } };
+ASSERT_EQ(srv.search(srv.Compile("столицей"), 5), expected);
+ASSERT_EQ(srv.search(srv.Compile("Capital"), 5), (std::vector<RelativeIndex>{ { 2, 1 } }));
+// Повторная нормализация берет основу из кэша и дает тот же результат
+ASSERT_EQ(StemWord(StemmerType::Auto, "столицы"), "столиц");
+ASSERT_EQ(StemWord(StemmerType::Auto, "столицы"), "столиц");
+}
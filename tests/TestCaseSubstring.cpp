@@ -0,0 +1,67 @@
+#include <algorithm>
+#include <vector>
+#include <string>
+#include <gtest/gtest.h>
+#include "InvertedIndex.h"
+#include "SearchServer.h"
+
+TEST(TestCaseSubstring, TestFindSubstring)
+{
+const std::vector<std::string> docs =
+    {
+        "bearing ITB-4471 and ITB-4472",
+        "valve 447 471",
+        "part ITB-4471",
+        "Деталь КП-4471Б"
+    };
+for (const bool substrings : { true, false })
+{
+    InvertedIndex idx;
+    IndexOptions options;
+    options.substrings = substrings;
+    idx.SetOptions(options);
+    idx.UpdateDocumentBase(docs);
+    ASSERT_EQ(idx.HasSubstrings(), substrings);
+    // Документ 1 содержит все триграммы "4471" в разных словах и отсеивается проверкой текста
+    ASSERT_EQ(idx.FindSubstring("4471"), (std::vector<Entry>{ { 0, 1 }, { 2, 1 }, { 3, 1 } }));
+    ASSERT_EQ(idx.FindSubstring("itb447"), (std::vector<Entry>{ { 0, 2 }, { 2, 1 } }));
+    ASSERT_EQ(idx.FindSubstring("кп4471"), (std::vector<Entry>{ { 3, 1 } }));
+    ASSERT_EQ(idx.FindSubstring("44"), (std::vector<Entry>{ { 0, 2 }, { 1, 1 }, { 2, 1 }, { 3, 1 } }));
+    ASSERT_TRUE(idx.FindSubstring("9999").empty());
+}
+}
+
+TEST(TestCaseSubstring, TestSubstringSearch)
+{
+const std::vector<std::string> docs =
+    {
+        "bearing ITB-4471",
+        "valve ITB-5000",
+        "bearing KP-14471"
+    };
+InvertedIndex idx;
+IndexOptions index_options;
+index_options.substrings = true;
+idx.SetOptions(index_options);
+idx.UpdateDocumentBase(docs);
+SearchServer srv(idx);
+const auto doc_ids = [&](const std::string& query)
+{
+    std::vector<size_t> result;
+    for (const auto& index : srv.search(srv.Compile(query), docs.size()))
+    {
+        result.push_back(index.doc_id);
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+};
+ASSERT_EQ(doc_ids("sub:4471"), (std::vector<size_t>{ 0, 2 }));
+ASSERT_EQ(doc_ids("sub:ITB-4471"), (std::vector<size_t>{ 0 }));
+ASSERT_EQ(doc_ids("valve sub:4471"), (std::vector<size_t>{ 0, 1, 2 }));
+
+SearchOptions options;
+options.syntax = QuerySyntax::Boolean;
+srv.SetOptions(options);
+ASSERT_EQ(doc_ids("sub:itb AND bearing"), (std::vector<size_t>{ 0 }));
+ASSERT_EQ(doc_ids("sub:4471 -sub:kp"), (std::vector<size_t>{ 0 }));
+}
@@ -0,0 +1,147 @@
+#include <algorithm>
+#include <cstring>
+#include <vector>
+#include <string>
+#include <gtest/gtest.h>
+#include "InvertedIndex.h"
+#include "TermDictionary.h"
+
+TEST(TestCaseTermDictionary, TestFindAndTerm)
+{
+// Слова с длинными общими префиксами и несколько неполных блоков
+std::vector<std::string> terms;
+for (int i = 0; i < 100; ++i)
+{
+    terms.push_back("capital" + std::to_string(i));
+    terms.push_back("city" + std::to_string(i * 7));
+}
+terms.push_back("a");
+terms.push_back("столица");
+std::sort(terms.begin(), terms.end());
+terms.erase(std::unique(terms.begin(), terms.end()), terms.end());
+
+TermDictionary dictionary;
+dictionary.Build(terms);
+ASSERT_EQ(dictionary.Size(), terms.size());
+for (size_t id = 0; id < terms.size(); ++id)
+{
+    ASSERT_EQ(dictionary.Find(terms[id]), id);
+    ASSERT_EQ(dictionary.Term(static_cast<uint32_t>(id)), terms[id]);
+}
+// Отсутствующие слова: до первого, после последнего, между словами
+ASSERT_EQ(dictionary.Find(""), NO_TERM);
+ASSERT_EQ(dictionary.Find("яблоко"), NO_TERM);
+ASSERT_EQ(dictionary.Find("capital"), NO_TERM);
+ASSERT_EQ(dictionary.Find("capital100"), NO_TERM);
+ASSERT_EQ(dictionary.Find("city1"), NO_TERM);
+// Общие префиксы и окончания хранятся один раз: словарь меньше суммы длин слов
+size_t total = 0;
+for (const auto& term : terms)
+{
+    total += term.size();
+}
+ASSERT_LT(dictionary.MemoryBytes(), total);
+
+// Подключение сохраненного буфера без копирования
+const auto [data, size] = dictionary.Data();
+const std::vector<uint8_t> saved(data, data + size);
+TermDictionary attached;
+ASSERT_TRUE(attached.Attach(saved.data(), saved.size()));
+ASSERT_EQ(attached.Size(), terms.size());
+ASSERT_EQ(attached.Find("city693"), dictionary.Find("city693"));
+ASSERT_FALSE(attached.Attach(saved.data(), 4));
+ASSERT_EQ(attached.Size(), 0);
+ASSERT_EQ(attached.Find("city693"), NO_TERM);
+// Обрезанный буфер с целым заголовком: начальное состояние записано последним и обрывается
+for (size_t truncated = 12; truncated < saved.size(); ++truncated)
+{
+    ASSERT_FALSE(attached.Attach(saved.data(), truncated)) << truncated;
+}
+// Количество слов в заголовке не совпадает с выходами переходов
+std::vector<uint8_t> corrupted = saved;
+++corrupted[4];
+ASSERT_FALSE(attached.Attach(corrupted.data(), corrupted.size()));
+// Целый заголовок и начальное состояние, остальные состояния затерты
+uint32_t root = 0;
+std::memcpy(&root, saved.data() + 8, sizeof(root));
+corrupted = saved;
+std::fill(corrupted.begin() + 12, corrupted.begin() + root, 0xFF);
+ASSERT_FALSE(attached.Attach(corrupted.data(), corrupted.size()));
+std::fill(corrupted.begin() + 12, corrupted.begin() + root, 0);
+ASSERT_FALSE(attached.Attach(corrupted.data(), corrupted.size()));
+ASSERT_TRUE(attached.Attach(saved.data(), saved.size()));
+ASSERT_EQ(attached.Find("city693"), dictionary.Find("city693"));
+
+dictionary.Build({});
+ASSERT_EQ(dictionary.Size(), 0);
+ASSERT_EQ(dictionary.Find("a"), NO_TERM);
+}
+
+TEST(TestCaseTermDictionary, TestOrderedEnumeration)
+{
+const std::vector<std::string> terms =
+    {
+        "cap", "capital", "capitals", "capture", "car", "city", "столица"
+    };
+TermDictionary dictionary;
+dictionary.Build(terms);
+// Номер первого слова, не меньшего заданного
+ASSERT_EQ(dictionary.LowerBound(""), 0);
+ASSERT_EQ(dictionary.LowerBound("capital"), 1);
+ASSERT_EQ(dictionary.LowerBound("capitalz"), 3);
+ASSERT_EQ(dictionary.LowerBound("cb"), 5);
+ASSERT_EQ(dictionary.LowerBound("zzz"), 6);
+ASSERT_EQ(dictionary.LowerBound("я"), 7);
+// Слова с общим префиксом имеют подряд идущие номера
+ASSERT_EQ(dictionary.PrefixRange("cap"), std::make_pair(0u, 4u));
+ASSERT_EQ(dictionary.PrefixRange("capit"), std::make_pair(1u, 3u));
+ASSERT_EQ(dictionary.PrefixRange("c"), std::make_pair(0u, 6u));
+ASSERT_EQ(dictionary.PrefixRange("ca"), std::make_pair(0u, 5u));
+ASSERT_EQ(dictionary.PrefixRange("cb"), std::make_pair(5u, 5u));
+ASSERT_EQ(dictionary.PrefixRange(""), std::make_pair(0u, 7u));
+// Полный перебор и перебор диапазона
+std::vector<std::string> all;
+for (TermDictionary::Iterator it(dictionary); !it.AtEnd(); it.Next())
+{
+    ASSERT_EQ(it.Id(), all.size());
+    all.push_back(it.Term());
+}
+ASSERT_EQ(all, terms);
+std::vector<std::string> range;
+TermDictionary::Iterator it(dictionary);
+for (it.Seek("capitalz"); !it.AtEnd() && it.Term() < "city"; it.Next())
+{
+    range.push_back(it.Term());
+}
+ASSERT_EQ(range, (std::vector<std::string>{ "capture", "car" }));
+it.Seek("car");
+ASSERT_EQ(it.Term(), "car");
+ASSERT_EQ(it.Id(), 4);
+it.Seek("яблоко");
+ASSERT_TRUE(it.AtEnd());
+}
+
+TEST(TestCaseTermDictionary, TestIndexTermIds)
+{
+const std::vector<std::string> docs =
+    {
+        "milk water water",
+        "sugar milk",
+        "water"
+    };
+InvertedIndex idx;
+idx.UpdateDocumentBase(docs);
+// Номера выдаются в лексикографическом порядке
+const TermDictionary& dictionary = idx.GetTermDictionary();
+ASSERT_EQ(dictionary.Size(), 3);
+ASSERT_EQ(idx.FindTermId("milk"), 0);
+ASSERT_EQ(idx.FindTermId("sugar"), 1);
+ASSERT_EQ(idx.FindTermId("water"), 2);
+ASSERT_EQ(idx.FindTermId("coffee"), NO_TERM);
+ASSERT_EQ(idx.GetPostings(idx.FindTermId("water")).entries, (std::vector<Entry>{ { 0, 2 }, { 2, 1 } }));
+ASSERT_EQ(&idx.GetPostings(2), &idx.FindPostings("water"));
+
+idx.UpdateDocumentBase({});
+ASSERT_EQ(idx.GetTermDictionary().Size(), 0);
+ASSERT_TRUE(idx.GetWordCount("water").empty());
+}
@@ -0,0 +1,44 @@
+#include <vector>
+#include <string>
+#include <gtest/gtest.h>
+#include "InvertedIndex.h"
+#include "SearchServer.h"
+#include "TextNormalizer.h"
+
+TEST(TestCaseTextNormalizer, TestNormalizeWord)
+{
+// ASCII: длинные слова проходят быстрым путем по 8 байт
+ASSERT_EQ(NormalizeWord("Moscow,"), "moscow");
+ASSERT_EQ(NormalizeWord("internationalization"), "internationalization");
+ASSERT_EQ(NormalizeWord("Internationalization2024!"), "internationalization2024");
+// Кириллица, буква ё и разложенная й (и + U+0306)
+ASSERT_EQ(NormalizeWord("МОСКВА"), "москва");
+ASSERT_EQ(NormalizeWord("«Ёлка»"), "елка");
+ASSERT_EQ(NormalizeWord("Чайка"), NormalizeWord("Чаи\xCC\x86ка"));
+ASSERT_EQ(NormalizeWord("ЧАИ\xCC\x86КА"), "чайка");
+// Смешанный текст, другие алфавиты, знаки препинания и эмодзи
+ASSERT_EQ(NormalizeWord("Hello-Мир"), "helloмир");
+ASSERT_EQ(NormalizeWord("ΣΟΦΊΑ"), "σοφία");
+ASSERT_EQ(NormalizeWord("Straße"), "straße");
+ASSERT_EQ(NormalizeWord("—"), "");
+ASSERT_EQ(NormalizeWord("ok\xF0\x9F\x98\x80"), "ok");
+// Некорректные байты пропускаются
+ASSERT_EQ(NormalizeWord("ab\xFF\xD0" "cd"), "abcd");
+}
+
+TEST(TestCaseTextNormalizer, TestCyrillicSearch)
+{
+const std::vector<std::string> docs =
+    {
+        "Москва - столица России",
+        "Третий Рим",
+        "welcome to Moscow"
+    };
+InvertedIndex idx;
+idx.UpdateDocumentBase(docs);
+ASSERT_EQ(idx.GetWordCount("москва"), (std::vector<Entry>{ { 0, 1 } }));
+SearchServer srv(idx);
+const std::vector<RelativeIndex> expected = { { 0, 1 } };
+ASSERT_EQ(srv.search(srv.Compile("СТОЛИЦА"), 5), expected);
+ASSERT_EQ(srv.search(srv.Compile("россии"), 5), expected);
+}
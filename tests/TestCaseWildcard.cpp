@@ -0,0 +1,107 @@
+#include <algorithm>
+#include <vector>
+#include <string>
+#include <gtest/gtest.h>
+#include "BooleanQuery.h"
+#include "InvertedIndex.h"
+#include "SearchServer.h"
+#include "Wildcard.h"
+
+TEST(TestCaseWildcard, TestExpandWildcard)
+{
+const std::vector<std::string> docs =
+    {
+        "capital capitals capitol city",
+        "capital copital captain",
+        "capital москва московский мост"
+    };
+InvertedIndex idx;
+idx.UpdateDocumentBase(docs);
+ASSERT_EQ(NormalizeWildcard("Capit*"), "capit*");
+ASSERT_EQ(NormalizeWildcard("C**p?"), "c*p?");
+ASSERT_TRUE(IsWildcardPattern("c?pital"));
+ASSERT_FALSE(IsWildcardPattern("capital"));
+
+using Terms = std::vector<std::string>;
+ASSERT_EQ(ExpandWildcard(idx, "capit*", 100), (Terms{ "capital", "capitals", "capitol" }));
+ASSERT_EQ(ExpandWildcard(idx, "c?pital", 100), (Terms{ "capital", "copital" }));
+ASSERT_EQ(ExpandWildcard(idx, "*ital", 100), (Terms{ "capital", "copital" }));
+ASSERT_EQ(ExpandWildcard(idx, "cap*l?", 100), (Terms{ "capitals" }));
+ASSERT_EQ(ExpandWildcard(idx, "c*t*", 100), (Terms{ "capital", "capitals", "capitol", "captain", "city", "copital" }));
+ASSERT_EQ(ExpandWildcard(idx, "zz*", 100), Terms{});
+// "?" - один символ UTF-8, а не один байт
+ASSERT_EQ(ExpandWildcard(idx, "мо?ква", 100), Terms{ "москва" });
+ASSERT_EQ(ExpandWildcard(idx, "мос?", 100), Terms{ "мост" });
+ASSERT_EQ(ExpandWildcard(idx, "мос*", 100), (Terms{ "москва", "московский", "мост" }));
+// Ограничение: остаются самые частые слова
+ASSERT_EQ(ExpandWildcard(idx, "c*", 1), Terms{ "capital" });
+}
+
+TEST(TestCaseWildcard, TestWildcardSearch)
+{
+const std::vector<std::string> docs =
+    {
+        "london is the capital of great britain",
+        "moscow is the capital of russia",
+        "the capitol building",
+        "rome is a city",
+        "capitals of europe"
+    };
+InvertedIndex idx;
+idx.UpdateDocumentBase(docs);
+SearchServer srv(idx);
+const auto doc_ids = [&](const std::string& query)
+{
+    std::vector<size_t> result;
+    for (const auto& index : srv.search(srv.Compile(query), docs.size()))
+    {
+        result.push_back(index.doc_id);
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+};
+ASSERT_EQ(doc_ids("capit*"), (std::vector<size_t>{ 0, 1, 2, 4 }));
+ASSERT_EQ(doc_ids("c?pitol"), (std::vector<size_t>{ 2 }));
+ASSERT_EQ(doc_ids("rome c*ty"), (std::vector<size_t>{ 3 }));
+ASSERT_EQ(doc_ids("*"), std::vector<size_t>{});
+
+SearchOptions options;
+options.syntax = QuerySyntax::Boolean;
+srv.SetOptions(options);
+ASSERT_EQ(doc_ids("capit* AND russia"), (std::vector<size_t>{ 1 }));
+ASSERT_EQ(doc_ids("capit* -capital"), (std::vector<size_t>{ 2, 4 }));
+
+// Без раскрытия шаблонов "*" отбрасывается, слова "capit" нет
+options.wildcard_limit = 0;
+srv.SetOptions(options);
+ASSERT_EQ(doc_ids("capit*"), std::vector<size_t>{});
+}
+
+TEST(TestCaseWildcard, TestWildcardUnion)
+{
+// Много слов с общим префиксом - объединение через битовую карту, результат
+// должен совпасть с запросом из тех же слов через OR
+std::vector<std::string> docs;
+for (size_t i = 0; i < 200; ++i)
+{
+    docs.push_back("term" + std::to_string(i % 20) + " term" + std::to_string(i % 7) + " other" + std::to_string(i));
+}
+InvertedIndex idx;
+idx.UpdateDocumentBase(docs);
+for (const auto scorer : { ScorerType::TermCount, ScorerType::TfIdf })
+{
+    SearchServer srv(idx);
+    SearchOptions options;
+    options.scorer = scorer;
+    options.syntax = QuerySyntax::Boolean;
+    srv.SetOptions(options);
+    std::string expanded;
+    for (size_t i = 0; i < 20; ++i)
+    {
+        expanded += (i ? " OR term" : "term") + std::to_string(i);
+    }
+    const CompiledQuery wildcard = srv.Compile("term*");
+    ASSERT_EQ(wildcard.root->should.front()->terms.size(), 20);
+    ASSERT_EQ(srv.search(wildcard, docs.size()), srv.search(srv.Compile(expanded), docs.size()));
+}
+}
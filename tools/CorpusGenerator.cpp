@@ -0,0 +1,191 @@
+#include "CorpusGenerator.h"
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace
+{
+    // Следующее число последовательности SplitMix64
+    uint64_t NextRandom(uint64_t& state)
+    {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    // Равномерное число из [0, 1) с 53 значащими битами
+    double NextUniform(uint64_t& state)
+    {
+        return static_cast<double>(NextRandom(state) >> 11) * 0x1.0p-53;
+    }
+
+    // Стандартное нормальное распределение (преобразование Бокса-Мюллера)
+    double NextNormal(uint64_t& state)
+    {
+        const double u1 = 1.0 - NextUniform(state); // (0, 1] - логарифм определен
+        const double u2 = NextUniform(state);
+        return std::sqrt(-2.0 * std::log(u1)) * std::cos(2.0 * 3.14159265358979323846 * u2);
+    }
+
+    // Слоги псевдослов: 16 согласных на 4 гласных. Среди согласных нет b, h и t, поэтому
+    // короткие слова не совпадают с английскими стоп-словами
+    constexpr char CONSONANTS[] = "dfgklmnprsvzcjwy";
+    constexpr char VOWELS[] = "aeio";
+    constexpr size_t SYLLABLES = 64;
+}
+
+std::string MakePseudoWord(size_t number)
+{
+    std::string word;
+    while (true)
+    {
+        const size_t syllable = number % SYLLABLES;
+        word += CONSONANTS[syllable / 4];
+        word += VOWELS[syllable % 4];
+        number /= SYLLABLES;
+        if (number == 0)
+        {
+            return word;
+        }
+        --number; // биективная запись: "ba" и "baba" - разные слова, ведущих нулей нет
+    }
+}
+
+CorpusGenerator::CorpusGenerator(const CorpusOptions& options)
+    : _options(options)
+{
+    _options.vocabulary = std::max<size_t>(_options.vocabulary, 1);
+    _options.mean_length = std::max<size_t>(_options.mean_length, 1);
+    _terms.reserve(_options.vocabulary);
+    _cdf.reserve(_options.vocabulary);
+    double total = 0;
+    for (size_t rank = 0; rank < _options.vocabulary; ++rank)
+    {
+        _terms.push_back(MakePseudoWord(rank));
+        total += 1.0 / std::pow(static_cast<double>(rank + 1), _options.zipf_exponent);
+        _cdf.push_back(total);
+    }
+    for (double& value : _cdf)
+    {
+        value /= total;
+    }
+}
+
+// Обратная функция распределения: первый ранг, накопленная вероятность которого больше u
+size_t CorpusGenerator::SampleRank(double u, size_t first, size_t last) const
+{
+    const double low = first == 0 ? 0.0 : _cdf[first - 1];
+    const double target = low + u * (_cdf[last - 1] - low);
+    const auto it = std::upper_bound(_cdf.begin() + static_cast<std::ptrdiff_t>(first),
+                                     _cdf.begin() + static_cast<std::ptrdiff_t>(last), target);
+    return std::min(static_cast<size_t>(it - _cdf.begin()), last - 1);
+}
+
+size_t CorpusGenerator::SampleLength(uint64_t& state) const
+{
+    const size_t mean = _options.mean_length;
+    switch (_options.length_distribution)
+    {
+    case LengthDistribution::Fixed:
+        return mean;
+    case LengthDistribution::Uniform:
+        return 1 + NextRandom(state) % (2 * mean - 1);
+    case LengthDistribution::LogNormal:
+    default:
+    {
+        // Среднее логнормального распределения exp(mu + sigma^2 / 2) равно mean
+        const double sigma = _options.length_sigma;
+        const double mu = std::log(static_cast<double>(mean)) - sigma * sigma / 2;
+        const double length = std::exp(mu + sigma * NextNormal(state));
+        return static_cast<size_t>(std::clamp(std::round(length), 1.0, 100.0 * static_cast<double>(mean)));
+    }
+    }
+}
+
+// Документ - слова, независимо выбранные по закону Ципфа
+std::string CorpusGenerator::Document(size_t doc_id) const
+{
+    uint64_t state = _options.seed ^ (0xD1B54A32D192ED03ull * (doc_id + 1));
+    const size_t length = SampleLength(state);
+    std::string document;
+    for (size_t i = 0; i < length; ++i)
+    {
+        if (i > 0)
+        {
+            document += ' ';
+        }
+        document += _terms[SampleRank(NextUniform(state), 0, _terms.size())];
+    }
+    return document;
+}
+
+std::vector<std::string> CorpusGenerator::Documents() const
+{
+    std::vector<std::string> documents;
+    documents.reserve(_options.documents);
+    for (size_t doc_id = 0; doc_id < _options.documents; ++doc_id)
+    {
+        documents.push_back(Document(doc_id));
+    }
+    return documents;
+}
+
+std::vector<std::string> CorpusGenerator::Queries(const WorkloadOptions& workload) const
+{
+    const size_t vocabulary = _terms.size();
+    const size_t head_end = std::min(workload.head_size, vocabulary);
+    const size_t torso_end = std::max(head_end, std::min(workload.torso_size, vocabulary));
+    // Полуинтервалы рангов классов; пустой класс заменяется всем словарем
+    const auto bounds = [&](TermClass term_class) -> std::pair<size_t, size_t>
+    {
+        const std::pair<size_t, size_t> range = term_class == TermClass::Head  ? std::make_pair(size_t{ 0 }, head_end)
+                                                : term_class == TermClass::Torso ? std::make_pair(head_end, torso_end)
+                                                                                 : std::make_pair(torso_end, vocabulary);
+        return range.first < range.second ? range : std::make_pair(size_t{ 0 }, vocabulary);
+    };
+    const double shares = workload.head_share + workload.torso_share + workload.tail_share;
+    const auto pick_class = [&](uint64_t& state)
+    {
+        // Без заданных долей все классы равновероятны
+        const double u = NextUniform(state) * (shares > 0 ? shares : 3.0);
+        const double head = shares > 0 ? workload.head_share : 1.0;
+        const double torso = shares > 0 ? workload.torso_share : 1.0;
+        return u < head ? TermClass::Head : u < head + torso ? TermClass::Torso : TermClass::Tail;
+    };
+    const size_t min_terms = std::max<size_t>(workload.min_terms, 1);
+    const size_t max_terms = std::max(workload.max_terms, min_terms);
+
+    uint64_t state = workload.seed;
+    std::vector<std::string> queries;
+    queries.reserve(workload.queries);
+    std::vector<size_t> ranks;
+    for (size_t q = 0; q < workload.queries; ++q)
+    {
+        const size_t count = min_terms + NextRandom(state) % (max_terms - min_terms + 1);
+        const TermClass query_class = pick_class(state);
+        ranks.clear();
+        for (size_t i = 0; i < count; ++i)
+        {
+            const auto [first, last] = bounds(workload.mixed ? pick_class(state) : query_class);
+            // Повторы слова в запросе заменяются другим словом класса, если оно есть
+            size_t rank = SampleRank(NextUniform(state), first, last);
+            for (size_t attempt = 0; attempt < 8 && std::find(ranks.begin(), ranks.end(), rank) != ranks.end(); ++attempt)
+            {
+                rank = SampleRank(NextUniform(state), first, last);
+            }
+            ranks.push_back(rank);
+        }
+        std::string query;
+        for (const size_t rank : ranks)
+        {
+            if (!query.empty())
+            {
+                query += ' ';
+            }
+            query += _terms[rank];
+        }
+        queries.push_back(std::move(query));
+    }
+    return queries;
+}
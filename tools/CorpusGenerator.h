@@ -0,0 +1,110 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Генератор синтетических корпусов документов и нагрузки запросов для бенчмарков и
+// нагрузочных тестов. Результат полностью определяется настройками и зерном: генератор
+// случайных чисел (SplitMix64) и распределения реализованы здесь же - распределения
+// стандартной библиотеки на разных платформах дают разные значения
+
+// Распределение длины документа в словах
+enum class LengthDistribution
+{
+    Fixed,    // Все документы длиной mean_length
+    Uniform,  // Равномерно от 1 до 2 * mean_length - 1
+    LogNormal // Логнормальное со средним mean_length и параметром length_sigma (по умолчанию):
+              // много коротких документов и длинный хвост больших
+};
+
+// Настройки корпуса
+struct CorpusOptions
+{
+    size_t documents = 1000; // Количество документов
+
+    size_t vocabulary = 50000; // Количество различных слов
+
+    double zipf_exponent = 1.0; // Показатель закона Ципфа: частота слова ранга r пропорциональна 1 / r^s
+
+    size_t mean_length = 300; // Средняя длина документа в словах
+
+    LengthDistribution length_distribution = LengthDistribution::LogNormal;
+
+    double length_sigma = 0.8; // Разброс логарифма длины для LogNormal
+
+    uint64_t seed = 1;
+};
+
+// Класс слова запроса по рангу в корпусе
+enum class TermClass
+{
+    Head,  // Самые частые слова: ранги [0, head_size)
+    Torso, // Средние: [head_size, torso_size)
+    Tail   // Редкие: [torso_size, vocabulary)
+};
+
+// Настройки нагрузки запросов
+struct WorkloadOptions
+{
+    size_t queries = 1000; // Количество запросов
+
+    size_t min_terms = 1; // Количество слов в запросе - равномерно от min_terms до max_terms
+
+    size_t max_terms = 4;
+
+    size_t head_size = 100; // Границы классов слов по рангу
+
+    size_t torso_size = 10000;
+
+    // Доли слов запросов из каждого класса (Head, Torso, Tail), нормируются на сумму
+    double head_share = 0.3;
+
+    double torso_share = 0.4;
+
+    double tail_share = 0.3;
+
+    // true - класс выбирается для каждого слова отдельно (запросы из частых и редких слов вперемешку),
+    // false - один класс на весь запрос
+    bool mixed = true;
+
+    uint64_t seed = 2;
+};
+
+class CorpusGenerator
+{
+public:
+    explicit CorpusGenerator(const CorpusOptions& options);
+
+    const CorpusOptions& GetOptions() const { return _options; }
+
+    // Слово словаря по рангу (0 - самое частое). Слова - псевдослова из слогов латиницы,
+    // частые слова короче редких, как в естественном языке
+    const std::string& Term(size_t rank) const { return _terms[rank]; }
+
+    // Документ с номером doc_id. Каждый документ зависит только от зерна и номера,
+    // поэтому документы можно генерировать по отдельности и в любом порядке
+    std::string Document(size_t doc_id) const;
+
+    // Все документы корпуса
+    std::vector<std::string> Documents() const;
+
+    // Запросы: слова выбираются по закону Ципфа внутри своего класса
+    std::vector<std::string> Queries(const WorkloadOptions& workload) const;
+
+private:
+    // Ранг слова по равномерному числу u из [0, 1) внутри рангов [first, last)
+    size_t SampleRank(double u, size_t first, size_t last) const;
+
+    // Длина документа по его генератору случайных чисел
+    size_t SampleLength(uint64_t& state) const;
+
+    CorpusOptions _options;
+
+    std::vector<std::string> _terms; // Слова по рангу
+
+    std::vector<double> _cdf; // Накопленные вероятности слов по рангу, _cdf[r] - сумма до r включительно
+};
+
+// Номер слова в виде псевдослова: биективная запись числа в системе из 64 слогов
+std::string MakePseudoWord(size_t number);
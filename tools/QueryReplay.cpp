@@ -0,0 +1,167 @@
+#include "QueryReplay.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <nlohmann/json.hpp>
+
+std::vector<LoggedQuery> ReadQueryLog(std::istream& in, size_t* skipped)
+{
+    std::vector<LoggedQuery> queries;
+    size_t bad_lines = 0;
+    std::string line;
+    double previous = 0;
+    while (std::getline(in, line))
+    {
+        if (line.find_first_not_of(" \t\r") == std::string::npos)
+        {
+            continue;
+        }
+        const nlohmann::json entry = nlohmann::json::parse(line, nullptr, false);
+        if (!entry.is_object() || !entry.contains("query") || !entry["query"].is_string())
+        {
+            ++bad_lines;
+            continue;
+        }
+        double time = previous;
+        for (const char* key : { "ts", "timestamp", "time" })
+        {
+            if (entry.contains(key) && entry[key].is_number())
+            {
+                time = entry[key].get<double>();
+                break;
+            }
+        }
+        previous = time;
+        queries.push_back({ time, entry["query"].get<std::string>() });
+    }
+    if (skipped)
+    {
+        *skipped = bad_lines;
+    }
+    // Журналы нескольких серверов, склеенные подряд, упорядочиваются по времени
+    std::stable_sort(queries.begin(), queries.end(),
+                     [](const LoggedQuery& a, const LoggedQuery& b) { return a.time < b.time; });
+    if (!queries.empty())
+    {
+        const double start = queries.front().time;
+        for (auto& query : queries)
+        {
+            query.time -= start;
+        }
+    }
+    return queries;
+}
+
+const char* ReplayPacingName(ReplayPacing pacing)
+{
+    switch (pacing)
+    {
+    case ReplayPacing::Original:
+        return "original";
+    case ReplayPacing::Accelerated:
+        return "accelerated";
+    case ReplayPacing::MaxThroughput:
+    default:
+        return "max";
+    }
+}
+
+// Клиенты берут запросы из общей очереди по порядку. В размеренном темпе клиент ждет момента
+// отправки запроса, задержка отсчитывается от этого момента, а не от фактической отправки
+ReplayReport ReplayQueries(const std::vector<LoggedQuery>& queries, ReplayTarget& target, const ReplayOptions& options)
+{
+    using Clock = std::chrono::steady_clock;
+    const size_t clients = std::max<size_t>(options.clients, 1);
+    const double speed = options.pacing == ReplayPacing::Original ? 1.0
+                         : options.speed > 0                       ? options.speed
+                                                                   : 1.0;
+    const bool paced = options.pacing != ReplayPacing::MaxThroughput;
+
+    // Гистограмма пишется одним потоком, поэтому у каждого клиента свои
+    struct ClientStats
+    {
+        LatencyHistogram latency;
+        LatencyHistogram service;
+        size_t queries = 0;
+        size_t errors = 0;
+        uint64_t results = 0;
+    };
+    std::vector<ClientStats> stats(clients);
+    std::atomic<size_t> next{ 0 };
+    const auto start = Clock::now();
+    const auto nanoseconds = [](Clock::duration duration)
+    {
+        return static_cast<uint64_t>(std::max<int64_t>(0, std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count()));
+    };
+
+    const auto client = [&](ClientStats& own)
+    {
+        for (size_t i = next.fetch_add(1, std::memory_order_relaxed); i < queries.size();
+             i = next.fetch_add(1, std::memory_order_relaxed))
+        {
+            Clock::time_point scheduled = Clock::now();
+            if (paced)
+            {
+                scheduled = start + std::chrono::duration_cast<Clock::duration>(
+                                        std::chrono::duration<double>(queries[i].time / speed));
+                std::this_thread::sleep_until(scheduled);
+            }
+            const auto sent = Clock::now();
+            try
+            {
+                own.results += target.Search(queries[i].query, options.limit);
+            }
+            catch (const std::exception&)
+            {
+                ++own.errors;
+            }
+            const auto done = Clock::now();
+            ++own.queries;
+            own.service.Record(nanoseconds(done - sent));
+            own.latency.Record(nanoseconds(done - (paced ? scheduled : sent)));
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(clients - 1);
+    for (size_t i = 1; i < clients; ++i)
+    {
+        threads.emplace_back(client, std::ref(stats[i]));
+    }
+    client(stats[0]);
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    ReplayReport report;
+    report.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    for (const auto& own : stats)
+    {
+        report.queries += own.queries;
+        report.errors += own.errors;
+        report.results += own.results;
+        report.latency.Add(own.latency);
+        report.service.Add(own.service);
+    }
+    report.qps = report.seconds > 0 ? static_cast<double>(report.queries) / report.seconds : 0.0;
+    return report;
+}
+
+nlohmann::ordered_json ReplayReportToJson(const ReplayReport& report)
+{
+    nlohmann::ordered_json latency = report.latency.ToJson();
+    nlohmann::ordered_json service = report.service.ToJson();
+    latency.erase("buckets");
+    service.erase("buckets");
+    return {
+        { "queries", report.queries },
+        { "errors", report.errors },
+        { "results", report.results },
+        { "seconds", report.seconds },
+        { "qps", report.qps },
+        { "latency", std::move(latency) },
+        { "service", std::move(service) }
+    };
+}
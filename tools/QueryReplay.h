@@ -0,0 +1,102 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <vector>
+#include <nlohmann/json_fwd.hpp>
+#include "QueryProfile.h"
+#include "SearchServer.h"
+
+// Воспроизведение журнала запросов для нагрузочного тестирования: запросы отправляются
+// в поисковый сервер в исходном темпе, ускоренно или с наибольшей пропускной способностью
+// несколькими одновременными клиентами, измеряются QPS и перцентили задержки
+
+// Запрос журнала
+struct LoggedQuery
+{
+    double time = 0; // Секунды от первого запроса журнала
+
+    std::string query;
+};
+
+// Читает журнал в формате JSON Lines: по объекту в строке с полями "query" (текст запроса)
+// и "ts" (или "timestamp", "time") - время в секундах, например Unix-время. Строки без запроса
+// и не JSON пропускаются, их количество записывается в skipped. Время отсчитывается от самого
+// раннего запроса; запросы без времени получают время предыдущего. Запросы упорядочиваются по времени
+std::vector<LoggedQuery> ReadQueryLog(std::istream& in, size_t* skipped = nullptr);
+
+// Темп воспроизведения
+enum class ReplayPacing
+{
+    Original,     // Запросы отправляются в моменты, записанные в журнале
+    Accelerated,  // То же, но интервалы между запросами уменьшены в speed раз
+    MaxThroughput // Каждый клиент отправляет следующий запрос сразу после ответа на предыдущий
+};
+
+struct ReplayOptions
+{
+    ReplayPacing pacing = ReplayPacing::MaxThroughput;
+
+    double speed = 1.0; // Ускорение для ReplayPacing::Accelerated
+
+    size_t clients = 1; // Количество одновременных клиентов (потоков)
+
+    size_t limit = 5; // Наибольшее количество документов в ответе
+};
+
+// Получатель запросов. Search вызывается из нескольких клиентов одновременно.
+// Реализации - поисковый сервер в том же процессе или сетевой интерфейс к нему
+class ReplayTarget
+{
+public:
+    virtual ~ReplayTarget() = default;
+
+    // Выполняет запрос и возвращает количество документов в ответе.
+    // Исключение считается ошибкой запроса
+    virtual size_t Search(const std::string& query, size_t limit) = 0;
+};
+
+// Поисковый сервер в том же процессе: запрос разбирается и выполняется как в SearchServer::search
+class SearchServerTarget : public ReplayTarget
+{
+public:
+    explicit SearchServerTarget(const SearchServer& server) : _server(server) {}
+
+    size_t Search(const std::string& query, size_t limit) override
+    {
+        return _server.search(_server.Compile(query), limit).size();
+    }
+
+private:
+    const SearchServer& _server;
+};
+
+// Результат воспроизведения
+struct ReplayReport
+{
+    size_t queries = 0; // Выполненные запросы, включая ошибки
+
+    size_t errors = 0; // Запросы, завершившиеся исключением
+
+    uint64_t results = 0; // Документы во всех ответах
+
+    double seconds = 0; // Время воспроизведения
+
+    double qps = 0; // Запросов в секунду
+
+    // Задержка от запланированного момента отправки до ответа: при отставании клиентов от
+    // журнала включает ожидание свободного клиента, поэтому перегрузка не скрывается
+    // (coordinated omission). Для MaxThroughput совпадает с service
+    LatencyHistogram latency;
+
+    LatencyHistogram service; // Время выполнения запроса получателем
+};
+
+ReplayReport ReplayQueries(const std::vector<LoggedQuery>& queries, ReplayTarget& target, const ReplayOptions& options);
+
+// {"queries", "errors", "results", "seconds", "qps", "latency": {...}, "service": {...}}
+nlohmann::ordered_json ReplayReportToJson(const ReplayReport& report);
+
+// Название темпа для отчета и параметров командной строки: "original", "accelerated", "max"
+const char* ReplayPacingName(ReplayPacing pacing);
@@ -0,0 +1,191 @@
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <nlohmann/json.hpp>
+#include "CorpusGenerator.h"
+
+namespace
+{
+    void PrintUsage(const char* program)
+    {
+        std::cerr << "Usage: " << program << " [options]\n"
+                  << "  --out <dir>             output directory (default: generated)\n"
+                  << "  --docs <n>              number of documents (default: 1000)\n"
+                  << "  --vocabulary <n>        number of distinct words (default: 50000)\n"
+                  << "  --zipf <s>              Zipf exponent (default: 1.0)\n"
+                  << "  --length <n>            mean document length in words (default: 300)\n"
+                  << "  --length-dist <name>    fixed, uniform or lognormal (default: lognormal)\n"
+                  << "  --sigma <x>             lognormal length spread (default: 0.8)\n"
+                  << "  --queries <n>           number of queries (default: 1000)\n"
+                  << "  --terms <min>-<max>     words per query (default: 1-4)\n"
+                  << "  --head <n>              head words: ranks below n (default: 100)\n"
+                  << "  --torso <n>             torso words: ranks below n (default: 10000)\n"
+                  << "  --shares <h>,<t>,<l>    head, torso and tail word shares (default: 0.3,0.4,0.3)\n"
+                  << "  --single-class          all words of a query from one class\n"
+                  << "  --max-responses <n>     max_responses written to config.json (default: 5)\n"
+                  << "  --seed <n>              random seed (default: 1)" << std::endl;
+    }
+
+    LengthDistribution ParseLengthDistribution(const std::string& name)
+    {
+        if (name == "fixed")
+        {
+            return LengthDistribution::Fixed;
+        }
+        if (name == "uniform")
+        {
+            return LengthDistribution::Uniform;
+        }
+        if (name == "lognormal")
+        {
+            return LengthDistribution::LogNormal;
+        }
+        throw std::invalid_argument("unknown length distribution: " + name);
+    }
+}
+
+// Генерирует корпус и нагрузку запросов в каталог в формате движка:
+// resources/docNNNNNN.txt, JSON/config.json и JSON/requests.json.
+// Пути к документам в config.json относительны каталогу, поэтому Search_engine
+// запускается из него
+int main(int argc, char* argv[])
+{
+    std::filesystem::path out = "generated";
+    CorpusOptions corpus;
+    WorkloadOptions workload;
+    int max_responses = 5;
+    try
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const std::string arg = argv[i];
+            if (arg == "--single-class")
+            {
+                workload.mixed = false;
+                continue;
+            }
+            if (i + 1 >= argc)
+            {
+                PrintUsage(argv[0]);
+                return 1;
+            }
+            const std::string value = argv[++i];
+            if (arg == "--out")
+            {
+                out = value;
+            }
+            else if (arg == "--docs")
+            {
+                corpus.documents = std::stoull(value);
+            }
+            else if (arg == "--vocabulary")
+            {
+                corpus.vocabulary = std::stoull(value);
+            }
+            else if (arg == "--zipf")
+            {
+                corpus.zipf_exponent = std::stod(value);
+            }
+            else if (arg == "--length")
+            {
+                corpus.mean_length = std::stoull(value);
+            }
+            else if (arg == "--length-dist")
+            {
+                corpus.length_distribution = ParseLengthDistribution(value);
+            }
+            else if (arg == "--sigma")
+            {
+                corpus.length_sigma = std::stod(value);
+            }
+            else if (arg == "--queries")
+            {
+                workload.queries = std::stoull(value);
+            }
+            else if (arg == "--head")
+            {
+                workload.head_size = std::stoull(value);
+            }
+            else if (arg == "--torso")
+            {
+                workload.torso_size = std::stoull(value);
+            }
+            else if (arg == "--max-responses")
+            {
+                max_responses = std::stoi(value);
+            }
+            else if (arg == "--seed")
+            {
+                corpus.seed = std::stoull(value);
+                workload.seed = corpus.seed + 1;
+            }
+            else if (arg == "--terms")
+            {
+                const size_t dash = value.find('-');
+                workload.min_terms = std::stoull(value.substr(0, dash));
+                workload.max_terms = dash == std::string::npos ? workload.min_terms : std::stoull(value.substr(dash + 1));
+            }
+            else if (arg == "--shares")
+            {
+                std::istringstream shares(value);
+                char comma = 0;
+                if (!(shares >> workload.head_share >> comma >> workload.torso_share >> comma >> workload.tail_share))
+                {
+                    throw std::invalid_argument("expected --shares <head>,<torso>,<tail>");
+                }
+            }
+            else
+            {
+                PrintUsage(argv[0]);
+                return 1;
+            }
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Invalid argument: " << e.what() << std::endl;
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    try
+    {
+        std::filesystem::create_directories(out / "resources");
+        std::filesystem::create_directories(out / "JSON");
+        const CorpusGenerator generator(corpus);
+
+        nlohmann::ordered_json config;
+        config["config"] = { { "name", "SyntheticCorpus" }, { "version", "0.1" }, { "max_responses", max_responses } };
+        config["files"] = nlohmann::ordered_json::array();
+        size_t words = 0;
+        size_t bytes = 0;
+        for (size_t doc_id = 0; doc_id < corpus.documents; ++doc_id)
+        {
+            // Документы пишутся по одному, чтобы большой корпус не держать в памяти
+            const std::string document = generator.Document(doc_id);
+            std::ostringstream name;
+            name << "resources/doc" << std::setw(6) << std::setfill('0') << doc_id << ".txt";
+            std::ofstream(out / name.str(), std::ios::binary) << document;
+            config["files"].push_back(name.str());
+            words += static_cast<size_t>(std::count(document.begin(), document.end(), ' ')) + 1;
+            bytes += document.size();
+        }
+        std::ofstream(out / "JSON" / "config.json") << config.dump(4);
+
+        const auto queries = generator.Queries(workload);
+        std::ofstream(out / "JSON" / "requests.json") << nlohmann::ordered_json{ { "requests", queries } }.dump(4);
+
+        std::cout << "Generated " << corpus.documents << " documents (" << words << " words, " << bytes / 1024
+                  << " KB) and " << queries.size() << " queries in " << out.string() << std::endl;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
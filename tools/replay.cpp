@@ -0,0 +1,230 @@
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include "ConverterJSON.h"
+#include "InvertedIndex.h"
+#include "QueryReplay.h"
+#include "SearchServer.h"
+
+namespace
+{
+    void PrintUsage(const char* program)
+    {
+        std::cerr << "Usage: " << program << " [options]\n"
+                  << "  --log <file>            query log, JSON Lines with \"ts\" and \"query\"\n"
+                  << "                          (default: requests from requests.json)\n"
+                  << "  --pacing <name>         original, accelerated or max (default: max)\n"
+                  << "  --speed <x>             speedup for accelerated pacing (default: 10)\n"
+                  << "  --clients <n>           concurrent clients (default: 1)\n"
+                  << "  --limit <n>             max documents per answer (default: max_responses)\n"
+                  << "  --repeat <n>            replay the log n times back to back (default: 1)\n"
+                  << "  --no-cache              disable the result cache\n"
+                  << "  --json <file>           write the report as JSON" << std::endl;
+    }
+
+    ReplayPacing ParsePacing(const std::string& name)
+    {
+        if (name == "original")
+        {
+            return ReplayPacing::Original;
+        }
+        if (name == "accelerated")
+        {
+            return ReplayPacing::Accelerated;
+        }
+        if (name == "max")
+        {
+            return ReplayPacing::MaxThroughput;
+        }
+        throw std::invalid_argument("unknown pacing: " + name);
+    }
+
+    void PrintLatency(const char* name, const LatencyHistogram& histogram)
+    {
+        const auto ms = [](uint64_t ns) { return static_cast<double>(ns) / 1e6; };
+        std::cout << std::fixed << std::setprecision(3) << "  " << std::left << std::setw(9) << name
+                  << "p50 " << ms(histogram.Percentile(0.5)) << " ms, p90 " << ms(histogram.Percentile(0.9))
+                  << " ms, p99 " << ms(histogram.Percentile(0.99)) << " ms, p99.9 " << ms(histogram.Percentile(0.999))
+                  << " ms, max " << ms(histogram.Max()) << " ms" << std::endl;
+    }
+}
+
+// Воспроизводит журнал запросов против индекса, построенного по config.json текущего каталога,
+// и выводит QPS и перцентили задержки. Запросы выполняются SearchServer в том же процессе
+int main(int argc, char* argv[])
+{
+    std::string log_path;
+    std::string json_path;
+    ReplayOptions options;
+    options.speed = 10.0;
+    long long limit = -1;
+    size_t repeat = 1;
+    bool no_cache = false;
+    try
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const std::string arg = argv[i];
+            if (arg == "--no-cache")
+            {
+                no_cache = true;
+                continue;
+            }
+            if (i + 1 >= argc)
+            {
+                PrintUsage(argv[0]);
+                return 1;
+            }
+            const std::string value = argv[++i];
+            if (arg == "--log")
+            {
+                log_path = value;
+            }
+            else if (arg == "--pacing")
+            {
+                options.pacing = ParsePacing(value);
+            }
+            else if (arg == "--speed")
+            {
+                options.speed = std::stod(value);
+            }
+            else if (arg == "--clients")
+            {
+                options.clients = std::stoull(value);
+            }
+            else if (arg == "--limit")
+            {
+                limit = std::stoll(value);
+            }
+            else if (arg == "--repeat")
+            {
+                repeat = std::stoull(value);
+            }
+            else if (arg == "--json")
+            {
+                json_path = value;
+            }
+            else
+            {
+                PrintUsage(argv[0]);
+                return 1;
+            }
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Invalid argument: " << e.what() << std::endl;
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    try
+    {
+        ConverterJSON converter;
+        if (!converter.CheckConfigFiles())
+        {
+            std::cerr << "Config files are missing or invalid. Please check config.json and requests.json" << std::endl;
+            return 1;
+        }
+
+        std::vector<LoggedQuery> queries;
+        if (log_path.empty())
+        {
+            // Без журнала запросы requests.json выполняются без пауз
+            for (auto& request : converter.GetRequests())
+            {
+                queries.push_back({ 0.0, std::move(request) });
+            }
+        }
+        else
+        {
+            std::ifstream log(log_path);
+            if (!log.is_open())
+            {
+                std::cerr << "Error: Could not open query log " << log_path << std::endl;
+                return 1;
+            }
+            size_t skipped = 0;
+            queries = ReadQueryLog(log, &skipped);
+            if (skipped > 0)
+            {
+                std::cerr << "Warning: Skipped " << skipped << " invalid lines in " << log_path << std::endl;
+            }
+        }
+        if (queries.empty())
+        {
+            std::cerr << "No queries to replay" << std::endl;
+            return 1;
+        }
+        // Повторы идут друг за другом: время каждого следующего сдвигается на длину журнала
+        if (repeat > 1)
+        {
+            const size_t size = queries.size();
+            const double span = queries.back().time;
+            const double gap = size > 1 ? span / static_cast<double>(size - 1) : 0.0;
+            for (size_t round = 1; round < repeat; ++round)
+            {
+                for (size_t i = 0; i < size; ++i)
+                {
+                    queries.push_back({ queries[i].time + static_cast<double>(round) * (span + gap), queries[i].query });
+                }
+            }
+        }
+
+        const std::vector<std::string> documents = converter.GetTextDocuments();
+        if (documents.empty())
+        {
+            std::cerr << "No documents found in config.json" << std::endl;
+            return 1;
+        }
+        InvertedIndex index;
+        index.SetOptions(converter.GetIndexOptions());
+        index.UpdateDocumentBase(documents);
+        const IndexingMetrics metrics = index.GetIndexingMetrics();
+        std::cout << "Index built: " << FormatIndexingMetrics(metrics) << std::endl;
+
+        SearchServer server(index);
+        SearchOptions search_options = converter.GetSearchOptions();
+        if (no_cache)
+        {
+            search_options.cache_capacity = 0;
+        }
+        server.SetOptions(search_options);
+        options.limit = limit >= 0 ? static_cast<size_t>(limit) : static_cast<size_t>(converter.GetResponsesLimit());
+
+        std::cout << "Replaying " << queries.size() << " queries, pacing " << ReplayPacingName(options.pacing);
+        if (options.pacing == ReplayPacing::Accelerated)
+        {
+            std::cout << " x" << options.speed;
+        }
+        std::cout << ", " << options.clients << " clients" << std::endl;
+
+        SearchServerTarget target(server);
+        const ReplayReport report = ReplayQueries(queries, target, options);
+
+        std::cout << std::fixed << std::setprecision(3) << "Queries: " << report.queries << ", errors: " << report.errors
+                  << ", " << report.seconds << " s, " << std::setprecision(1) << report.qps << " QPS" << std::endl;
+        PrintLatency("latency", report.latency);
+        PrintLatency("service", report.service);
+
+        if (!json_path.empty())
+        {
+            nlohmann::ordered_json json;
+            json["pacing"] = ReplayPacingName(options.pacing);
+            json["speed"] = options.pacing == ReplayPacing::Accelerated ? options.speed : 1.0;
+            json["clients"] = options.clients;
+            json["limit"] = options.limit;
+            json["report"] = ReplayReportToJson(report);
+            std::ofstream(json_path) << json.dump(4);
+        }
+        return report.errors == 0 ? 0 : 2;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}